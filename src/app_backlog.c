@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_backlog, LOG_LEVEL_DBG);
+
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+
+#include "app_backlog.h"
+
+#define BACKLOG_PARTITION_ID FIXED_PARTITION_ID(backlog_storage)
+
+#define BACKLOG_MAGIC	0x474c4b42 /* "BKLG" */
+#define BACKLOG_VERSION 1
+
+/* Records written to flash per call */
+#define CHUNK_RECORDS 16
+
+struct backlog_header {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t record_size;
+	uint32_t count;
+	uint32_t crc;
+};
+
+#define RECORDS_OFFSET sizeof(struct backlog_header)
+
+static const struct flash_area *fa;
+static struct app_backlog_record chunk[CHUNK_RECORDS];
+static size_t chunk_count;
+static uint32_t written;
+static uint32_t crc;
+
+static size_t capacity(void)
+{
+	return (fa->fa_size - RECORDS_OFFSET) / sizeof(struct app_backlog_record);
+}
+
+static int chunk_flush(void)
+{
+	if (chunk_count == 0) {
+		return 0;
+	}
+
+	size_t len = chunk_count * sizeof(struct app_backlog_record);
+	off_t off = RECORDS_OFFSET + written * sizeof(struct app_backlog_record);
+	int err = flash_area_write(fa, off, chunk, len);
+
+	if (err) {
+		LOG_ERR("Unable to write backlog records: %d", err);
+		return err;
+	}
+
+	crc = crc32_ieee_update(crc, (const uint8_t *)chunk, len);
+	written += chunk_count;
+	chunk_count = 0;
+
+	return 0;
+}
+
+int app_backlog_begin(void)
+{
+	int err = flash_area_open(BACKLOG_PARTITION_ID, &fa);
+
+	if (err) {
+		LOG_ERR("Unable to open backlog partition: %d", err);
+		return err;
+	}
+
+	err = flash_area_erase(fa, 0, fa->fa_size);
+	if (err) {
+		LOG_ERR("Unable to erase backlog partition: %d", err);
+		flash_area_close(fa);
+		fa = NULL;
+		return err;
+	}
+
+	chunk_count = 0;
+	written = 0;
+	crc = 0;
+
+	return 0;
+}
+
+int app_backlog_append(const struct app_backlog_record *rec)
+{
+	if (!fa) {
+		return -EBADF;
+	}
+
+	if (written + chunk_count >= capacity()) {
+		return -ENOSPC;
+	}
+
+	chunk[chunk_count++] = *rec;
+
+	return (chunk_count == CHUNK_RECORDS) ? chunk_flush() : 0;
+}
+
+int app_backlog_commit(void)
+{
+	if (!fa) {
+		return -EBADF;
+	}
+
+	int err = chunk_flush();
+
+	if (!err && written > 0) {
+		struct backlog_header hdr = {
+			.magic = BACKLOG_MAGIC,
+			.version = BACKLOG_VERSION,
+			.record_size = sizeof(struct app_backlog_record),
+			.count = written,
+			.crc = crc,
+		};
+
+		err = flash_area_write(fa, 0, &hdr, sizeof(hdr));
+	}
+
+	flash_area_close(fa);
+	fa = NULL;
+
+	if (err) {
+		LOG_ERR("Unable to commit backlog checkpoint: %d", err);
+		return err;
+	}
+
+	LOG_INF("Saved %u readings to flash", written);
+
+	return written;
+}
+
+/* Read records in chunks, either to check the CRC (cb == NULL) or to replay them */
+static int records_walk(const struct backlog_header *hdr, app_backlog_replay_cb cb,
+			uint32_t *crc_out)
+{
+	uint32_t walk_crc = 0;
+
+	for (uint32_t i = 0; i < hdr->count; i += CHUNK_RECORDS) {
+		size_t n = MIN(CHUNK_RECORDS, hdr->count - i);
+		off_t off = RECORDS_OFFSET + i * sizeof(struct app_backlog_record);
+		int err = flash_area_read(fa, off, chunk, n * sizeof(struct app_backlog_record));
+
+		if (err) {
+			return err;
+		}
+
+		if (cb) {
+			for (size_t j = 0; j < n; j++) {
+				cb(&chunk[j]);
+			}
+		} else {
+			walk_crc = crc32_ieee_update(walk_crc, (const uint8_t *)chunk,
+						     n * sizeof(struct app_backlog_record));
+		}
+	}
+
+	if (crc_out) {
+		*crc_out = walk_crc;
+	}
+
+	return 0;
+}
+
+int app_backlog_replay(app_backlog_replay_cb cb)
+{
+	struct backlog_header hdr;
+	uint32_t walk_crc;
+	int ret = 0;
+	int err = flash_area_open(BACKLOG_PARTITION_ID, &fa);
+
+	if (err) {
+		LOG_ERR("Unable to open backlog partition: %d", err);
+		return err;
+	}
+
+	err = flash_area_read(fa, 0, &hdr, sizeof(hdr));
+	if (err) {
+		LOG_ERR("Unable to read backlog header: %d", err);
+		ret = err;
+		goto close;
+	}
+
+	if (hdr.magic != BACKLOG_MAGIC) {
+		/* Nothing was checkpointed */
+		goto close;
+	}
+
+	if (hdr.version != BACKLOG_VERSION ||
+	    hdr.record_size != sizeof(struct app_backlog_record) || hdr.count > capacity()) {
+		LOG_WRN("Discarding incompatible backlog checkpoint");
+		goto clear;
+	}
+
+	/* Check the whole checkpoint before replaying any of it */
+	err = records_walk(&hdr, NULL, &walk_crc);
+	if (err || walk_crc != hdr.crc) {
+		LOG_WRN("Discarding corrupt backlog checkpoint");
+		goto clear;
+	}
+
+	err = records_walk(&hdr, cb, NULL);
+	if (err) {
+		LOG_ERR("Unable to read backlog records: %d", err);
+		ret = err;
+	} else {
+		LOG_INF("Restored %u readings from flash", hdr.count);
+		ret = hdr.count;
+	}
+
+clear:
+	/* Never replay the same checkpoint twice */
+	flash_area_erase(fa, 0, fa->fa_size);
+close:
+	flash_area_close(fa);
+	fa = NULL;
+
+	return ret;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Checkpoint of queued readings in the backlog_storage flash partition.
+ *
+ * Before a reboot, readings which could not be uploaded are written with
+ * app_backlog_begin() / app_backlog_append() / app_backlog_commit(). The header
+ * is written last, so an interrupted checkpoint is never replayed. After boot,
+ * app_backlog_replay() hands every record back once and clears the partition.
+ */
+
+#ifndef __APP_BACKLOG_H__
+#define __APP_BACKLOG_H__
+
+#include <errno.h>
+#include <stdint.h>
+
+/** Marks a weather value which was not available */
+#define APP_BACKLOG_NO_VALUE INT16_MIN
+
+/** Compact form of a queued reading (24 bytes) */
+struct app_backlog_record {
+	int32_t lat_udeg;
+	int32_t lon_udeg;
+	int64_t unix_ms;
+	int16_t tem_centi; /* degrees Celsius * 100 */
+	int16_t hum_centi; /* %RH * 100 */
+	int32_t pre_pa;	   /* Pa, or APP_BACKLOG_NO_VALUE */
+};
+
+typedef void (*app_backlog_replay_cb)(const struct app_backlog_record *rec);
+
+#ifdef CONFIG_APP_BACKLOG_CHECKPOINT
+
+/**
+ * Erase the partition and start a new checkpoint.
+ *
+ * @return 0 on success, negative errno otherwise
+ */
+int app_backlog_begin(void);
+
+/**
+ * Add a record to the checkpoint started by app_backlog_begin().
+ *
+ * @return 0 on success, -ENOSPC when the partition is full, negative errno otherwise
+ */
+int app_backlog_append(const struct app_backlog_record *rec);
+
+/**
+ * Write the header which makes the checkpoint valid.
+ *
+ * @return number of records saved, or negative errno
+ */
+int app_backlog_commit(void);
+
+/**
+ * Pass every record of a valid checkpoint to a callback, oldest first, then
+ * clear the checkpoint.
+ *
+ * @return number of records replayed, or negative errno
+ */
+int app_backlog_replay(app_backlog_replay_cb cb);
+
+#else
+
+static inline int app_backlog_begin(void)
+{
+	return -ENOTSUP;
+}
+
+static inline int app_backlog_append(const struct app_backlog_record *rec)
+{
+	return -ENOTSUP;
+}
+
+static inline int app_backlog_commit(void)
+{
+	return -ENOTSUP;
+}
+
+static inline int app_backlog_replay(app_backlog_replay_cb cb)
+{
+	return 0;
+}
+
+#endif /* CONFIG_APP_BACKLOG_CHECKPOINT */
+
+#endif /* __APP_BACKLOG_H__ */
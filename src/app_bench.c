@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <app_version.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/timing/timing.h>
+
+#include "app_bench.h"
+#include "app_ota_delta.h"
+#include "app_sensors.h"
+
+static const uint8_t trace[] = {
+#include "bench_trace.inc"
+};
+
+static const char *const stage_names[APP_BENCH_STAGE_COUNT] = {
+	[APP_BENCH_NMEA_PIPELINE] = "nmea_pipeline",
+	[APP_BENCH_RMC_PARSE] = "rmc_parse",
+	[APP_BENCH_MSGQ] = "msgq_put_get",
+	[APP_BENCH_SERIALIZE] = "serialize",
+};
+
+#ifdef CONFIG_ARCH_POSIX
+/* Host CLOCK_MONOTONIC, from app_bench_bottom.c */
+extern uint64_t app_bench_host_ns(void);
+
+uint64_t app_bench_ticks(void)
+{
+	return app_bench_host_ns();
+}
+
+uint64_t app_bench_elapsed(uint64_t start)
+{
+	return app_bench_host_ns() - start;
+}
+
+static uint64_t ticks_to_ns(uint64_t ticks)
+{
+	return ticks;
+}
+#else
+uint64_t app_bench_ticks(void)
+{
+	return timing_counter_get();
+}
+
+uint64_t app_bench_elapsed(uint64_t start)
+{
+	timing_t end = timing_counter_get();
+
+	return timing_cycles_get(&start, &end);
+}
+
+static uint64_t ticks_to_ns(uint64_t ticks)
+{
+	return timing_cycles_to_ns(ticks);
+}
+#endif /* CONFIG_ARCH_POSIX */
+
+/* Longest simulated outage for "bench thin", about ten weeks at one reading a minute */
+#define BENCH_THIN_MAX_COUNT 100000
+
+/* Parse a count argument, printing an error unless it is a number from 1 to max */
+static int count_parse(const struct shell *sh, const char *arg, const char *name,
+		       uint32_t max, uint32_t *count)
+{
+	int err = 0;
+	unsigned long val = shell_strtoul(arg, 10, &err);
+
+	if (err || val == 0 || val > max) {
+		shell_error(sh, "%s must be a number from 1 to %u", name, max);
+		return -EINVAL;
+	}
+
+	*count = val;
+
+	return 0;
+}
+
+static int cmd_bench(const struct shell *sh, size_t argc, char **argv)
+{
+	struct app_bench_result res[APP_BENCH_STAGE_COUNT];
+	uint32_t repeat = CONFIG_APP_BENCH_REPEAT;
+
+	if (argc > 1) {
+		int err = count_parse(sh, argv[1], "repeat", UINT32_MAX, &repeat);
+
+		if (err) {
+			return err;
+		}
+	}
+
+	IF_ENABLED(CONFIG_TIMING_FUNCTIONS, (timing_init(); timing_start();));
+
+	int err = app_sensors_bench(trace, sizeof(trace), repeat, res);
+
+	IF_ENABLED(CONFIG_TIMING_FUNCTIONS, (timing_stop();));
+
+	if (err) {
+		shell_error(sh, "Benchmark failed: %d", err);
+		return err;
+	}
+
+	/* One JSON object per run, so results can be collected with grep */
+	shell_fprintf(sh, SHELL_NORMAL,
+		      "{\"version\":\"%s\",\"board\":\"%s\",\"trace_bytes\":%zu,\"repeat\":%u",
+		      APP_VERSION_STRING, CONFIG_BOARD, sizeof(trace), repeat);
+
+	for (int i = 0; i < APP_BENCH_STAGE_COUNT; i++) {
+		uint32_t ops = MAX(res[i].ops, 1);
+		uint64_t ns = ticks_to_ns(res[i].ticks);
+		uint64_t ops_per_s = ns ? ((uint64_t)res[i].ops * NSEC_PER_SEC) / ns : 0;
+
+		shell_fprintf(sh, SHELL_NORMAL,
+			      ",\"%s\":{\"ops\":%u,\"ns_per_op\":%llu,\"ops_per_s\":%llu",
+			      stage_names[i], res[i].ops, (unsigned long long)(ns / ops),
+			      (unsigned long long)ops_per_s);
+
+		if (!IS_ENABLED(CONFIG_ARCH_POSIX)) {
+			shell_fprintf(sh, SHELL_NORMAL, ",\"cycles_per_op\":%llu",
+				      (unsigned long long)(res[i].ticks / ops));
+		}
+
+		if (res[i].bytes) {
+			shell_fprintf(sh, SHELL_NORMAL, ",\"bytes_per_op\":%llu",
+				      (unsigned long long)(res[i].bytes / ops));
+		}
+
+		shell_fprintf(sh, SHELL_NORMAL, "}");
+	}
+
+	shell_fprintf(sh, SHELL_NORMAL, "}\n");
+
+	return 0;
+}
+
+static int cmd_bench_backlog(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t count;
+	int err = count_parse(sh, argv[1], "count", CONFIG_APP_READING_QUEUE_DEPTH, &count);
+
+	if (err) {
+		return err;
+	}
+
+	int queued = app_sensors_bench_backlog(count);
+
+	shell_print(sh, "{\"backlog_queued\":%d}", queued);
+
+	return 0;
+}
+
+static int cmd_bench_thin(const struct shell *sh, size_t argc, char **argv)
+{
+	static const enum app_decimate_policy policies[] = {
+		APP_DECIMATE_NONE,
+		APP_DECIMATE_EVERY_OTHER,
+		APP_DECIMATE_LTTB,
+	};
+	uint32_t count;
+	struct app_bench_thin_result res;
+	int err = count_parse(sh, argv[1], "count", BENCH_THIN_MAX_COUNT, &count);
+
+	if (err) {
+		return err;
+	}
+
+	if (argc > 2) {
+		size_t i;
+
+		for (i = 0; i < ARRAY_SIZE(policies); i++) {
+			if (strcmp(argv[2], app_decimate_policy_name(policies[i])) == 0) {
+				break;
+			}
+		}
+
+		if (i == ARRAY_SIZE(policies)) {
+			shell_error(sh, "Unknown policy: %s", argv[2]);
+			return -EINVAL;
+		}
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(policies); i++) {
+		if (argc > 2 && strcmp(argv[2], app_decimate_policy_name(policies[i])) != 0) {
+			continue;
+		}
+
+		app_sensors_bench_thin(count, policies[i], &res);
+
+		shell_print(sh,
+			    "{\"thin\":{\"policy\":\"%s\",\"readings\":%u,\"kept\":%u,"
+			    "\"thinned\":%u,\"excursions\":%u,\"excursions_kept\":%u,"
+			    "\"outage_s\":%u,\"span_s\":%u,\"max_err_centi\":%u,"
+			    "\"mean_err_centi\":%u}}",
+			    app_decimate_policy_name(policies[i]), res.readings, res.kept,
+			    res.thinned, res.excursions, res.excursions_kept, res.outage_s,
+			    res.span_s, res.max_err_centi, res.mean_err_centi);
+	}
+
+	return 0;
+}
+
+#if defined(CONFIG_ARCH_POSIX) && defined(CONFIG_APP_OTA_DELTA)
+/* Host files, from app_bench_bottom.c */
+extern long app_bench_host_file_size(const char *path);
+extern long app_bench_host_file_read(const char *path, long offset, void *buf, long len);
+
+/* Patch blocks are fed as they would arrive over CoAP */
+#define DELTA_BLOCK_SIZE 1024
+
+static int delta_load_old(const char *path, long size, uint8_t *buf)
+{
+	const struct flash_area *fa;
+	int err = flash_area_open(APP_OTA_DELTA_OLD_SLOT, &fa);
+
+	if (!err && size > fa->fa_size) {
+		err = -EFBIG;
+	}
+
+	if (!err) {
+		err = flash_area_erase(fa, 0, fa->fa_size);
+	}
+
+	for (long pos = 0; !err && pos < size; pos += DELTA_BLOCK_SIZE) {
+		long n = app_bench_host_file_read(path, pos, buf, DELTA_BLOCK_SIZE);
+
+		err = (n > 0) ? flash_area_write(fa, pos, buf, n) : -EIO;
+	}
+
+	return err;
+}
+
+static int cmd_bench_delta(const struct shell *sh, size_t argc, char **argv)
+{
+	static uint8_t buf[DELTA_BLOCK_SIZE];
+	long old_size = app_bench_host_file_size(argv[1]);
+	long patch_size = app_bench_host_file_size(argv[2]);
+	uint32_t blocks = 0;
+	int err;
+
+	if (old_size <= 0 || patch_size <= 0) {
+		shell_error(sh, "Unable to read %s or %s", argv[1], argv[2]);
+		return -ENOENT;
+	}
+
+	/* The running image is whatever is in the primary slot */
+	err = delta_load_old(argv[1], old_size, buf);
+	if (err) {
+		shell_error(sh, "Unable to write the old image to the primary slot: %d", err);
+		return err;
+	}
+
+	uint64_t start = app_bench_ticks();
+
+	err = app_ota_delta_begin();
+
+	for (long pos = 0; !err && pos < patch_size; pos += DELTA_BLOCK_SIZE) {
+		long n = app_bench_host_file_read(argv[2], pos, buf, DELTA_BLOCK_SIZE);
+
+		err = (n > 0) ? app_ota_delta_write(buf, n) : -EIO;
+		blocks++;
+	}
+
+	int new_size = err ? err : app_ota_delta_finish();
+	uint64_t ns = ticks_to_ns(app_bench_elapsed(start));
+
+	shell_print(sh,
+		    "{\"delta\":{\"result\":%d,\"old_bytes\":%ld,\"patch_bytes\":%ld,"
+		    "\"new_bytes\":%d,\"blocks\":%u,\"apply_ns\":%llu}}",
+		    MIN(new_size, 0), old_size, patch_size, MAX(new_size, 0), blocks,
+		    (unsigned long long)ns);
+
+	return MIN(new_size, 0);
+}
+#endif /* CONFIG_ARCH_POSIX && CONFIG_APP_OTA_DELTA */
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_bench,
+	SHELL_CMD_ARG(backlog, NULL, "Queue synthetic readings for upload: backlog <count>",
+		      cmd_bench_backlog, 2, 0),
+	SHELL_CMD_ARG(thin, NULL,
+		      "Thin a simulated outage of one reading a minute: "
+		      "thin <count> [drop|every_other|lttb]",
+		      cmd_bench_thin, 2, 1),
+#if defined(CONFIG_ARCH_POSIX) && defined(CONFIG_APP_OTA_DELTA)
+	SHELL_CMD_ARG(delta, NULL,
+		      "Apply a patch to an old image in the flash simulator: delta <old> <patch>",
+		      cmd_bench_delta, 3, 0),
+#endif
+	SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_ARG_REGISTER(bench, &sub_bench, "Benchmark the reading pipeline: bench [repeat]",
+		       cmd_bench, 1, 1);
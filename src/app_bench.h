@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Micro-benchmarks of the reading pipeline hot paths.
+ *
+ * The `bench [repeat]` shell command runs a recorded GNSS trace
+ * (CONFIG_APP_BENCH_TRACE_FILE) through the NMEA framing and parsing, the
+ * reading queue and the batch serialization, and prints the results as one
+ * JSON line so they can be collected and compared across releases. Times are
+ * measured with the CPU cycle counter on hardware and the host monotonic clock
+ * on native_sim, whose simulated clock does not advance while code runs.
+ */
+
+#ifndef __APP_BENCH_H__
+#define __APP_BENCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum app_bench_stage {
+	APP_BENCH_NMEA_PIPELINE, /* UART framing, sentence id and RMC parse per sentence */
+	APP_BENCH_RMC_PARSE,	 /* minmea_parse_rmc() per RMC sentence */
+	APP_BENCH_MSGQ,		 /* put and get of one reading through a message queue */
+	APP_BENCH_SERIALIZE,	 /* JSON encoding per reading, in upload-sized batches */
+	APP_BENCH_STAGE_COUNT
+};
+
+struct app_bench_result {
+	uint32_t ops;
+	uint64_t ticks;
+	uint64_t bytes;
+};
+
+/* Outcome of `bench thin`, see app_sensors_bench_thin() */
+struct app_bench_thin_result {
+	uint32_t readings;	  /* readings generated */
+	uint32_t kept;		  /* readings left in the queue */
+	uint32_t thinned;	  /* readings removed by thinning */
+	uint32_t excursions;	  /* excursion readings generated */
+	uint32_t excursions_kept; /* excursion readings left in the queue */
+	uint32_t outage_s;	  /* time span of the readings generated */
+	uint32_t span_s;	  /* time span of the readings left */
+	uint32_t max_err_centi;	  /* interpolation error against the readings generated */
+	uint32_t mean_err_centi;
+};
+
+/** Current value of the benchmark clock */
+uint64_t app_bench_ticks(void);
+
+/** Benchmark clock ticks elapsed since start */
+uint64_t app_bench_elapsed(uint64_t start);
+
+#endif /* __APP_BENCH_H__ */
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host side of the native_sim benchmark clock. Built into the native
+ * simulator runner, so it is linked against the host C library.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+uint64_t app_bench_host_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Size of a host file, or -1 */
+long app_bench_host_file_size(const char *path)
+{
+	FILE *f = fopen(path, "rb");
+	long size = -1;
+
+	if (f) {
+		if (fseek(f, 0, SEEK_END) == 0) {
+			size = ftell(f);
+		}
+		fclose(f);
+	}
+
+	return size;
+}
+
+/* Read up to len bytes of a host file at offset; returns the number read, or -1 */
+long app_bench_host_file_read(const char *path, long offset, void *buf, long len)
+{
+	FILE *f = fopen(path, "rb");
+	long n = -1;
+
+	if (f) {
+		if (fseek(f, offset, SEEK_SET) == 0) {
+			n = fread(buf, 1, len, f);
+		}
+		fclose(f);
+	}
+
+	return n;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_boot, LOG_LEVEL_DBG);
+
+#include <app_version.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "app_boot.h"
+#include "app_workq.h"
+
+static const char *const phase_names[APP_BOOT_PHASE_COUNT] = {
+	[APP_BOOT_MAIN] = "main",
+	[APP_BOOT_LTE_START] = "lte_start",
+	[APP_BOOT_SENSORS_READY] = "sensors_ready",
+	[APP_BOOT_DISPLAY_READY] = "display_ready",
+	[APP_BOOT_INIT_DONE] = "init_done",
+	[APP_BOOT_NET_CONNECTED] = "net_connected",
+	[APP_BOOT_GOLIOTH_CONNECTED] = "golioth_connected",
+	[APP_BOOT_FIRST_FIX] = "first_fix",
+	[APP_BOOT_FIRST_RECORD] = "first_record",
+};
+
+/* Uptime (ms) + 1 when each phase was reached; 0 if not reached */
+static atomic_t phase_ms[APP_BOOT_PHASE_COUNT];
+
+static struct app_boot_task *boot_tasks;
+static size_t boot_task_count;
+static atomic_t tasks_done;
+static atomic_t tasks_submitted;
+static K_SEM_DEFINE(init_done_sem, 0, 1);
+
+void app_boot_mark(enum app_boot_phase phase)
+{
+	if (phase >= APP_BOOT_PHASE_COUNT) {
+		return;
+	}
+
+	uint32_t now = k_uptime_get_32();
+
+	if (atomic_cas(&phase_ms[phase], 0, now + 1)) {
+		LOG_INF("Boot phase %s reached at %u ms", phase_names[phase], now);
+	}
+}
+
+int64_t app_boot_phase_ms(enum app_boot_phase phase)
+{
+	if (phase >= APP_BOOT_PHASE_COUNT) {
+		return -1;
+	}
+
+	return (int64_t)(uint32_t)atomic_get(&phase_ms[phase]) - 1;
+}
+
+int app_boot_add_to_map(zcbor_state_t *response_detail_map)
+{
+	bool ok = zcbor_tstr_put_lit(response_detail_map, "version") &&
+		  zcbor_tstr_put_lit(response_detail_map, APP_VERSION_STRING);
+
+	for (int i = 0; i < APP_BOOT_PHASE_COUNT && ok; i++) {
+		int64_t ms = app_boot_phase_ms(i);
+
+		if (ms < 0) {
+			continue;
+		}
+
+		ok = zcbor_tstr_encode_ptr(response_detail_map, phase_names[i],
+					   strlen(phase_names[i])) &&
+		     zcbor_uint32_put(response_detail_map, (uint32_t)ms);
+	}
+
+	return ok ? 0 : -ENOMEM;
+}
+
+static void submit_ready_tasks(void)
+{
+	uint32_t done = atomic_get(&tasks_done);
+
+	for (size_t i = 0; i < boot_task_count; i++) {
+		struct app_boot_task *task = &boot_tasks[i];
+
+		if ((task->deps & done) != task->deps) {
+			continue;
+		}
+
+		/* Several completions may race to submit the same task */
+		if (atomic_test_and_set_bit(&tasks_submitted, i)) {
+			continue;
+		}
+
+		if (task->queue) {
+			k_work_submit_to_queue(task->queue, &task->work);
+		} else {
+			k_work_submit_to_queue(&app_work_q, &task->work);
+		}
+	}
+}
+
+static void boot_task_handler(struct k_work *work)
+{
+	struct app_boot_task *task = CONTAINER_OF(work, struct app_boot_task, work);
+	size_t idx = task - boot_tasks;
+	uint32_t start = k_uptime_get_32();
+
+	task->fn();
+
+	LOG_DBG("Init task %s took %u ms", task->name, k_uptime_get_32() - start);
+
+	uint32_t done = atomic_or(&tasks_done, BIT(idx)) | BIT(idx);
+
+	if (done == BIT_MASK(boot_task_count)) {
+		app_boot_mark(APP_BOOT_INIT_DONE);
+		k_sem_give(&init_done_sem);
+		return;
+	}
+
+	submit_ready_tasks();
+}
+
+int app_boot_wait(k_timeout_t timeout)
+{
+	int err = k_sem_take(&init_done_sem, timeout);
+
+	if (err == 0) {
+		/* Leave the semaphore available for later callers */
+		k_sem_give(&init_done_sem);
+	}
+
+	return err;
+}
+
+void app_boot_run(struct app_boot_task *tasks, size_t count)
+{
+	__ASSERT_NO_MSG(count < 32);
+
+	boot_tasks = tasks;
+	boot_task_count = count;
+
+	for (size_t i = 0; i < count; i++) {
+		k_work_init(&tasks[i].work, boot_task_handler);
+	}
+
+	submit_ready_tasks();
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Boot sequencing and startup latency tracking.
+ *
+ * Startup work is described as a set of init tasks with dependencies. Tasks
+ * whose dependencies are met are submitted to their work queue right away, so
+ * independent tasks (e.g. display bring-up and sensor init) run concurrently
+ * and never delay the LTE attach started from main().
+ *
+ * Boot phases are timestamped once per boot, logged, and returned by the
+ * `get_boot_times` RPC.
+ */
+
+#ifndef __APP_BOOT_H__
+#define __APP_BOOT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zcbor_encode.h>
+#include <zephyr/kernel.h>
+
+enum app_boot_phase {
+	APP_BOOT_MAIN,
+	APP_BOOT_LTE_START,
+	APP_BOOT_SENSORS_READY,
+	APP_BOOT_DISPLAY_READY,
+	APP_BOOT_INIT_DONE,
+	APP_BOOT_NET_CONNECTED,
+	APP_BOOT_GOLIOTH_CONNECTED,
+	APP_BOOT_FIRST_FIX,
+	APP_BOOT_FIRST_RECORD,
+	APP_BOOT_PHASE_COUNT
+};
+
+struct app_boot_task {
+	const char *name;
+	void (*fn)(void);
+	/* Bitmask of indexes (in the same task array) which must complete first */
+	uint32_t deps;
+	/* Work queue to run on; NULL selects the app work queue */
+	struct k_work_q *queue;
+
+	/* Private */
+	struct k_work work;
+};
+
+/**
+ * Run a set of init tasks respecting their dependencies. Returns immediately;
+ * the APP_BOOT_INIT_DONE phase is marked once every task has completed. The
+ * app work queue must already be running.
+ *
+ * @param tasks task array; must remain valid until all tasks have run
+ * @param count number of tasks (fewer than 32)
+ */
+void app_boot_run(struct app_boot_task *tasks, size_t count);
+
+/**
+ * Wait for every task passed to app_boot_run() to complete.
+ *
+ * @return 0 once init is done, -EAGAIN on timeout
+ */
+int app_boot_wait(k_timeout_t timeout);
+
+/** Record the time a boot phase was reached. Only the first call per phase is kept. */
+void app_boot_mark(enum app_boot_phase phase);
+
+/** @return uptime (ms) when the phase was reached, or -1 if it has not been reached */
+int64_t app_boot_phase_ms(enum app_boot_phase phase);
+
+/** Add the boot phase timestamps to an RPC response map */
+int app_boot_add_to_map(zcbor_state_t *response_detail_map);
+
+#endif /* __APP_BOOT_H__ */
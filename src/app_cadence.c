@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_cadence, LOG_LEVEL_DBG);
+
+#include <math.h>
+#include <zephyr/kernel.h>
+
+#include "app_cadence.h"
+#include "app_gnss.h"
+#include "app_workq.h"
+
+#define EARTH_RADIUS_M 6371000.0f
+#define DEG_TO_RAD     (3.14159265f / 180.0f)
+#define KNOTS_TO_KMH   1.852f
+
+#define CADENCE_MIN_S CONFIG_APP_GPS_CADENCE_MIN_S
+#define CADENCE_MAX_S CONFIG_APP_GPS_CADENCE_MAX_S
+
+BUILD_ASSERT(CONFIG_APP_GPS_CADENCE_MIN_S <= CONFIG_APP_GPS_CADENCE_MAX_S,
+	     "Adaptive GPS cadence minimum must not exceed the maximum");
+BUILD_ASSERT(CONFIG_APP_GPS_CADENCE_STATIONARY_SPEED_KMH < CONFIG_APP_GPS_CADENCE_FAST_SPEED_KMH,
+	     "Stationary speed threshold must be lower than the fast speed threshold");
+
+struct cadence_fix {
+	float lat;
+	float lon;
+	float course;
+};
+
+/* Last stored fix and the uptime (ms) when it was stored */
+static struct cadence_fix last_stored;
+static int64_t last_store_ms = -1;
+
+/* Position and uptime (ms) where the device came to rest; -1 while moving */
+static struct cadence_fix stationary_anchor;
+static int64_t stationary_since_ms = -1;
+
+static uint32_t current_interval_s = CADENCE_MAX_S;
+
+static void gnss_wake_work_handler(struct k_work *work)
+{
+	LOG_INF("Waking GNSS receiver to check for movement");
+	app_gnss_start();
+}
+K_WORK_DELAYABLE_DEFINE(gnss_wake_work, gnss_wake_work_handler);
+
+/* Equirectangular approximation; accurate enough over the short distances used here */
+static float distance_m(const struct cadence_fix *a, const struct cadence_fix *b)
+{
+	float x = (b->lon - a->lon) * DEG_TO_RAD * cosf((a->lat + b->lat) * 0.5f * DEG_TO_RAD);
+	float y = (b->lat - a->lat) * DEG_TO_RAD;
+
+	return sqrtf(x * x + y * y) * EARTH_RADIUS_M;
+}
+
+static float course_change_deg(float from, float to)
+{
+	float delta = fabsf(to - from);
+
+	while (delta > 360.0f) {
+		delta -= 360.0f;
+	}
+
+	return (delta > 180.0f) ? (360.0f - delta) : delta;
+}
+
+/* Linearly map speed onto the interval range: fast -> minimum, stationary -> maximum */
+static uint32_t interval_for_speed(float speed_kmh)
+{
+	const float slow = CONFIG_APP_GPS_CADENCE_STATIONARY_SPEED_KMH;
+	const float fast = CONFIG_APP_GPS_CADENCE_FAST_SPEED_KMH;
+
+	if (speed_kmh >= fast) {
+		return CADENCE_MIN_S;
+	}
+
+	if (speed_kmh <= slow) {
+		return CADENCE_MAX_S;
+	}
+
+	float ratio = (speed_kmh - slow) / (fast - slow);
+
+	return CADENCE_MAX_S - (uint32_t)((CADENCE_MAX_S - CADENCE_MIN_S) * ratio);
+}
+
+/* Track how long the device has been at rest; returns true if the receiver should sleep */
+static bool update_stationary(const struct cadence_fix *fix, float speed_kmh, int64_t now)
+{
+	bool slow = speed_kmh < CONFIG_APP_GPS_CADENCE_STATIONARY_SPEED_KMH;
+
+	if (!slow || (stationary_since_ms >= 0 &&
+		      distance_m(&stationary_anchor, fix) > CONFIG_APP_GPS_CADENCE_DISTANCE_M)) {
+		if (stationary_since_ms >= 0) {
+			LOG_INF("Movement detected");
+		}
+		stationary_since_ms = -1;
+		return false;
+	}
+
+	if (stationary_since_ms < 0) {
+		stationary_anchor = *fix;
+		stationary_since_ms = now;
+		return false;
+	}
+
+	int64_t stationary_ms = now - stationary_since_ms;
+
+	return IS_ENABLED(CONFIG_APP_GPS_CADENCE_GNSS_SLEEP) && app_gnss_is_running() &&
+	       stationary_ms >= (CONFIG_APP_GPS_CADENCE_STATIONARY_TIMEOUT_S * 1000LL);
+}
+
+bool app_cadence_should_store(const struct minmea_sentence_rmc *frame, uint32_t floor_s)
+{
+	int64_t now = k_uptime_get();
+	float speed_kmh = minmea_tofloat(&frame->speed) * KNOTS_TO_KMH;
+	struct cadence_fix fix = {
+		.lat = minmea_tocoord(&frame->latitude),
+		.lon = minmea_tocoord(&frame->longitude),
+		.course = minmea_tofloat(&frame->course),
+	};
+
+	if (isnan(speed_kmh)) {
+		/* Speed field is empty: assume at rest so the slowest cadence is used */
+		speed_kmh = 0.0f;
+	}
+
+	bool sleep = update_stationary(&fix, speed_kmh, now);
+
+	current_interval_s = MAX(interval_for_speed(speed_kmh), floor_s);
+
+	bool store = sleep || (last_store_ms < 0);
+
+	if (!store) {
+		int64_t elapsed_ms = now - last_store_ms;
+
+		if (elapsed_ms >= (current_interval_s * 1000LL)) {
+			store = true;
+		} else if (elapsed_ms >= (MAX(CADENCE_MIN_S, floor_s) * 1000LL)) {
+			/* Store early on significant displacement or a turn */
+			bool turned = !isnan(fix.course) && !isnan(last_stored.course) &&
+				      speed_kmh >= CONFIG_APP_GPS_CADENCE_STATIONARY_SPEED_KMH &&
+				      course_change_deg(last_stored.course, fix.course) >=
+					      CONFIG_APP_GPS_CADENCE_COURSE_DEG;
+
+			store = turned || (distance_m(&last_stored, &fix) >=
+					   CONFIG_APP_GPS_CADENCE_DISTANCE_M);
+		}
+	}
+
+	if (store) {
+		last_stored = fix;
+		last_store_ms = now;
+	}
+
+	if (sleep) {
+		LOG_INF("Stationary for %d s; sleeping GNSS receiver for %d s",
+			(int)((now - stationary_since_ms) / 1000), CADENCE_MAX_S);
+		app_gnss_stop();
+		/* On the app work queue, which also runs nmea_parse, so the receiver state
+		 * is only changed from one thread
+		 */
+		k_work_schedule_for_queue(&app_work_q, &gnss_wake_work, K_SECONDS(CADENCE_MAX_S));
+	}
+
+	return store;
+}
+
+uint32_t app_cadence_interval_s(void)
+{
+	return current_interval_s;
+}
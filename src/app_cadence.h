@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Motion-adaptive GPS storage cadence.
+ *
+ * Instead of storing a GPS reading every `GPS_DELAY_S`, the storage interval
+ * is varied between CONFIG_APP_GPS_CADENCE_MIN_S (at or above
+ * CONFIG_APP_GPS_CADENCE_FAST_SPEED_KMH) and CONFIG_APP_GPS_CADENCE_MAX_S
+ * (when stationary) based on the speed reported in RMC sentences. A reading is
+ * also stored early when the device has moved CONFIG_APP_GPS_CADENCE_DISTANCE_M
+ * or changed course by CONFIG_APP_GPS_CADENCE_COURSE_DEG since the last stored
+ * fix. The `GPS_DELAY_S` setting remains the lower bound of the interval.
+ */
+
+#ifndef __APP_CADENCE_H__
+#define __APP_CADENCE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lib/minmea/minmea.h"
+
+/**
+ * Decide whether a valid RMC frame should be stored.
+ *
+ * @param frame parsed RMC frame with a valid fix
+ * @param floor_s minimum number of seconds between stored readings
+ *
+ * @return true if the frame should be stored
+ */
+bool app_cadence_should_store(const struct minmea_sentence_rmc *frame, uint32_t floor_s);
+
+/** @return the storage interval (in seconds) most recently selected */
+uint32_t app_cadence_interval_s(void);
+
+#endif /* __APP_CADENCE_H__ */
@@ -0,0 +1,666 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "app_codec.h"
+
+/* "YYYY-MM-DDTHH:MM:SS.mmmZ" */
+#define TIME_LEN 24
+
+#define MICRO_PER_UNIT 1000000
+#define MS_PER_DAY     (24 * 60 * 60 * MSEC_PER_SEC)
+
+/* Bytes are counted past the end of the buffer, so overflow is checked once at the end */
+struct writer {
+	char *buf;
+	size_t size;
+	size_t len;
+};
+
+struct reader {
+	const char *p;
+	const char *end;
+};
+
+/* A JSON number: up to 6 decimals are kept, the rest are truncated */
+struct number {
+	bool neg;
+	uint64_t whole;
+	uint32_t micro;
+};
+
+static void *field_ptr(const struct app_codec_field *f, const void *obj)
+{
+	return (uint8_t *)obj + f->offset;
+}
+
+static int field_find(const struct app_codec_schema *schema, const char *name, size_t len)
+{
+	for (size_t i = 0; i < schema->count; i++) {
+		const struct app_codec_field *f = &schema->fields[i];
+
+		if (f->name_len == len && memcmp(f->name, name, len) == 0) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+/* Days since 1970-01-01 to a proleptic Gregorian date, and back */
+static void civil_from_days(int64_t z, int64_t *y, uint32_t *m, uint32_t *d)
+{
+	z += 719468;
+
+	int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+	uint32_t doe = z - era * 146097;
+	uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	uint32_t mp = (5 * doy + 2) / 153;
+
+	*d = doy - (153 * mp + 2) / 5 + 1;
+	*m = mp < 10 ? mp + 3 : mp - 9;
+	*y = yoe + era * 400 + (*m <= 2);
+}
+
+static int64_t days_from_civil(int64_t y, uint32_t m, uint32_t d)
+{
+	y -= m <= 2;
+
+	int64_t era = (y >= 0 ? y : y - 399) / 400;
+	uint32_t yoe = y - era * 400;
+	uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+	uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+	return era * 146097 + doe - 719468;
+}
+
+static void digits_put(char *p, uint32_t v, int n)
+{
+	while (n--) {
+		p[n] = '0' + v % 10;
+		v /= 10;
+	}
+}
+
+static int time_format(char out[TIME_LEN], int64_t unix_ms)
+{
+	int64_t days = unix_ms / MS_PER_DAY;
+	int64_t ms = unix_ms % MS_PER_DAY;
+	int64_t year;
+	uint32_t month, day;
+
+	if (ms < 0) {
+		days--;
+		ms += MS_PER_DAY;
+	}
+
+	civil_from_days(days, &year, &month, &day);
+
+	if (!IN_RANGE(year, 0, 9999)) {
+		return -EINVAL;
+	}
+
+	digits_put(&out[0], year, 4);
+	out[4] = '-';
+	digits_put(&out[5], month, 2);
+	out[7] = '-';
+	digits_put(&out[8], day, 2);
+	out[10] = 'T';
+	digits_put(&out[11], ms / (60 * 60 * MSEC_PER_SEC), 2);
+	out[13] = ':';
+	digits_put(&out[14], (ms / (60 * MSEC_PER_SEC)) % 60, 2);
+	out[16] = ':';
+	digits_put(&out[17], (ms / MSEC_PER_SEC) % 60, 2);
+	out[19] = '.';
+	digits_put(&out[20], ms % MSEC_PER_SEC, 3);
+	out[23] = 'Z';
+
+	return 0;
+}
+
+static bool digits_get(const char *p, int n, uint32_t *v)
+{
+	*v = 0;
+
+	for (int i = 0; i < n; i++) {
+		if (p[i] < '0' || p[i] > '9') {
+			return false;
+		}
+		*v = *v * 10 + (p[i] - '0');
+	}
+
+	return true;
+}
+
+/* ISO 8601 UTC, with or without milliseconds */
+static bool time_parse(const char *s, size_t len, int64_t *unix_ms)
+{
+	uint32_t year, month, day, hour, min, sec, ms = 0;
+
+	if ((len != TIME_LEN && len != TIME_LEN - 4) || s[4] != '-' || s[7] != '-' ||
+	    s[10] != 'T' || s[13] != ':' || s[16] != ':' || s[len - 1] != 'Z' ||
+	    !digits_get(&s[0], 4, &year) || !digits_get(&s[5], 2, &month) ||
+	    !digits_get(&s[8], 2, &day) || !digits_get(&s[11], 2, &hour) ||
+	    !digits_get(&s[14], 2, &min) || !digits_get(&s[17], 2, &sec)) {
+		return false;
+	}
+
+	if (len == TIME_LEN && (s[19] != '.' || !digits_get(&s[20], 3, &ms))) {
+		return false;
+	}
+
+	if (!IN_RANGE(month, 1, 12) || !IN_RANGE(day, 1, 31) || hour > 23 || min > 59 ||
+	    sec > 60) {
+		return false;
+	}
+
+	*unix_ms = days_from_civil(year, month, day) * MS_PER_DAY +
+		   ((hour * 60 + min) * 60 + sec) * (int64_t)MSEC_PER_SEC + ms;
+
+	return true;
+}
+
+static void char_put(struct writer *w, char c)
+{
+	if (w->len < w->size) {
+		w->buf[w->len] = c;
+	}
+	w->len++;
+}
+
+static void str_put(struct writer *w, const char *s, size_t len)
+{
+	if (w->len + len <= w->size) {
+		memcpy(&w->buf[w->len], s, len);
+	}
+	w->len += len;
+}
+
+static void uint_put(struct writer *w, uint64_t v, int min_digits)
+{
+	char digits[20];
+	int n = 0;
+
+	do {
+		digits[n++] = '0' + v % 10;
+		v /= 10;
+	} while (v || n < min_digits);
+
+	while (n) {
+		char_put(w, digits[--n]);
+	}
+}
+
+static void int_put(struct writer *w, int64_t v)
+{
+	if (v < 0) {
+		char_put(w, '-');
+	}
+
+	uint_put(w, v < 0 ? -(uint64_t)v : v, 1);
+}
+
+static int json_value_put(struct writer *w, const struct app_codec_field *f, const void *obj)
+{
+	const void *v = field_ptr(f, obj);
+
+	switch (f->kind) {
+	case APP_CODEC_INT:
+		int_put(w, *(const int32_t *)v);
+		return 0;
+	case APP_CODEC_UINT:
+		uint_put(w, *(const uint32_t *)v, 1);
+		return 0;
+	case APP_CODEC_I64:
+		int_put(w, *(const int64_t *)v);
+		return 0;
+	case APP_CODEC_MICRO: {
+		int64_t micro = *(const int64_t *)v;
+		uint64_t mag = micro < 0 ? -(uint64_t)micro : micro;
+
+		if (micro < 0) {
+			char_put(w, '-');
+		}
+		uint_put(w, mag / MICRO_PER_UNIT, 1);
+		char_put(w, '.');
+		uint_put(w, mag % MICRO_PER_UNIT, 6);
+		return 0;
+	}
+	case APP_CODEC_TIME: {
+		char iso[TIME_LEN];
+		int err = time_format(iso, *(const int64_t *)v);
+
+		if (err) {
+			return err;
+		}
+		char_put(w, '"');
+		str_put(w, iso, sizeof(iso));
+		char_put(w, '"');
+		return 0;
+	}
+	default:
+		return -EINVAL;
+	}
+}
+
+int app_codec_json_encode(const struct app_codec_schema *schema, const void *obj, uint32_t mask,
+			  char *buf, size_t size)
+{
+	struct writer w = {.buf = buf, .size = size};
+	bool first = true;
+
+	char_put(&w, '{');
+
+	for (size_t i = 0; i < schema->count; i++) {
+		const struct app_codec_field *f = &schema->fields[i];
+
+		if (!(mask & BIT(i))) {
+			continue;
+		}
+
+		if (!first) {
+			char_put(&w, ',');
+		}
+		first = false;
+
+		char_put(&w, '"');
+		str_put(&w, f->name, f->name_len);
+		char_put(&w, '"');
+		char_put(&w, ':');
+
+		int err = json_value_put(&w, f, obj);
+
+		if (err) {
+			return err;
+		}
+	}
+
+	char_put(&w, '}');
+
+	if (w.len >= size) {
+		return -ENOMEM;
+	}
+
+	buf[w.len] = '\0';
+
+	return w.len;
+}
+
+static void ws_skip(struct reader *r)
+{
+	while (r->p < r->end && (*r->p == ' ' || *r->p == '\t' || *r->p == '\n' || *r->p == '\r')) {
+		r->p++;
+	}
+}
+
+static bool char_expect(struct reader *r, char c)
+{
+	ws_skip(r);
+
+	if (r->p < r->end && *r->p == c) {
+		r->p++;
+		return true;
+	}
+
+	return false;
+}
+
+/* The contents of a string, escapes left as they are */
+static bool string_get(struct reader *r, const char **s, size_t *len)
+{
+	if (!char_expect(r, '"')) {
+		return false;
+	}
+
+	*s = r->p;
+
+	for (; r->p < r->end; r->p++) {
+		if (*r->p == '\\') {
+			/* An escape cut off by the end of the payload leaves the string open */
+			if (++r->p == r->end) {
+				return false;
+			}
+		} else if (*r->p == '"') {
+			*len = r->p++ - *s;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool number_get(struct reader *r, struct number *n)
+{
+	const char *start;
+
+	ws_skip(r);
+	*n = (struct number){0};
+
+	if (r->p < r->end && *r->p == '-') {
+		n->neg = true;
+		r->p++;
+	}
+
+	for (start = r->p; r->p < r->end && *r->p >= '0' && *r->p <= '9'; r->p++) {
+		uint32_t digit = *r->p - '0';
+
+		if (n->whole > (UINT64_MAX - digit) / 10) {
+			return false;
+		}
+		n->whole = n->whole * 10 + digit;
+	}
+
+	if (r->p == start) {
+		return false;
+	}
+
+	if (r->p < r->end && *r->p == '.') {
+		uint32_t scale = MICRO_PER_UNIT;
+
+		for (start = ++r->p; r->p < r->end && *r->p >= '0' && *r->p <= '9'; r->p++) {
+			scale /= 10;
+			n->micro += (*r->p - '0') * scale;
+		}
+
+		if (r->p == start) {
+			return false;
+		}
+	}
+
+	/* Exponents are not produced by the cloud for these payloads */
+	return r->p == r->end || (*r->p != 'e' && *r->p != 'E');
+}
+
+/* Skip a value of any type, up to the separator after it */
+static bool value_skip(struct reader *r)
+{
+	int depth = 0;
+
+	while (r->p < r->end) {
+		const char *s;
+		size_t len;
+
+		switch (*r->p) {
+		case '"':
+			if (!string_get(r, &s, &len)) {
+				return false;
+			}
+			continue;
+		case '{':
+		case '[':
+			depth++;
+			break;
+		case '}':
+		case ']':
+			if (depth == 0) {
+				return true;
+			}
+			depth--;
+			break;
+		case ',':
+			if (depth == 0) {
+				return true;
+			}
+			break;
+		}
+
+		r->p++;
+	}
+
+	return false;
+}
+
+static bool number_store(const struct number *n, const struct app_codec_field *f, void *obj)
+{
+	void *v = field_ptr(f, obj);
+
+	switch (f->kind) {
+	case APP_CODEC_INT:
+		if (n->whole > (n->neg ? (uint64_t)INT32_MAX + 1 : INT32_MAX)) {
+			return false;
+		}
+		*(int32_t *)v = n->neg ? -(int64_t)n->whole : (int64_t)n->whole;
+		return true;
+	case APP_CODEC_UINT:
+		if ((n->neg && n->whole) || n->whole > UINT32_MAX) {
+			return false;
+		}
+		*(uint32_t *)v = n->whole;
+		return true;
+	case APP_CODEC_I64:
+		if (n->whole > (n->neg ? (uint64_t)INT64_MAX + 1 : INT64_MAX)) {
+			return false;
+		}
+		*(int64_t *)v = n->neg ? (int64_t)(0 - n->whole) : (int64_t)n->whole;
+		return true;
+	case APP_CODEC_MICRO: {
+		if (n->whole > INT64_MAX / MICRO_PER_UNIT - 1) {
+			return false;
+		}
+		int64_t micro = n->whole * MICRO_PER_UNIT + n->micro;
+
+		*(int64_t *)v = n->neg ? -micro : micro;
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+static bool json_value_get(struct reader *r, const struct app_codec_field *f, void *obj)
+{
+	if (f->kind == APP_CODEC_TIME) {
+		const char *s;
+		size_t len;
+
+		return string_get(r, &s, &len) && time_parse(s, len, field_ptr(f, obj));
+	}
+
+	struct number n;
+
+	return number_get(r, &n) && number_store(&n, f, obj);
+}
+
+int app_codec_json_decode(const struct app_codec_schema *schema, const char *payload, size_t len,
+			  void *obj)
+{
+	struct reader r = {.p = payload, .end = payload + len};
+	uint32_t mask = 0;
+
+	if (!char_expect(&r, '{')) {
+		return -EBADMSG;
+	}
+
+	if (char_expect(&r, '}')) {
+		return 0;
+	}
+
+	do {
+		const char *key;
+		size_t key_len;
+
+		if (!string_get(&r, &key, &key_len) || !char_expect(&r, ':')) {
+			return -EBADMSG;
+		}
+
+		int i = field_find(schema, key, key_len);
+
+		if (i < 0) {
+			if (!value_skip(&r)) {
+				return -EBADMSG;
+			}
+			continue;
+		}
+
+		if (!json_value_get(&r, &schema->fields[i], obj)) {
+			return -EBADMSG;
+		}
+
+		mask |= BIT(i);
+	} while (char_expect(&r, ','));
+
+	return char_expect(&r, '}') ? mask : -EBADMSG;
+}
+
+static bool cbor_value_put(zcbor_state_t *zse, const struct app_codec_field *f, const void *obj)
+{
+	const void *v = field_ptr(f, obj);
+
+	switch (f->kind) {
+	case APP_CODEC_INT:
+		return zcbor_int32_put(zse, *(const int32_t *)v);
+	case APP_CODEC_UINT:
+		return zcbor_uint32_put(zse, *(const uint32_t *)v);
+	case APP_CODEC_I64:
+		return zcbor_int64_put(zse, *(const int64_t *)v);
+	case APP_CODEC_MICRO:
+		return zcbor_float64_put(zse, *(const int64_t *)v / (double)MICRO_PER_UNIT);
+	case APP_CODEC_TIME: {
+		char iso[TIME_LEN];
+
+		return time_format(iso, *(const int64_t *)v) == 0 &&
+		       zcbor_tstr_encode_ptr(zse, iso, sizeof(iso));
+	}
+	default:
+		return false;
+	}
+}
+
+int app_codec_cbor_map_put(const struct app_codec_schema *schema, const void *obj, uint32_t mask,
+			   zcbor_state_t *zse)
+{
+	for (size_t i = 0; i < schema->count; i++) {
+		const struct app_codec_field *f = &schema->fields[i];
+
+		if (!(mask & BIT(i))) {
+			continue;
+		}
+
+		if (!zcbor_tstr_encode_ptr(zse, f->name, f->name_len) ||
+		    !cbor_value_put(zse, f, obj)) {
+			return -ENOMEM;
+		}
+	}
+
+	return 0;
+}
+
+int app_codec_cbor_encode(const struct app_codec_schema *schema, const void *obj, uint32_t mask,
+			  uint8_t *buf, size_t size)
+{
+	ZCBOR_STATE_E(zse, 1, buf, size, 1);
+
+	if (!zcbor_map_start_encode(zse, schema->count) ||
+	    app_codec_cbor_map_put(schema, obj, mask, zse) ||
+	    !zcbor_map_end_encode(zse, schema->count)) {
+		return -ENOMEM;
+	}
+
+	return zse->payload - buf;
+}
+
+/* Integers and floats are both accepted for numbers */
+static bool cbor_value_get(zcbor_state_t *zsd, const struct app_codec_field *f, void *obj)
+{
+	struct number n = {0};
+	int64_t i64;
+	double d;
+
+	if (f->kind == APP_CODEC_TIME) {
+		struct zcbor_string s;
+
+		return zcbor_tstr_decode(zsd, &s) &&
+		       time_parse((const char *)s.value, s.len, field_ptr(f, obj));
+	}
+
+	if (zcbor_int64_decode(zsd, &i64)) {
+		n.neg = i64 < 0;
+		n.whole = n.neg ? -(uint64_t)i64 : i64;
+	} else if (zcbor_float_decode(zsd, &d)) {
+		/* Truncated towards zero, as the console sends integers as floats */
+		n.neg = d < 0;
+		d = n.neg ? -d : d;
+		if (d >= (double)UINT64_MAX) {
+			return false;
+		}
+		n.whole = (uint64_t)d;
+		n.micro = (uint32_t)((d - n.whole) * MICRO_PER_UNIT + 0.5);
+		if (n.micro >= MICRO_PER_UNIT) {
+			n.whole++;
+			n.micro = 0;
+		}
+	} else {
+		return false;
+	}
+
+	return number_store(&n, f, obj);
+}
+
+int app_codec_cbor_decode(const struct app_codec_schema *schema, const uint8_t *payload,
+			  size_t len, void *obj)
+{
+	ZCBOR_STATE_D(zsd, 2, payload, len, 1, 0);
+	uint32_t mask = 0;
+
+	if (!zcbor_map_start_decode(zsd)) {
+		return -EBADMSG;
+	}
+
+	while (!zcbor_array_at_end(zsd)) {
+		struct zcbor_string key;
+
+		if (!zcbor_tstr_decode(zsd, &key)) {
+			return -EBADMSG;
+		}
+
+		int i = field_find(schema, (const char *)key.value, key.len);
+
+		if (i < 0) {
+			if (!zcbor_any_skip(zsd, NULL)) {
+				return -EBADMSG;
+			}
+			continue;
+		}
+
+		if (!cbor_value_get(zsd, &schema->fields[i], obj)) {
+			return -EBADMSG;
+		}
+
+		mask |= BIT(i);
+	}
+
+	return zcbor_map_end_decode(zsd) ? mask : -EBADMSG;
+}
+
+int app_codec_cbor_list_decode(const struct app_codec_schema *schema, zcbor_state_t *zsd,
+			       void *obj)
+{
+	uint32_t mask = 0;
+
+	for (size_t i = 0; i < schema->count; i++) {
+		const struct app_codec_field *f = &schema->fields[i];
+
+		if (zcbor_array_at_end(zsd)) {
+			if (!(f->flags & APP_CODEC_OPTIONAL)) {
+				return -EINVAL;
+			}
+			continue;
+		}
+
+		if (!cbor_value_get(zsd, f, obj)) {
+			return -EINVAL;
+		}
+
+		mask |= BIT(i);
+	}
+
+	return mask;
+}
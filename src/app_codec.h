@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Payload codecs generated from schemas.
+ *
+ * A schema is an X-macro listing the fields of one payload as
+ * X(T, name, kind, flags, ...), where T is the struct holding the payload and
+ * anything after flags is left to the module using the schema. From it the
+ * preprocessor generates the struct, a field table and the exact maximum
+ * encoded sizes, so buffers are sized at compile time. One table-driven
+ * encoder and decoder per format writes straight into the transport buffer or
+ * reads straight from the received payload, with no intermediate copy, token
+ * array or format string. The schemas themselves are in app_payloads.h.
+ *
+ * Field kinds and their C types:
+ *
+ *  - INT: int32_t
+ *  - UINT: uint32_t
+ *  - I64: int64_t
+ *  - MICRO: int64_t millionths, a decimal number in JSON and a float in CBOR
+ *  - TIME: int64_t Unix time (ms), an ISO 8601 UTC string in both formats
+ *
+ * Objects are JSON objects or CBOR maps keyed by field name. Fields are
+ * selected by a mask of BIT(field index); decoders return the mask of the
+ * fields found.
+ */
+
+#ifndef __APP_CODEC_H__
+#define __APP_CODEC_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zcbor_decode.h>
+#include <zcbor_encode.h>
+#include <zephyr/sys/util.h>
+
+enum app_codec_kind {
+	APP_CODEC_INT,
+	APP_CODEC_UINT,
+	APP_CODEC_I64,
+	APP_CODEC_MICRO,
+	APP_CODEC_TIME,
+};
+
+/* May be left out of a positional list (RPC parameters) */
+#define APP_CODEC_OPTIONAL BIT(0)
+
+/* Every field of a schema */
+#define APP_CODEC_ALL UINT32_MAX
+
+#define APP_CODEC_CTYPE_INT   int32_t
+#define APP_CODEC_CTYPE_UINT  uint32_t
+#define APP_CODEC_CTYPE_I64   int64_t
+#define APP_CODEC_CTYPE_MICRO int64_t
+#define APP_CODEC_CTYPE_TIME  int64_t
+
+/* Longest value: "-2147483648", "4294967295", "-9223372036854775808",
+ * "-9223372036854.775808" and "\"2026-01-01T00:00:00.000Z\""
+ */
+#define APP_CODEC_JSON_MAX_INT	 11
+#define APP_CODEC_JSON_MAX_UINT	 10
+#define APP_CODEC_JSON_MAX_I64	 20
+#define APP_CODEC_JSON_MAX_MICRO 21
+#define APP_CODEC_JSON_MAX_TIME	 26
+
+/* Longest value: integers with a 4 or 8 byte argument, a float64 and a
+ * 24 character text string, which takes a 2 byte header
+ */
+#define APP_CODEC_CBOR_MAX_INT	 5
+#define APP_CODEC_CBOR_MAX_UINT	 5
+#define APP_CODEC_CBOR_MAX_I64	 9
+#define APP_CODEC_CBOR_MAX_MICRO 9
+#define APP_CODEC_CBOR_MAX_TIME	 26
+
+struct app_codec_field {
+	const char *name;
+	uint8_t name_len;
+	uint8_t kind;
+	uint8_t flags;
+	uint16_t offset;
+};
+
+struct app_codec_schema {
+	const struct app_codec_field *fields;
+	size_t count;
+};
+
+/* Struct member for a field */
+#define APP_CODEC_MEMBER(T, name, kind, ...) APP_CODEC_CTYPE_##kind name;
+
+/* Field index, for masks */
+#define APP_CODEC_INDEX(T, name, kind, ...) T##_##name,
+
+#define APP_CODEC_FIELD(T, _name, _kind, _flags, ...)                                              \
+	{                                                                                          \
+		.name = #_name,                                                                    \
+		.name_len = sizeof(#_name) - 1,                                                    \
+		.kind = APP_CODEC_##_kind,                                                         \
+		.flags = _flags,                                                                   \
+		.offset = offsetof(T, _name),                                                      \
+	},
+
+/* "name":value, */
+#define APP_CODEC_JSON_FIELD_MAX(T, name, kind, ...)                                               \
+	+(sizeof(#name) + 3 + APP_CODEC_JSON_MAX_##kind)
+/* Text string key, of at most 23 characters, and value */
+#define APP_CODEC_CBOR_FIELD_MAX(T, name, kind, ...) +(sizeof(#name) + APP_CODEC_CBOR_MAX_##kind)
+#define APP_CODEC_COUNT(T, name, kind, ...)	     +1
+#define APP_CODEC_NAME_CHECK(T, name, kind, ...)                                                   \
+	BUILD_ASSERT(sizeof(#name) <= 24, "Field names take a one byte CBOR header");
+
+/** Longest JSON object of a schema, without the terminating NUL */
+#define APP_CODEC_JSON_MAX(list) (1 list(APP_CODEC_JSON_FIELD_MAX, _))
+
+/* zcbor writes an indefinite length header and a break byte unless ZCBOR_CANONICAL is set */
+#define APP_CODEC_CBOR_MAP_OVERHEAD 2
+
+/** Longest CBOR map of a schema */
+#define APP_CODEC_CBOR_MAX(list)                                                                   \
+	(APP_CODEC_CBOR_MAP_OVERHEAD list(APP_CODEC_CBOR_FIELD_MAX, _))
+
+/** Longest CBOR map entries of a schema, added to a map already started */
+#define APP_CODEC_CBOR_ENTRIES_MAX(list) (0 list(APP_CODEC_CBOR_FIELD_MAX, _))
+
+/** Fields of a schema */
+#define APP_CODEC_FIELD_COUNT(list) (0 list(APP_CODEC_COUNT, _))
+
+/**
+ * Define the field table of a schema as `const struct app_codec_schema
+ * <type>_schema`, for the struct <type> generated from it.
+ */
+#define APP_CODEC_SCHEMA_DEFINE(type, list)                                                        \
+	BUILD_ASSERT(APP_CODEC_FIELD_COUNT(list) <= 23,                                            \
+		     "A schema takes at most 23 fields, for a one byte CBOR map header");          \
+	list(APP_CODEC_NAME_CHECK, _)                                                              \
+	static const struct app_codec_field type##_fields[] = {                                    \
+		list(APP_CODEC_FIELD, struct type)                                                 \
+	};                                                                                         \
+	const struct app_codec_schema type##_schema = {                                            \
+		.fields = type##_fields,                                                           \
+		.count = ARRAY_SIZE(type##_fields),                                                \
+	}
+
+/**
+ * Encode the fields in mask as a JSON object, NUL terminated.
+ *
+ * @return the length without the NUL, -ENOMEM if buf is too small or -EINVAL
+ *	   if a time is outside the years 0 to 9999
+ */
+int app_codec_json_encode(const struct app_codec_schema *schema, const void *obj, uint32_t mask,
+			  char *buf, size_t size);
+
+/**
+ * Decode a flat JSON object; keys which are not in the schema are skipped.
+ *
+ * @return the mask of the fields decoded, or -EBADMSG if the payload is not
+ *	   a JSON object or a field has the wrong type
+ */
+int app_codec_json_decode(const struct app_codec_schema *schema, const char *payload, size_t len,
+			  void *obj);
+
+/**
+ * Encode the fields in mask as a CBOR map.
+ *
+ * @return the length, or -ENOMEM if buf is too small or a time is outside the
+ *	   years 0 to 9999
+ */
+int app_codec_cbor_encode(const struct app_codec_schema *schema, const void *obj, uint32_t mask,
+			  uint8_t *buf, size_t size);
+
+/**
+ * Add the fields in mask to a CBOR map already started, such as an RPC
+ * response.
+ *
+ * @return 0 on success, -ENOMEM if the map is full or a time is outside the
+ *	   years 0 to 9999
+ */
+int app_codec_cbor_map_put(const struct app_codec_schema *schema, const void *obj, uint32_t mask,
+			   zcbor_state_t *zse);
+
+/**
+ * Decode a CBOR map; keys which are not in the schema are skipped.
+ *
+ * @return the mask of the fields decoded, or -EBADMSG if the payload is not
+ *	   a CBOR map or a field has the wrong type
+ */
+int app_codec_cbor_decode(const struct app_codec_schema *schema, const uint8_t *payload,
+			  size_t len, void *obj);
+
+/**
+ * Decode the fields in order from a CBOR list already started, such as RPC
+ * parameters. Numbers may be integers or floats.
+ *
+ * @return the mask of the fields decoded, or -EINVAL if a field without
+ *	   APP_CODEC_OPTIONAL is missing or has the wrong type
+ */
+int app_codec_cbor_list_decode(const struct app_codec_schema *schema, zcbor_state_t *zsd,
+			       void *obj);
+
+#endif /* __APP_CODEC_H__ */
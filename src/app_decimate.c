@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+
+#include "app_decimate.h"
+
+static size_t keep_point(atomic_t *keep, size_t i)
+{
+	return atomic_test_and_set_bit(keep, i) ? 0 : 1;
+}
+
+static int every_other(size_t n, atomic_t *keep)
+{
+	size_t kept = 0;
+
+	for (size_t i = 0; i < n; i += 2) {
+		kept += keep_point(keep, i);
+	}
+
+	return kept + keep_point(keep, n - 1);
+}
+
+/*
+ * Split the points between the first and the last into buckets and keep, in
+ * each bucket, the point which makes the largest triangle with the point kept
+ * in the previous bucket and the average of the next bucket. Times are taken
+ * relative to the first point, in seconds, so the areas fit in 64 bits.
+ */
+static int lttb(size_t n, size_t target, app_decimate_get_cb get, void *user_data,
+		atomic_t *keep)
+{
+	struct app_decimate_point first, pt;
+	size_t buckets = target - 2;
+	size_t kept;
+	int64_t ax = 0, ay;
+	int err;
+
+	err = get(0, &first, user_data);
+	if (err) {
+		return err;
+	}
+
+	ay = first.value;
+	kept = keep_point(keep, 0) + keep_point(keep, n - 1);
+
+	for (size_t b = 0; b < buckets; b++) {
+		size_t start = 1 + (b * (n - 2)) / buckets;
+		size_t end = 1 + ((b + 1) * (n - 2)) / buckets;
+		size_t next_end = (b + 1 < buckets) ? 1 + ((b + 2) * (n - 2)) / buckets : n;
+		int64_t cx = 0, cy = 0;
+
+		for (size_t i = end; i < next_end; i++) {
+			err = get(i, &pt, user_data);
+			if (err) {
+				return err;
+			}
+			cx += (pt.t_ms - first.t_ms) / 1000;
+			cy += pt.value;
+		}
+		cx /= (int64_t)(next_end - end);
+		cy /= (int64_t)(next_end - end);
+
+		int64_t best_area = -1;
+		int64_t bx = 0, by = 0;
+		size_t best = start;
+
+		for (size_t i = start; i < end; i++) {
+			err = get(i, &pt, user_data);
+			if (err) {
+				return err;
+			}
+
+			int64_t x = (pt.t_ms - first.t_ms) / 1000;
+			int64_t area = llabs((ax - cx) * (pt.value - ay) - (ax - x) * (cy - ay));
+
+			if (area > best_area) {
+				best_area = area;
+				best = i;
+				bx = x;
+				by = pt.value;
+			}
+		}
+
+		kept += keep_point(keep, best);
+		ax = bx;
+		ay = by;
+	}
+
+	return kept;
+}
+
+int app_decimate(enum app_decimate_policy policy, size_t n, size_t target,
+		 app_decimate_get_cb get, void *user_data, atomic_t *keep)
+{
+	struct app_decimate_point pt;
+	int kept;
+
+	for (size_t i = 0; i < n; i++) {
+		atomic_clear_bit(keep, i);
+	}
+
+	if (policy == APP_DECIMATE_NONE || n <= 2 || (policy == APP_DECIMATE_LTTB && target >= n)) {
+		for (size_t i = 0; i < n; i++) {
+			atomic_set_bit(keep, i);
+		}
+		return n;
+	}
+
+	if (policy == APP_DECIMATE_LTTB) {
+		kept = lttb(n, MAX(target, 2), get, user_data, keep);
+	} else {
+		kept = every_other(n, keep);
+	}
+
+	if (kept < 0) {
+		return kept;
+	}
+
+	/* Keep the neighbours of pinned points too, so their duration is known */
+	for (size_t i = 0; i < n; i++) {
+		int err = get(i, &pt, user_data);
+
+		if (err) {
+			return err;
+		}
+
+		if (pt.pinned) {
+			kept += keep_point(keep, i);
+			kept += (i > 0) ? keep_point(keep, i - 1) : 0;
+			kept += (i + 1 < n) ? keep_point(keep, i + 1) : 0;
+		}
+	}
+
+	return kept;
+}
+
+int app_decimate_msgq(struct k_msgq *q, size_t segment, enum app_decimate_policy policy,
+		      app_decimate_get_cb get, atomic_t *keep, void *buf)
+{
+	uint32_t used = k_msgq_num_used_get(q);
+
+	segment = MIN(segment, used);
+
+	int kept = app_decimate(policy, segment, segment / 2, get, q, keep);
+
+	if (kept < 0 || (size_t)kept >= segment) {
+		return MIN(kept, 0);
+	}
+
+	/* Cycle the whole queue once so the messages kept stay in order */
+	for (uint32_t i = 0; i < used; i++) {
+		k_msgq_get(q, buf, K_NO_WAIT);
+
+		if (i >= segment || atomic_test_bit(keep, i)) {
+			k_msgq_put(q, buf, K_NO_WAIT);
+		}
+	}
+
+	return segment - kept;
+}
+
+const char *app_decimate_policy_name(enum app_decimate_policy policy)
+{
+	switch (policy) {
+	case APP_DECIMATE_EVERY_OTHER:
+		return "every_other";
+	case APP_DECIMATE_LTTB:
+		return "lttb";
+	default:
+		return "drop";
+	}
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Thinning of a series of readings.
+ *
+ * When the reading queue fills up during a long outage, its oldest half is
+ * thinned instead of dropping new readings, so the queue covers the whole
+ * outage at a lower resolution. Each time the queue fills again the oldest
+ * half is thinned again, so the oldest readings end up the most sparse.
+ * Pinned points (temperature excursions) are always kept.
+ *
+ * Points are read through a callback, so the series can stay in the queue
+ * it lives in; the selection is returned as a bitmap, or applied to a message
+ * queue in place.
+ */
+
+#ifndef __APP_DECIMATE_H__
+#define __APP_DECIMATE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+enum app_decimate_policy {
+	APP_DECIMATE_NONE,	  /* keep everything; new readings are dropped */
+	APP_DECIMATE_EVERY_OTHER, /* keep every other point */
+	APP_DECIMATE_LTTB,	  /* Largest-Triangle-Three-Buckets, keeps the shape */
+};
+
+struct app_decimate_point {
+	int64_t t_ms;
+	int32_t value;
+	bool pinned; /* never thinned */
+};
+
+/**
+ * Read point i of the series.
+ *
+ * @return 0 on success, negative errno otherwise
+ */
+typedef int (*app_decimate_get_cb)(size_t i, struct app_decimate_point *pt, void *user_data);
+
+/**
+ * Select the points of a series to keep.
+ *
+ * The first and last points, the pinned points and their neighbours are always
+ * kept. LTTB keeps about target points besides these; every other point keeps
+ * half of them whatever the target.
+ *
+ * @param keep bitmap of at least n bits, set for each point kept
+ *
+ * @return number of points kept, or negative errno from the callback
+ */
+int app_decimate(enum app_decimate_policy policy, size_t n, size_t target,
+		 app_decimate_get_cb get, void *user_data, atomic_t *keep);
+
+/**
+ * Thin the oldest segment messages of a queue to about half, in place. The
+ * messages kept stay in order, ahead of the rest of the queue. Nothing else may
+ * take from or add to the queue meanwhile.
+ *
+ * @param get reads point i of the queue; called with the queue as user_data
+ * @param keep bitmap of at least segment bits
+ * @param buf scratch space for one message
+ *
+ * @return number of messages removed, or negative errno from the callback
+ */
+int app_decimate_msgq(struct k_msgq *q, size_t segment, enum app_decimate_policy policy,
+		      app_decimate_get_cb get, atomic_t *keep, void *buf);
+
+/** Policy name, as given to the `bench thin` shell command */
+const char *app_decimate_policy_name(enum app_decimate_policy policy);
+
+#endif /* __APP_DECIMATE_H__ */
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_display, LOG_LEVEL_DBG);
+
+#include <libostentus.h>
+#include <zephyr/kernel.h>
+
+#include "app_display.h"
+#include "app_metrics.h"
+#include "app_workq.h"
+
+static const struct device *o_dev = DEVICE_DT_GET_ANY(golioth_ostentus);
+
+#define TEXT_LEN CONFIG_APP_DISPLAY_TEXT_LEN
+
+struct slide_text {
+	char pending[TEXT_LEN]; /* latest value published by producers */
+	char shown[TEXT_LEN];	/* value last written to the faceplate */
+};
+
+static struct slide_text slides[SLIDE_KEY_COUNT];
+static struct k_spinlock slides_lock;
+static ATOMIC_DEFINE(dirty, SLIDE_KEY_COUNT);
+
+/* LED states requested, and those not yet written */
+static ATOMIC_DEFINE(leds_on, APP_DISPLAY_LED_COUNT);
+static ATOMIC_DEFINE(leds_dirty, APP_DISPLAY_LED_COUNT);
+static atomic_t leds_started;
+
+static uint32_t min_refresh_ms = CONFIG_APP_DISPLAY_MIN_REFRESH_MS;
+static int64_t last_refresh_ms = -CONFIG_APP_DISPLAY_MIN_REFRESH_MS;
+static bool started;
+
+static void schedule_refresh(void);
+
+static void display_work_handler(struct k_work *work)
+{
+	bool retry = false;
+
+	app_metrics_inc(APP_METRICS_WORKQ_RUNS);
+
+	for (int key = 0; key < SLIDE_KEY_COUNT; key++) {
+		char text[TEXT_LEN];
+
+		if (!atomic_test_and_clear_bit(dirty, key)) {
+			continue;
+		}
+
+		k_spinlock_key_t lock = k_spin_lock(&slides_lock);
+
+		memcpy(text, slides[key].pending, sizeof(text));
+		k_spin_unlock(&slides_lock, lock);
+
+		if (strcmp(text, slides[key].shown) == 0) {
+			/* Nothing changed on screen; skip the I2C transaction */
+			continue;
+		}
+
+		int err = ostentus_slide_set(o_dev, key, text, strlen(text));
+
+		if (err) {
+			LOG_WRN("Unable to update slide %d: %d", key, err);
+			/* Still not shown; write it again on the next refresh */
+			atomic_set_bit(dirty, key);
+			retry = true;
+			continue;
+		}
+
+		memcpy(slides[key].shown, text, sizeof(text));
+	}
+
+	last_refresh_ms = k_uptime_get();
+
+	if (retry) {
+		schedule_refresh();
+	}
+}
+K_WORK_DELAYABLE_DEFINE(display_work, display_work_handler);
+
+/* Faceplate writes block on I2C, so they run on the upload work queue rather than with the
+ * NMEA parser
+ */
+static void schedule_refresh(void)
+{
+	int64_t wait_ms = last_refresh_ms + min_refresh_ms - k_uptime_get();
+
+	/* Does nothing if a refresh is already scheduled, so updates are coalesced */
+	k_work_schedule_for_queue(&app_upload_work_q, &display_work, K_MSEC(MAX(wait_ms, 0)));
+}
+
+void app_display_slide_set(slide_key key, const char *text)
+{
+	if (key >= SLIDE_KEY_COUNT) {
+		return;
+	}
+
+	k_spinlock_key_t lock = k_spin_lock(&slides_lock);
+
+	strncpy(slides[key].pending, text, TEXT_LEN - 1);
+	slides[key].pending[TEXT_LEN - 1] = '\0';
+	k_spin_unlock(&slides_lock, lock);
+
+	atomic_set_bit(dirty, key);
+
+	if (started) {
+		schedule_refresh();
+	}
+}
+
+static int led_write(enum app_display_led led, bool on)
+{
+	switch (led) {
+	case APP_DISPLAY_LED_INTERNET:
+		return ostentus_led_internet_set(o_dev, on);
+	case APP_DISPLAY_LED_GOLIOTH:
+		return ostentus_led_golioth_set(o_dev, on);
+	default:
+		return -EINVAL;
+	}
+}
+
+static void led_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(led_work, led_work_handler);
+
+static void led_work_handler(struct k_work *work)
+{
+	app_metrics_inc(APP_METRICS_WORKQ_RUNS);
+
+	for (int led = 0; led < APP_DISPLAY_LED_COUNT; led++) {
+		if (!atomic_test_and_clear_bit(leds_dirty, led)) {
+			continue;
+		}
+
+		int err = led_write(led, atomic_test_bit(leds_on, led));
+
+		if (err) {
+			LOG_WRN("Unable to set LED %d: %d", led, err);
+			atomic_set_bit(leds_dirty, led);
+			k_work_schedule_for_queue(&app_upload_work_q, &led_work,
+						  K_MSEC(CONFIG_APP_DISPLAY_MIN_REFRESH_MS));
+		}
+	}
+}
+
+void app_display_led_set(enum app_display_led led, bool on)
+{
+	if (led >= APP_DISPLAY_LED_COUNT) {
+		return;
+	}
+
+	atomic_set_bit_to(leds_on, led, on);
+	atomic_set_bit(leds_dirty, led);
+
+	if (atomic_get(&leds_started)) {
+		k_work_schedule_for_queue(&app_upload_work_q, &led_work, K_NO_WAIT);
+	}
+}
+
+void app_display_leds_start(void)
+{
+	/* The reset turned every LED off; write them all again */
+	for (int led = 0; led < APP_DISPLAY_LED_COUNT; led++) {
+		atomic_set_bit(leds_dirty, led);
+	}
+
+	atomic_set(&leds_started, 1);
+	k_work_schedule_for_queue(&app_upload_work_q, &led_work, K_NO_WAIT);
+}
+
+void app_display_min_refresh_set(uint32_t refresh_ms)
+{
+	min_refresh_ms = refresh_ms;
+}
+
+void app_display_init(void)
+{
+	started = true;
+
+	/* Write anything published before the slides existed */
+	schedule_refresh();
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Asynchronous updates of the Ostentus slide values.
+ *
+ * Producers publish slide text with app_display_slide_set(), which only copies
+ * the text and marks the slide dirty. The upload work queue writes dirty
+ * slides to the faceplate over I2C, away from the NMEA parser, skipping text
+ * that is already shown, no more often than once every
+ * CONFIG_APP_DISPLAY_MIN_REFRESH_MS.
+ *
+ * The status LEDs are written by the same work queue, so they never race the
+ * faceplate reset or a slide write. LED changes made before the reset are
+ * cached and applied once app_display_leds_start() is called.
+ */
+
+#ifndef __APP_DISPLAY_H__
+#define __APP_DISPLAY_H__
+
+#include <stdbool.h>
+
+#include "app_sensors.h"
+
+enum app_display_led {
+	APP_DISPLAY_LED_INTERNET,
+	APP_DISPLAY_LED_GOLIOTH,
+	APP_DISPLAY_LED_COUNT
+};
+
+/**
+ * Start writing slide values. Slides must be added to the faceplate before
+ * calling this; values published earlier are written once it is called.
+ */
+void app_display_init(void);
+
+/**
+ * Publish a new value for a slide. Never blocks on I2C; safe to call from any
+ * thread.
+ *
+ * @param key slide to update
+ * @param text null-terminated text, truncated to CONFIG_APP_DISPLAY_TEXT_LEN - 1
+ */
+void app_display_slide_set(slide_key key, const char *text);
+
+/**
+ * Start writing the status LEDs, and apply those set so far. Called on the
+ * upload work queue once the faceplate has been reset.
+ */
+void app_display_leds_start(void);
+
+/**
+ * Turn a status LED on or off. Never blocks on I2C; safe to call from any
+ * thread.
+ */
+void app_display_led_set(enum app_display_led led, bool on);
+
+/**
+ * Change the minimum time between faceplate refreshes. Defaults to
+ * CONFIG_APP_DISPLAY_MIN_REFRESH_MS.
+ */
+void app_display_min_refresh_set(uint32_t min_refresh_ms);
+
+#endif /* __APP_DISPLAY_H__ */
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_energy, LOG_LEVEL_DBG);
+
+#include <golioth/stream.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "app_energy.h"
+#include "app_metrics.h"
+
+#define ENERGY_ENDP "energy"
+
+#define STREAM_BUF_SIZE 256
+
+#define MS_PER_HOUR (3600ULL * MSEC_PER_SEC)
+
+enum energy_state {
+	MODEM_ACTIVE, /* RRC connected, or searching for a network */
+	MODEM_IDLE,
+	MODEM_SLEEP,
+	GNSS_RUNNING,
+	GNSS_STOPPED,
+	ENERGY_STATE_COUNT
+};
+
+static const char *const state_names[ENERGY_STATE_COUNT] = {
+	[MODEM_ACTIVE] = "modem_active",
+	[MODEM_IDLE] = "modem_idle",
+	[MODEM_SLEEP] = "modem_sleep",
+	[GNSS_RUNNING] = "gnss_running",
+	[GNSS_STOPPED] = "gnss_stopped",
+};
+
+static const uint32_t state_ua[ENERGY_STATE_COUNT] = {
+	[MODEM_ACTIVE] = CONFIG_APP_ENERGY_MODEM_ACTIVE_UA,
+	[MODEM_IDLE] = CONFIG_APP_ENERGY_MODEM_IDLE_UA,
+	[MODEM_SLEEP] = CONFIG_APP_ENERGY_MODEM_SLEEP_UA,
+	[GNSS_RUNNING] = CONFIG_APP_ENERGY_GNSS_RUNNING_UA,
+	[GNSS_STOPPED] = CONFIG_APP_ENERGY_GNSS_STOPPED_UA,
+};
+
+/* Each tracked subsystem is in exactly one of its states at a time */
+struct energy_track {
+	enum energy_state state;
+	int64_t since_ms;
+};
+
+static struct k_spinlock lock;
+static uint64_t state_ms[ENERGY_STATE_COUNT];
+
+static struct energy_track modem = {
+	.state = IS_ENABLED(CONFIG_SOC_SERIES_NRF91X) ? MODEM_ACTIVE : ENERGY_STATE_COUNT,
+};
+static struct energy_track gnss = {.state = GNSS_RUNNING};
+
+static void track_set(struct energy_track *track, enum energy_state state)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	int64_t now = k_uptime_get();
+
+	if (track->state < ENERGY_STATE_COUNT) {
+		state_ms[track->state] += now - track->since_ms;
+	}
+
+	track->state = state;
+	track->since_ms = now;
+	k_spin_unlock(&lock, key);
+}
+
+#ifdef CONFIG_SOC_SERIES_NRF91X
+void app_energy_lte_evt(const struct lte_lc_evt *const evt)
+{
+	switch (evt->type) {
+	case LTE_LC_EVT_RRC_UPDATE:
+		track_set(&modem, (evt->rrc_mode == LTE_LC_RRC_MODE_CONNECTED) ? MODEM_ACTIVE
+										: MODEM_IDLE);
+		break;
+	case LTE_LC_EVT_MODEM_SLEEP_ENTER:
+		/* Requires CONFIG_LTE_LC_MODEM_SLEEP_NOTIFICATIONS */
+		track_set(&modem, MODEM_SLEEP);
+		break;
+	case LTE_LC_EVT_MODEM_SLEEP_EXIT:
+		track_set(&modem, MODEM_IDLE);
+		break;
+	default:
+		break;
+	}
+}
+#endif /* CONFIG_SOC_SERIES_NRF91X */
+
+void app_energy_gnss_set(bool running)
+{
+	track_set(&gnss, running ? GNSS_RUNNING : GNSS_STOPPED);
+}
+
+/* Snapshot of the time spent in each state, including the current one */
+static void state_ms_get(uint64_t out[ENERGY_STATE_COUNT])
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	int64_t now = k_uptime_get();
+
+	memcpy(out, state_ms, sizeof(state_ms));
+
+	if (modem.state < ENERGY_STATE_COUNT) {
+		out[modem.state] += now - modem.since_ms;
+	}
+	out[gnss.state] += now - gnss.since_ms;
+	k_spin_unlock(&lock, key);
+}
+
+static uint64_t charge_nah(uint32_t current_ua, uint64_t ms)
+{
+	return (current_ua * ms * 1000) / MS_PER_HOUR;
+}
+
+/* CPU charge from the time the idle thread did not run */
+static uint64_t cpu_charge_nah(uint64_t *active_ms)
+{
+	uint64_t idle_ms = 0;
+	uint64_t uptime_ms = k_uptime_get();
+
+#ifdef CONFIG_SCHED_THREAD_USAGE_ALL
+	k_thread_runtime_stats_t stats;
+
+	if (k_thread_runtime_stats_all_get(&stats) == 0) {
+		idle_ms = k_cyc_to_ms_floor64(stats.idle_cycles);
+	}
+#endif
+
+	*active_ms = uptime_ms - MIN(idle_ms, uptime_ms);
+
+	return charge_nah(CONFIG_APP_ENERGY_CPU_ACTIVE_UA, *active_ms) +
+	       charge_nah(CONFIG_APP_ENERGY_CPU_IDLE_UA, uptime_ms - *active_ms);
+}
+
+static bool encode_u64(zcbor_state_t *zse, const char *key, uint64_t value)
+{
+	return zcbor_tstr_encode_ptr(zse, key, strlen(key)) && zcbor_uint64_put(zse, value);
+}
+
+/* Add charge estimates (nAh) and times (ms) since boot to an open map */
+static int energy_encode(zcbor_state_t *zse)
+{
+	uint64_t ms[ENERGY_STATE_COUNT];
+	uint64_t cpu_active_ms;
+	uint64_t cpu_nah = cpu_charge_nah(&cpu_active_ms);
+
+	state_ms_get(ms);
+
+	uint64_t modem_nah = charge_nah(state_ua[MODEM_ACTIVE], ms[MODEM_ACTIVE]) +
+			     charge_nah(state_ua[MODEM_IDLE], ms[MODEM_IDLE]) +
+			     charge_nah(state_ua[MODEM_SLEEP], ms[MODEM_SLEEP]);
+	uint64_t gnss_nah = charge_nah(state_ua[GNSS_RUNNING], ms[GNSS_RUNNING]) +
+			    charge_nah(state_ua[GNSS_STOPPED], ms[GNSS_STOPPED]);
+	/* A live reading which fails to stream is queued and counted there instead */
+	uint32_t readings = app_metrics_counter_get(APP_METRICS_READINGS_QUEUED) +
+			    app_metrics_counter_get(APP_METRICS_READINGS_STREAMED);
+	uint32_t bytes = app_metrics_counter_get(APP_METRICS_UPLOAD_BYTES);
+	bool ok = true;
+
+	for (int i = 0; i < ENERGY_STATE_COUNT && ok; i++) {
+		char key[24];
+
+		snprintk(key, sizeof(key), "%s_ms", state_names[i]);
+		ok = encode_u64(zse, key, ms[i]);
+	}
+
+	ok = ok && encode_u64(zse, "cpu_active_ms", cpu_active_ms) &&
+	     encode_u64(zse, "modem_nah", modem_nah) && encode_u64(zse, "gnss_nah", gnss_nah) &&
+	     encode_u64(zse, "cpu_nah", cpu_nah) && encode_u64(zse, "readings", readings) &&
+	     encode_u64(zse, "upload_bytes", bytes);
+
+	/* Sampling costs (GNSS, CPU) per reading; radio costs per uploaded byte */
+	if (ok && readings) {
+		ok = encode_u64(zse, "nah_per_reading", (gnss_nah + cpu_nah) / readings);
+	}
+
+	if (ok && bytes) {
+		ok = encode_u64(zse, "pah_per_byte", (modem_nah * 1000) / bytes);
+	}
+
+	return ok ? 0 : -ENOMEM;
+}
+
+int app_energy_add_to_map(zcbor_state_t *response_detail_map)
+{
+	return energy_encode(response_detail_map);
+}
+
+#if CONFIG_APP_ENERGY_STREAM_INTERVAL_S > 0
+static struct golioth_client *energy_client;
+
+static void stream_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(stream_work, stream_work_handler);
+
+static void stream_work_handler(struct k_work *work)
+{
+	static uint8_t buf[STREAM_BUF_SIZE];
+	ZCBOR_STATE_E(zse, 2, buf, sizeof(buf), 1);
+
+	k_work_reschedule(&stream_work, K_SECONDS(CONFIG_APP_ENERGY_STREAM_INTERVAL_S));
+
+	if (!golioth_client_is_connected(energy_client)) {
+		return;
+	}
+
+	bool ok = zcbor_map_start_encode(zse, 32) && (energy_encode(zse) == 0) &&
+		  zcbor_map_end_encode(zse, 32);
+
+	if (!ok) {
+		LOG_ERR("Energy report does not fit in %d bytes", STREAM_BUF_SIZE);
+		return;
+	}
+
+	int err = golioth_stream_set_async(energy_client, ENERGY_ENDP, GOLIOTH_CONTENT_TYPE_CBOR,
+					   buf, zse->payload - buf, NULL, NULL);
+
+	if (err) {
+		LOG_ERR("Failed to stream energy report: %d", err);
+	}
+}
+#endif /* CONFIG_APP_ENERGY_STREAM_INTERVAL_S > 0 */
+
+void app_energy_stream_start(struct golioth_client *client)
+{
+#if CONFIG_APP_ENERGY_STREAM_INTERVAL_S > 0
+	energy_client = client;
+	k_work_schedule(&stream_work, K_SECONDS(CONFIG_APP_ENERGY_STREAM_INTERVAL_S));
+#endif
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Energy accounting.
+ *
+ * Time spent by the modem (RRC connected, idle, sleep), the GNSS receiver
+ * (running, stopped) and the CPU (active, idle) is multiplied by the current
+ * model in Kconfig (CONFIG_APP_ENERGY_*_UA) to estimate the charge used by
+ * each. GNSS and CPU charge is attributed to stored readings, modem charge to
+ * uploaded bytes. Reported by the `get_energy` RPC and optionally streamed to
+ * the "energy" path.
+ */
+
+#ifndef __APP_ENERGY_H__
+#define __APP_ENERGY_H__
+
+#include <errno.h>
+#include <stdbool.h>
+#include <golioth/client.h>
+#include <zcbor_encode.h>
+
+#ifdef CONFIG_SOC_SERIES_NRF91X
+#include <modem/lte_lc.h>
+#endif
+
+#ifdef CONFIG_APP_ENERGY
+
+#ifdef CONFIG_SOC_SERIES_NRF91X
+/** Track modem activity from an LTE link controller event */
+void app_energy_lte_evt(const struct lte_lc_evt *const evt);
+#endif
+
+/** Record a change of the GNSS engine state */
+void app_energy_gnss_set(bool running);
+
+/** Add charge estimates to an RPC response map */
+int app_energy_add_to_map(zcbor_state_t *response_detail_map);
+
+/** Start the periodic energy stream, if enabled */
+void app_energy_stream_start(struct golioth_client *client);
+
+#else
+
+#ifdef CONFIG_SOC_SERIES_NRF91X
+static inline void app_energy_lte_evt(const struct lte_lc_evt *const evt)
+{
+}
+#endif
+
+static inline void app_energy_gnss_set(bool running)
+{
+}
+
+static inline int app_energy_add_to_map(zcbor_state_t *response_detail_map)
+{
+	return -ENOTSUP;
+}
+
+static inline void app_energy_stream_start(struct golioth_client *client)
+{
+}
+
+#endif /* CONFIG_APP_ENERGY */
+
+#endif /* __APP_ENERGY_H__ */
@@ -0,0 +1,658 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_geofence, LOG_LEVEL_DBG);
+
+#include <golioth/client.h>
+#include <golioth/lightdb_state.h>
+#include <golioth/stream.h>
+#include <math.h>
+#include <stdlib.h>
+#include <zcbor_decode.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+
+#include "app_geofence.h"
+#include "app_gnss.h"
+
+#define MAX_FENCES    CONFIG_APP_GEOFENCE_MAX_FENCES
+#define MAX_VERTICES  CONFIG_APP_GEOFENCE_MAX_VERTICES
+#define MAX_CELL_REFS CONFIG_APP_GEOFENCE_MAX_CELL_REFS
+#define MAX_ACTIVE    CONFIG_APP_GEOFENCE_MAX_ACTIVE
+#define GRID_DIM      CONFIG_APP_GEOFENCE_GRID_DIM
+#define GRID_CELLS    (GRID_DIM * GRID_DIM)
+
+/* Decimeters per microdegree of latitude, scaled by 10000 */
+#define DM_PER_UDEG_X10000 11132
+#define UDEG_PER_M	   (1000000.0f / 111320.0f)
+#define DEG_TO_RAD	   (3.14159265f / 180.0f)
+
+struct geofence_point {
+	int32_t lat; /* microdegrees */
+	int32_t lon; /* microdegrees */
+};
+
+struct geofence {
+	uint32_t id;
+	uint32_t radius_m; /* circle if non-zero, otherwise polygon */
+	uint16_t first_vertex;
+	uint16_t vertex_count;
+	uint16_t cos_lat_q15; /* cos(latitude) of a circle's center */
+	struct geofence_point min;
+	struct geofence_point max;
+};
+
+struct geofence_state {
+	uint8_t inside: 1;
+	uint8_t streak: 7; /* consecutive fixes disagreeing with `inside` */
+};
+
+struct geofence_event {
+	uint32_t id;
+	bool enter;
+	struct minmea_date date;
+	struct minmea_time time;
+};
+
+/* Fence set; protected by fence_mutex */
+static struct geofence fences[MAX_FENCES];
+static struct geofence_point vertices[MAX_VERTICES];
+static struct geofence_state fence_state[MAX_FENCES];
+static uint16_t fence_count;
+static uint16_t vertex_count;
+
+/* Grid index over the bounding box of the fence set. The fences overlapping
+ * cell `c` are cell_refs[cell_start[c]] up to cell_refs[cell_start[c + 1]].
+ */
+static struct geofence_point grid_origin;
+static int32_t grid_cell_lat;
+static int32_t grid_cell_lon;
+static uint16_t cell_start[GRID_CELLS + 1];
+static uint16_t cell_refs[MAX_CELL_REFS];
+
+/* Fences which are inside or have a pending transition */
+static uint16_t active[MAX_ACTIVE];
+static uint8_t active_count;
+
+static uint32_t loaded_hash;
+static uint32_t pending_hash;
+static bool hash_valid;
+
+static struct golioth_client *client;
+
+K_MUTEX_DEFINE(fence_mutex);
+K_MSGQ_DEFINE(geofence_event_msgq, sizeof(struct geofence_event),
+	      CONFIG_APP_GEOFENCE_EVENT_QUEUE_SIZE, 4);
+
+BUILD_ASSERT(MAX_VERTICES <= UINT16_MAX && MAX_CELL_REFS <= UINT16_MAX,
+	     "Geofence indexes are stored as 16-bit values");
+
+/* Events stay queued until they have been handed to the client, so those raised
+ * offline go out when the connection comes back (app_geofence_flush())
+ */
+static void event_work_handler(struct k_work *work)
+{
+	struct geofence_event evt;
+	char sbuf[96];
+
+	while (client && golioth_client_is_connected(client) &&
+	       k_msgq_peek(&geofence_event_msgq, &evt) == 0) {
+		snprintk(sbuf, sizeof(sbuf),
+			 "[{\"id\":%u,\"event\":\"%s\","
+			 "\"time\":\"20%02d-%02d-%02dT%02d:%02d:%02d.%03dZ\"}]",
+			 evt.id, evt.enter ? "enter" : "exit", evt.date.year, evt.date.month,
+			 evt.date.day, evt.time.hours, evt.time.minutes, evt.time.seconds,
+			 evt.time.microseconds / 1000);
+
+		int err = golioth_stream_set_async(client, APP_GEOFENCE_ENDP,
+						   GOLIOTH_CONTENT_TYPE_JSON, sbuf, strlen(sbuf),
+						   NULL, NULL);
+		if (err) {
+			LOG_ERR("Failed to send geofence event: %d", err);
+			return;
+		}
+
+		k_msgq_get(&geofence_event_msgq, &evt, K_NO_WAIT);
+	}
+}
+K_WORK_DEFINE(event_work, event_work_handler);
+
+static int grid_index(int32_t v, int32_t origin, int32_t cell_size)
+{
+	int64_t offset = (int64_t)v - origin;
+
+	if (offset < 0) {
+		return -1;
+	}
+
+	int64_t idx = offset / cell_size;
+
+	return (idx < GRID_DIM) ? (int)idx : -1;
+}
+
+static int grid_cell(struct geofence_point p)
+{
+	if (fence_count == 0) {
+		return -1;
+	}
+
+	int row = grid_index(p.lat, grid_origin.lat, grid_cell_lat);
+	int col = grid_index(p.lon, grid_origin.lon, grid_cell_lon);
+
+	return (row < 0 || col < 0) ? -1 : (row * GRID_DIM + col);
+}
+
+/* Totals of a fence set, gathered by decoding it before it replaces the loaded set */
+struct fence_scan {
+	uint32_t hash;
+	uint16_t fence_count;
+	uint16_t vertex_count;
+	struct geofence_point min;
+	struct geofence_point max;
+	/* Grid over the bounding box of the set; cell_lat is 0 until it is known */
+	struct geofence_point origin;
+	int32_t cell_lat;
+	int32_t cell_lon;
+	uint32_t cell_refs;
+};
+
+static void scan_grid(struct fence_scan *scan)
+{
+	if (scan->fence_count == 0) {
+		return;
+	}
+
+	scan->origin = scan->min;
+	scan->cell_lat = ((int64_t)scan->max.lat - scan->min.lat) / GRID_DIM + 1;
+	scan->cell_lon = ((int64_t)scan->max.lon - scan->min.lon) / GRID_DIM + 1;
+}
+
+static void scan_fence(struct fence_scan *scan, const struct geofence *f)
+{
+	scan->min.lat = MIN(scan->min.lat, f->min.lat);
+	scan->min.lon = MIN(scan->min.lon, f->min.lon);
+	scan->max.lat = MAX(scan->max.lat, f->max.lat);
+	scan->max.lon = MAX(scan->max.lon, f->max.lon);
+
+	if (scan->cell_lat) {
+		int rows = grid_index(f->max.lat, scan->origin.lat, scan->cell_lat) -
+			   grid_index(f->min.lat, scan->origin.lat, scan->cell_lat) + 1;
+		int cols = grid_index(f->max.lon, scan->origin.lon, scan->cell_lon) -
+			   grid_index(f->min.lon, scan->origin.lon, scan->cell_lon) + 1;
+
+		scan->cell_refs += rows * cols;
+	}
+}
+
+/* Index the loaded fences on the grid of the scan, which has room for its references */
+static void build_index(const struct fence_scan *scan)
+{
+	memset(cell_start, 0, sizeof(cell_start));
+
+	if (fence_count == 0) {
+		return;
+	}
+
+	grid_origin = scan->origin;
+	grid_cell_lat = scan->cell_lat;
+	grid_cell_lon = scan->cell_lon;
+
+	/* First pass: count references per cell; second pass: fill from the end of each cell */
+	for (int pass = 0; pass < 2; pass++) {
+		for (int i = 0; i < fence_count; i++) {
+			int r0 = grid_index(fences[i].min.lat, grid_origin.lat, grid_cell_lat);
+			int r1 = grid_index(fences[i].max.lat, grid_origin.lat, grid_cell_lat);
+			int c0 = grid_index(fences[i].min.lon, grid_origin.lon, grid_cell_lon);
+			int c1 = grid_index(fences[i].max.lon, grid_origin.lon, grid_cell_lon);
+
+			for (int r = r0; r <= r1; r++) {
+				for (int c = c0; c <= c1; c++) {
+					int cell = r * GRID_DIM + c;
+
+					if (pass == 0) {
+						cell_start[cell]++;
+					} else {
+						cell_refs[--cell_start[cell]] = i;
+					}
+				}
+			}
+		}
+
+		if (pass == 0) {
+			/* Running sum: cell_start[c] becomes the end of cell c */
+			for (int c = 1; c <= GRID_CELLS; c++) {
+				cell_start[c] += cell_start[c - 1];
+			}
+		}
+	}
+
+	/* After the fill pass cell_start[c] is the start of cell c */
+	cell_start[GRID_CELLS] = scan->cell_refs;
+}
+
+static bool circle_contains(const struct geofence *f, struct geofence_point p)
+{
+	const struct geofence_point *c = &vertices[f->first_vertex];
+	int64_t dy = ((int64_t)p.lat - c->lat) * DM_PER_UDEG_X10000 / 10000;
+	int64_t dx = ((((int64_t)p.lon - c->lon) * DM_PER_UDEG_X10000 / 10000) * f->cos_lat_q15) >>
+		     15;
+	int64_t r = (int64_t)f->radius_m * 10;
+
+	return (dx * dx + dy * dy) <= (r * r);
+}
+
+/* Even-odd ray casting using integer cross products */
+static bool polygon_contains(const struct geofence *f, struct geofence_point p)
+{
+	const struct geofence_point *v = &vertices[f->first_vertex];
+	bool inside = false;
+
+	for (int i = 0, j = f->vertex_count - 1; i < f->vertex_count; j = i++) {
+		if ((v[i].lat > p.lat) == (v[j].lat > p.lat)) {
+			continue;
+		}
+
+		int64_t lhs = ((int64_t)p.lon - v[i].lon) * ((int64_t)v[j].lat - v[i].lat);
+		int64_t rhs = ((int64_t)v[j].lon - v[i].lon) * ((int64_t)p.lat - v[i].lat);
+
+		if ((v[j].lat > v[i].lat) ? (lhs < rhs) : (lhs > rhs)) {
+			inside = !inside;
+		}
+	}
+
+	return inside;
+}
+
+static bool fence_contains(const struct geofence *f, struct geofence_point p)
+{
+	if (p.lat < f->min.lat || p.lat > f->max.lat || p.lon < f->min.lon || p.lon > f->max.lon) {
+		return false;
+	}
+
+	return f->radius_m ? circle_contains(f, p) : polygon_contains(f, p);
+}
+
+static void observe_fence(uint16_t idx, bool hit, const struct minmea_sentence_rmc *frame)
+{
+	struct geofence_state *st = &fence_state[idx];
+
+	if (hit == st->inside) {
+		st->streak = 0;
+		return;
+	}
+
+	if (++st->streak < CONFIG_APP_GEOFENCE_HYSTERESIS_FIXES) {
+		return;
+	}
+
+	st->inside = hit;
+	st->streak = 0;
+
+	struct geofence_event evt = {
+		.id = fences[idx].id,
+		.enter = hit,
+		.date = frame->date,
+		.time = frame->time,
+	};
+
+	LOG_INF("Geofence %u %s", evt.id, hit ? "entered" : "exited");
+
+	if (k_msgq_put(&geofence_event_msgq, &evt, K_NO_WAIT) != 0) {
+		LOG_WRN("Geofence event queue full, dropping event");
+	}
+}
+
+static bool is_listed(const uint16_t *list, size_t count, uint16_t idx)
+{
+	for (size_t i = 0; i < count; i++) {
+		if (list[i] == idx) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void track_active(uint16_t idx)
+{
+	const struct geofence_state *st = &fence_state[idx];
+
+	if ((!st->inside && !st->streak) || is_listed(active, active_count, idx)) {
+		return;
+	}
+
+	if (active_count >= MAX_ACTIVE) {
+		LOG_WRN("Too many active geofences; exit from %u may be missed", fences[idx].id);
+		return;
+	}
+
+	active[active_count++] = idx;
+}
+
+void app_geofence_evaluate(const struct minmea_sentence_rmc *frame)
+{
+	struct geofence_point p = {
+		.lat = app_gnss_coord_udeg(&frame->latitude),
+		.lon = app_gnss_coord_udeg(&frame->longitude),
+	};
+
+	if (p.lat == APP_GNSS_COORD_INVALID || p.lon == APP_GNSS_COORD_INVALID) {
+		return;
+	}
+
+	/* Never block the NMEA parser; skip this fix if the set is being replaced */
+	if (k_mutex_lock(&fence_mutex, K_NO_WAIT) != 0) {
+		return;
+	}
+
+	const uint16_t *candidates = NULL;
+	size_t candidate_count = 0;
+	int cell = grid_cell(p);
+
+	if (cell >= 0) {
+		candidates = &cell_refs[cell_start[cell]];
+		candidate_count = cell_start[cell + 1] - cell_start[cell];
+	}
+
+	for (size_t i = 0; i < candidate_count; i++) {
+		observe_fence(candidates[i], fence_contains(&fences[candidates[i]], p), frame);
+		track_active(candidates[i]);
+	}
+
+	/* Active fences outside the current cell cannot contain the fix */
+	uint8_t kept = 0;
+
+	for (uint8_t i = 0; i < active_count; i++) {
+		uint16_t idx = active[i];
+
+		if (!is_listed(candidates, candidate_count, idx)) {
+			observe_fence(idx, false, frame);
+		}
+
+		if (fence_state[idx].inside || fence_state[idx].streak) {
+			active[kept++] = idx;
+		}
+	}
+	active_count = kept;
+
+	k_mutex_unlock(&fence_mutex);
+
+	app_geofence_flush();
+}
+
+/* Values are added to the hash of the set as they are decoded */
+static bool decode_coord(zcbor_state_t *zsd, int32_t *value, uint32_t *hash)
+{
+	double d;
+
+	if (!zcbor_int32_decode(zsd, value)) {
+		if (!zcbor_float_decode(zsd, &d)) {
+			return false;
+		}
+
+		*value = (int32_t)d;
+	}
+
+	uint8_t le[sizeof(*value)];
+
+	sys_put_le32(*value, le);
+	*hash = crc32_ieee_update(*hash, le, sizeof(le));
+
+	return true;
+}
+
+static int finish_fence(struct geofence *f, const struct geofence_point *c)
+{
+	if (f->radius_m == 0) {
+		return (f->vertex_count >= 3) ? 0 : -EINVAL;
+	}
+
+	if (f->vertex_count != 1) {
+		return -EINVAL;
+	}
+
+	float cos_lat = cosf(c->lat * 1e-6f * DEG_TO_RAD);
+	int32_t dlat = (int32_t)(f->radius_m * UDEG_PER_M) + 1;
+	int32_t dlon = (int32_t)(dlat / MAX(cos_lat, 0.01f)) + 1;
+
+	f->cos_lat_q15 = (uint16_t)(cos_lat * 32767.0f);
+	f->min.lat = c->lat - dlat;
+	f->max.lat = c->lat + dlat;
+	f->min.lon = c->lon - dlon;
+	f->max.lon = c->lon + dlon;
+
+	return 0;
+}
+
+/*
+ * Decode the fence set and compute its hash: the CRC-32 (IEEE) of every value
+ * of every fence, in order, as little-endian 32-bit integers. This is what
+ * utility/geofence_hash.py computes for the `hash` published with the set.
+ *
+ * Unless `store` is set, the loaded set is not touched and only the totals of
+ * the scan are gathered, so a set can be checked before it replaces it.
+ */
+static int decode_fence_set(const uint8_t *payload, size_t payload_size, struct fence_scan *scan,
+			    bool store)
+{
+	ZCBOR_STATE_D(zsd, 2, payload, payload_size, 1, 0);
+
+	scan->hash = 0;
+	scan->fence_count = 0;
+	scan->vertex_count = 0;
+	scan->min = (struct geofence_point){INT32_MAX, INT32_MAX};
+	scan->max = (struct geofence_point){INT32_MIN, INT32_MIN};
+	scan->cell_refs = 0;
+
+	if (!zcbor_list_start_decode(zsd)) {
+		return -EBADMSG;
+	}
+
+	while (!zcbor_array_at_end(zsd)) {
+		if (scan->fence_count >= MAX_FENCES) {
+			return -ENOMEM;
+		}
+
+		struct geofence scratch;
+		struct geofence *f = store ? &fences[scan->fence_count] : &scratch;
+		struct geofence_point first = {0};
+		int32_t id;
+		int32_t radius;
+
+		if (!zcbor_list_start_decode(zsd) || !decode_coord(zsd, &id, &scan->hash) ||
+		    !decode_coord(zsd, &radius, &scan->hash)) {
+			return -EBADMSG;
+		}
+
+		*f = (struct geofence){
+			.id = id,
+			.radius_m = MAX(radius, 0),
+			.first_vertex = scan->vertex_count,
+			.min = {INT32_MAX, INT32_MAX},
+			.max = {INT32_MIN, INT32_MIN},
+		};
+
+		while (!zcbor_array_at_end(zsd)) {
+			struct geofence_point pt;
+
+			if (scan->vertex_count >= MAX_VERTICES) {
+				return -ENOMEM;
+			}
+
+			if (!decode_coord(zsd, &pt.lat, &scan->hash) ||
+			    !decode_coord(zsd, &pt.lon, &scan->hash)) {
+				return -EBADMSG;
+			}
+
+			if (f->vertex_count == 0) {
+				first = pt;
+			}
+			if (store) {
+				vertices[scan->vertex_count] = pt;
+			}
+			scan->vertex_count++;
+			f->vertex_count++;
+			f->min.lat = MIN(f->min.lat, pt.lat);
+			f->min.lon = MIN(f->min.lon, pt.lon);
+			f->max.lat = MAX(f->max.lat, pt.lat);
+			f->max.lon = MAX(f->max.lon, pt.lon);
+		}
+
+		if (!zcbor_list_end_decode(zsd)) {
+			return -EBADMSG;
+		}
+
+		if (finish_fence(f, &first)) {
+			if (store) {
+				LOG_WRN("Ignoring malformed geofence %u", f->id);
+			}
+			scan->vertex_count = f->first_vertex;
+			continue;
+		}
+
+		scan_fence(scan, f);
+		scan->fence_count++;
+	}
+
+	return zcbor_list_end_decode(zsd) ? 0 : -EBADMSG;
+}
+
+/*
+ * Check the set before loading it: it must decode, match the published hash
+ * and fit the grid index. Loading then decodes the same payload again, so a
+ * set which fails keeps the last good set tracking.
+ */
+static int check_fence_set(const uint8_t *payload, size_t payload_size, struct fence_scan *scan)
+{
+	int err = decode_fence_set(payload, payload_size, scan, false);
+
+	if (err) {
+		return err;
+	}
+
+	/* A set edited without updating its hash, or fetched while being replaced */
+	if (scan->hash != pending_hash) {
+		LOG_ERR("Geofence set hash is %u, expected %u", scan->hash, pending_hash);
+		return -EILSEQ;
+	}
+
+	/* A second pass counts the references on the grid of the whole set */
+	scan_grid(scan);
+	err = decode_fence_set(payload, payload_size, scan, false);
+	if (err) {
+		return err;
+	}
+
+	if (scan->cell_refs > MAX_CELL_REFS) {
+		LOG_ERR("Geofence index needs %u cell references; max is %d", scan->cell_refs,
+			MAX_CELL_REFS);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static void on_fence_set(struct golioth_client *client, enum golioth_status status,
+			 const struct golioth_coap_rsp_code *coap_rsp_code, const char *path,
+			 const uint8_t *payload, size_t payload_size, void *arg)
+{
+	struct fence_scan scan = {0};
+
+	if (status != GOLIOTH_OK) {
+		LOG_ERR("Failed to receive '%s' endpoint: %d", APP_GEOFENCE_SET_ENDP, status);
+		return;
+	}
+
+	/* Checked without the lock, as the loaded set is not touched */
+	int err = check_fence_set(payload, payload_size, &scan);
+
+	if (err) {
+		LOG_ERR("Unable to load geofence set: %d; keeping %d loaded geofences", err,
+			fence_count);
+		return;
+	}
+
+	k_mutex_lock(&fence_mutex, K_FOREVER);
+
+	decode_fence_set(payload, payload_size, &scan, true);
+	fence_count = scan.fence_count;
+	vertex_count = scan.vertex_count;
+	build_index(&scan);
+
+	loaded_hash = pending_hash;
+	hash_valid = true;
+	LOG_INF("Loaded %d geofences (%d vertices, %d cell refs), hash %u", fence_count,
+		vertex_count, cell_start[GRID_CELLS], loaded_hash);
+
+	/* Fence indexes changed; start tracking from scratch */
+	memset(fence_state, 0, sizeof(fence_state));
+	active_count = 0;
+
+	k_mutex_unlock(&fence_mutex);
+}
+
+static void on_fence_hash(struct golioth_client *client, enum golioth_status status,
+			  const struct golioth_coap_rsp_code *coap_rsp_code, const char *path,
+			  const uint8_t *payload, size_t payload_size, void *arg)
+{
+	char sbuf[16];
+
+	if (status != GOLIOTH_OK) {
+		LOG_ERR("Failed to receive '%s' endpoint: %d", APP_GEOFENCE_HASH_ENDP, status);
+		return;
+	}
+
+	if (payload_size == 0 || payload_size >= sizeof(sbuf)) {
+		LOG_DBG("No geofence set configured");
+		return;
+	}
+
+	memcpy(sbuf, payload, payload_size);
+	sbuf[payload_size] = '\0';
+
+	char *end;
+	uint32_t hash = strtoul(sbuf, &end, 10);
+
+	if (end == sbuf) {
+		LOG_DBG("No geofence set configured");
+		return;
+	}
+
+	if (hash_valid && hash == loaded_hash) {
+		LOG_DBG("Geofence set %u already loaded", hash);
+		return;
+	}
+
+	pending_hash = hash;
+
+	int err = golioth_lightdb_get_async(client, APP_GEOFENCE_SET_ENDP,
+					    GOLIOTH_CONTENT_TYPE_CBOR, on_fence_set, NULL);
+	if (err) {
+		LOG_ERR("Unable to request geofence set: %d", err);
+	}
+}
+
+void app_geofence_flush(void)
+{
+	if (k_msgq_num_used_get(&geofence_event_msgq)) {
+		k_work_submit(&event_work);
+	}
+}
+
+int app_geofence_observe(struct golioth_client *geofence_client)
+{
+	client = geofence_client;
+
+	int err = golioth_lightdb_observe_async(client, APP_GEOFENCE_HASH_ENDP,
+						GOLIOTH_CONTENT_TYPE_JSON, on_fence_hash, NULL);
+	if (err) {
+		LOG_WRN("failed to observe lightdb path: %d", err);
+	}
+
+	return err;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * On-device geofencing.
+ *
+ * The fence set is read from the LightDB State `geofence` path:
+ *
+ * ```json
+ * {
+ *   "geofence": {
+ *     "hash": 1683872935,
+ *     "set": [
+ *       [1, 500, 43081867, -89305275],
+ *       [2, 0, 43080000, -89310000, 43080000, -89300000, 43090000, -89300000]
+ *     ]
+ *   }
+ * }
+ * ```
+ *
+ * Each fence is an array of `[id, radius_m, lat, lon, ...]` with coordinates in
+ * microdegrees. A fence with a non-zero radius is a circle centered on the
+ * single point; otherwise the points are the vertices of a polygon. The device
+ * observes `geofence/hash` and only downloads `geofence/set` when the hash
+ * differs from that of the set it has loaded. The hash is the CRC-32 of the
+ * set (see utility/geofence_hash.py); a set which does not match it, does
+ * not decode or does not fit the configured limits is rejected and the
+ * previously loaded set stays in use.
+ *
+ * Every valid fix is tested against the fences in its cell of a coarse grid
+ * index. Enter and exit events are debounced over
+ * CONFIG_APP_GEOFENCE_HYSTERESIS_FIXES consecutive fixes and streamed to the
+ * `geofence` path; events raised while offline are queued until the
+ * connection comes back.
+ */
+
+#ifndef __APP_GEOFENCE_H__
+#define __APP_GEOFENCE_H__
+
+#include <golioth/client.h>
+#include "lib/minmea/minmea.h"
+
+#define APP_GEOFENCE_ENDP      "geofence"
+#define APP_GEOFENCE_HASH_ENDP APP_GEOFENCE_ENDP "/hash"
+#define APP_GEOFENCE_SET_ENDP  APP_GEOFENCE_ENDP "/set"
+
+/** Observe the fence set hash on LightDB State */
+int app_geofence_observe(struct golioth_client *geofence_client);
+
+/**
+ * Test a fix against the loaded fence set and queue enter/exit events.
+ *
+ * Returns immediately (skipping the fix) if the fence set is being replaced.
+ *
+ * @param frame parsed RMC frame with a valid fix
+ */
+void app_geofence_evaluate(const struct minmea_sentence_rmc *frame);
+
+/** Send the events queued while offline, e.g. when the connection comes up */
+void app_geofence_flush(void);
+
+#endif /* __APP_GEOFENCE_H__ */
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_gnss, LOG_LEVEL_DBG);
+
+#include <time.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/timeutil.h>
+
+#include "app_energy.h"
+#include "app_gnss.h"
+
+#define UART_DEVICE_NODE DT_ALIAS(click_uart)
+static const struct device *const uart_dev = DEVICE_DT_GET(UART_DEVICE_NODE);
+
+#define UART_SEL DT_ALIAS(gnss7_sel)
+static const struct gpio_dt_spec gnss7_sel = GPIO_DT_SPEC_GET(UART_SEL, gpios);
+
+#define UBX_SYNC_1 0xB5
+#define UBX_SYNC_2 0x62
+
+#define UBX_CLASS_CFG  0x06
+#define UBX_ID_CFG_RST 0x04
+
+/* UBX-CFG-RST resetMode values */
+#define UBX_RST_GNSS_STOP  0x08
+#define UBX_RST_GNSS_START 0x09
+
+/* Serializes commands written to the receiver */
+K_MUTEX_DEFINE(ubx_tx_mutex);
+
+static bool gnss_running = true;
+
+static void ubx_tx_bytes(const uint8_t *data, size_t len, uint8_t *ck_a, uint8_t *ck_b)
+{
+	for (size_t i = 0; i < len; i++) {
+		uart_poll_out(uart_dev, data[i]);
+
+		if (ck_a && ck_b) {
+			/* 8-bit Fletcher checksum as defined by the UBX protocol */
+			*ck_a += data[i];
+			*ck_b += *ck_a;
+		}
+	}
+}
+
+int app_gnss_ubx_send(uint8_t msg_class, uint8_t msg_id, const uint8_t *payload, size_t len)
+{
+	if (!device_is_ready(uart_dev)) {
+		return -ENODEV;
+	}
+
+	if (len > UINT16_MAX || (len && !payload)) {
+		return -EINVAL;
+	}
+
+	const uint8_t sync[] = {UBX_SYNC_1, UBX_SYNC_2};
+	const uint8_t header[] = {msg_class, msg_id, len & 0xFF, (len >> 8) & 0xFF};
+	uint8_t ck_a = 0;
+	uint8_t ck_b = 0;
+
+	k_mutex_lock(&ubx_tx_mutex, K_FOREVER);
+
+	ubx_tx_bytes(sync, sizeof(sync), NULL, NULL);
+	ubx_tx_bytes(header, sizeof(header), &ck_a, &ck_b);
+	ubx_tx_bytes(payload, len, &ck_a, &ck_b);
+	ubx_tx_bytes((uint8_t[]){ck_a, ck_b}, 2, NULL, NULL);
+
+	k_mutex_unlock(&ubx_tx_mutex);
+
+	return 0;
+}
+
+static int gnss_reset_cmd(uint8_t reset_mode)
+{
+	/* navBbrMask 0x0000 keeps all battery-backed data (hot start) */
+	const uint8_t payload[] = {0x00, 0x00, reset_mode, 0x00};
+
+	return app_gnss_ubx_send(UBX_CLASS_CFG, UBX_ID_CFG_RST, payload, sizeof(payload));
+}
+
+int app_gnss_stop(void)
+{
+	if (!gnss_running) {
+		return 0;
+	}
+
+	int err = gnss_reset_cmd(UBX_RST_GNSS_STOP);
+
+	if (err) {
+		LOG_ERR("Unable to stop GNSS receiver: %d", err);
+		return err;
+	}
+
+	gnss_running = false;
+	app_energy_gnss_set(false);
+	LOG_INF("GNSS receiver stopped");
+
+	return 0;
+}
+
+int app_gnss_start(void)
+{
+	if (gnss_running) {
+		return 0;
+	}
+
+	int err = gnss_reset_cmd(UBX_RST_GNSS_START);
+
+	if (err) {
+		LOG_ERR("Unable to start GNSS receiver: %d", err);
+		return err;
+	}
+
+	gnss_running = true;
+	app_energy_gnss_set(true);
+	LOG_INF("GNSS receiver started");
+
+	return 0;
+}
+
+bool app_gnss_is_running(void)
+{
+	return gnss_running;
+}
+
+int32_t app_gnss_coord_udeg(const struct minmea_float *coord)
+{
+	if (coord->scale == 0) {
+		return APP_GNSS_COORD_INVALID;
+	}
+
+	/* Degrees and minutes keep the sign of the value, so they may simply be summed */
+	int32_t degrees = coord->value / (coord->scale * 100);
+	int32_t minutes = coord->value % (coord->scale * 100);
+
+	return degrees * 1000000 + (int32_t)(((int64_t)minutes * 1000000) / (coord->scale * 60));
+}
+
+struct minmea_float app_gnss_udeg_to_coord(int32_t udeg)
+{
+	/* DDDMM.MMMMM with a scale of 100000: one microdegree is 0.00006 minutes */
+	int32_t degrees = udeg / 1000000;
+	int32_t frac = udeg % 1000000;
+
+	return (struct minmea_float){.value = degrees * 10000000 + frac * 6, .scale = 100000};
+}
+
+int64_t app_gnss_rmc_unix_ms(const struct minmea_sentence_rmc *frame)
+{
+	/* minmea reports a two digit year */
+	struct tm tm = {
+		.tm_year = frame->date.year + 100,
+		.tm_mon = frame->date.month - 1,
+		.tm_mday = frame->date.day,
+		.tm_hour = frame->time.hours,
+		.tm_min = frame->time.minutes,
+		.tm_sec = frame->time.seconds,
+	};
+
+	return timeutil_timegm64(&tm) * MSEC_PER_SEC + frame->time.microseconds / USEC_PER_MSEC;
+}
+
+void app_gnss_rmc_time_set(struct minmea_sentence_rmc *frame, int64_t unix_ms)
+{
+	time_t secs = unix_ms / MSEC_PER_SEC;
+	struct tm tm;
+
+	if (!gmtime_r(&secs, &tm)) {
+		return;
+	}
+
+	frame->date.year = tm.tm_year - 100;
+	frame->date.month = tm.tm_mon + 1;
+	frame->date.day = tm.tm_mday;
+	frame->time.hours = tm.tm_hour;
+	frame->time.minutes = tm.tm_min;
+	frame->time.seconds = tm.tm_sec;
+	frame->time.microseconds = (unix_ms % MSEC_PER_SEC) * USEC_PER_MSEC;
+}
+
+int app_gnss_init(void)
+{
+	/* Select the UART interface of the GNSS 7 Click */
+	int err = gpio_pin_configure_dt(&gnss7_sel, GPIO_OUTPUT_ACTIVE);
+
+	if (err < 0) {
+		LOG_ERR("Unable to configure GNSS SEL Pin: %d", err);
+		return err;
+	}
+
+	return 0;
+}
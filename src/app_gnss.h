@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Control of the u-blox receiver on the GNSS 7 Click.
+ *
+ * The receiver streams NMEA sentences on the Click UART, which are handled in
+ * app_sensors.c. Commands sent by this module use the UBX binary protocol on
+ * the same UART.
+ */
+
+#ifndef __APP_GNSS_H__
+#define __APP_GNSS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lib/minmea/minmea.h"
+
+/** Marker returned for an empty NMEA coordinate field */
+#define APP_GNSS_COORD_INVALID INT32_MIN
+
+/**
+ * Configure the interface select pin and the UART used to send commands.
+ *
+ * @return 0 on success, negative errno otherwise
+ */
+int app_gnss_init(void);
+
+/**
+ * Stop the receiver's GNSS engine. The receiver stays powered so that it may
+ * be restarted quickly with a hot start.
+ */
+int app_gnss_stop(void);
+
+/** Restart the receiver's GNSS engine after app_gnss_stop() */
+int app_gnss_start(void);
+
+/** @return true if the GNSS engine is running */
+bool app_gnss_is_running(void);
+
+/**
+ * Send a UBX message to the receiver.
+ *
+ * @param msg_class UBX message class
+ * @param msg_id UBX message ID
+ * @param payload message payload (may be NULL if len is 0)
+ * @param len payload length in bytes
+ *
+ * @return 0 on success, negative errno otherwise
+ */
+int app_gnss_ubx_send(uint8_t msg_class, uint8_t msg_id, const uint8_t *payload, size_t len);
+
+/**
+ * Convert an NMEA coordinate (DDDMM.MMMM) to signed microdegrees without
+ * using floating point.
+ *
+ * @return microdegrees, or APP_GNSS_COORD_INVALID if the field is empty
+ */
+int32_t app_gnss_coord_udeg(const struct minmea_float *coord);
+
+/** Inverse of app_gnss_coord_udeg() */
+struct minmea_float app_gnss_udeg_to_coord(int32_t udeg);
+
+/** @return UTC time of an RMC frame in milliseconds since the Unix epoch */
+int64_t app_gnss_rmc_unix_ms(const struct minmea_sentence_rmc *frame);
+
+/** Set the date and time of an RMC frame from milliseconds since the Unix epoch */
+void app_gnss_rmc_time_set(struct minmea_sentence_rmc *frame, int64_t unix_ms);
+
+#endif /* __APP_GNSS_H__ */
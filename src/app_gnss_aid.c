@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_gnss_aid, LOG_LEVEL_DBG);
+
+#include <string.h>
+#include <time.h>
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/byteorder.h>
+
+#ifdef CONFIG_DATE_TIME
+#include <date_time.h>
+#endif
+
+#include "app_gnss.h"
+#include "app_gnss_aid.h"
+
+/* UBX-MGA-INI messages */
+#define UBX_CLASS_MGA	     0x13
+#define UBX_MGA_INI	     0x40
+#define MGA_INI_POS_LLH	     0x01
+#define MGA_INI_TIME_UTC     0x10
+#define LEAP_SECONDS_UNKNOWN -128
+
+/* Modem network time is typically within a second of UTC */
+#define NETWORK_TIME_ACC_S 2
+
+#define AID_SETTINGS_KEY    "gnss_aid/fix"
+#define AID_RECORD_VERSION  1
+#define AID_FLAG_TIME_VALID BIT(0)
+
+struct aid_record {
+	uint8_t version;
+	uint8_t flags;
+	uint16_t reserved;
+	int32_t lat_udeg;
+	int32_t lon_udeg;
+	/* UTC of the last fix, or of the save itself when AID_FLAG_TIME_VALID is set */
+	int64_t unix_ms;
+};
+
+static struct k_spinlock lock;
+
+/* Record loaded from settings at boot, then the last record saved */
+static struct aid_record stored;
+
+static struct {
+	bool valid;
+	int32_t lat_udeg;
+	int32_t lon_udeg;
+	int64_t unix_ms;
+	int64_t uptime_ms;
+} last_fix;
+
+static int64_t last_save_ms;
+static atomic_t fix_seen;
+
+static int aid_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+	const char *next;
+
+	if (!settings_name_steq(name, "fix", &next) || next) {
+		return -ENOENT;
+	}
+
+	if (len != sizeof(stored)) {
+		return -EINVAL;
+	}
+
+	ssize_t rc = read_cb(cb_arg, &stored, sizeof(stored));
+
+	if (rc < 0) {
+		return rc;
+	}
+
+	if (stored.version != AID_RECORD_VERSION) {
+		memset(&stored, 0, sizeof(stored));
+	}
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(app_gnss_aid, "gnss_aid", NULL, aid_settings_set, NULL, NULL);
+
+static int record_save(const struct aid_record *rec)
+{
+	int err = settings_save_one(AID_SETTINGS_KEY, rec, sizeof(*rec));
+
+	if (err) {
+		LOG_ERR("Unable to save GNSS aiding data: %d", err);
+		return err;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	stored = *rec;
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+static void inject_position(int32_t lat_udeg, int32_t lon_udeg)
+{
+	uint8_t payload[20] = {MGA_INI_POS_LLH};
+
+	/* Latitude and longitude in 1e-7 degrees; altitude is unknown (0) */
+	sys_put_le32((uint32_t)(lat_udeg * 10), &payload[4]);
+	sys_put_le32((uint32_t)(lon_udeg * 10), &payload[8]);
+	sys_put_le32(CONFIG_APP_GNSS_AIDING_POS_ACC_M * 100, &payload[16]);
+
+	int err = app_gnss_ubx_send(UBX_CLASS_MGA, UBX_MGA_INI, payload, sizeof(payload));
+
+	if (err) {
+		LOG_ERR("Unable to inject position: %d", err);
+	}
+}
+
+static void inject_time(int64_t unix_ms, uint16_t acc_s)
+{
+	time_t secs = unix_ms / MSEC_PER_SEC;
+	struct tm tm;
+
+	if (!gmtime_r(&secs, &tm)) {
+		return;
+	}
+
+	uint8_t payload[24] = {MGA_INI_TIME_UTC};
+
+	payload[3] = (uint8_t)LEAP_SECONDS_UNKNOWN;
+	sys_put_le16(tm.tm_year + 1900, &payload[4]);
+	payload[6] = tm.tm_mon + 1;
+	payload[7] = tm.tm_mday;
+	payload[8] = tm.tm_hour;
+	payload[9] = tm.tm_min;
+	payload[10] = tm.tm_sec;
+	sys_put_le32((unix_ms % MSEC_PER_SEC) * NSEC_PER_MSEC, &payload[12]);
+	sys_put_le16(acc_s, &payload[16]);
+
+	int err = app_gnss_ubx_send(UBX_CLASS_MGA, UBX_MGA_INI, payload, sizeof(payload));
+
+	if (err) {
+		LOG_ERR("Unable to inject time: %d", err);
+	}
+}
+
+#ifdef CONFIG_DATE_TIME
+static void date_time_handler(const struct date_time_evt *evt)
+{
+	int64_t unix_ms;
+
+	/* Aiding is pointless once the receiver has a fix */
+	if (evt->type == DATE_TIME_NOT_OBTAINED || atomic_get(&fix_seen)) {
+		return;
+	}
+
+	if (date_time_now(&unix_ms) == 0) {
+		LOG_INF("Injecting network time into GNSS receiver");
+		inject_time(unix_ms, NETWORK_TIME_ACC_S);
+	}
+}
+#endif /* CONFIG_DATE_TIME */
+
+void app_gnss_aid_inject(void)
+{
+	bool time_injected = false;
+
+#ifdef CONFIG_DATE_TIME
+	int64_t unix_ms;
+
+	/* Network time usually arrives after LTE attaches; inject it then */
+	date_time_register_handler(date_time_handler);
+
+	if (date_time_now(&unix_ms) == 0) {
+		inject_time(unix_ms, NETWORK_TIME_ACC_S);
+		time_injected = true;
+	}
+#endif /* CONFIG_DATE_TIME */
+
+	if (stored.version != AID_RECORD_VERSION) {
+		LOG_INF("No stored GNSS fix; starting without position aiding");
+		return;
+	}
+
+	LOG_INF("Injecting last known position into GNSS receiver");
+	inject_position(stored.lat_udeg, stored.lon_udeg);
+
+	if (!(stored.flags & AID_FLAG_TIME_VALID)) {
+		return;
+	}
+
+	if (!time_injected) {
+		/* The time spent rebooting is covered by the stated accuracy */
+		LOG_INF("Injecting time saved before reboot into GNSS receiver");
+		inject_time(stored.unix_ms + k_uptime_get(),
+			    CONFIG_APP_GNSS_AIDING_REBOOT_TIME_ACC_S);
+	}
+
+	/* The saved time is only meaningful for the boot right after it was saved */
+	struct aid_record rec = stored;
+
+	rec.flags &= ~AID_FLAG_TIME_VALID;
+	record_save(&rec);
+}
+
+static void save_work_handler(struct k_work *work)
+{
+	struct aid_record rec = {.version = AID_RECORD_VERSION};
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	rec.lat_udeg = last_fix.lat_udeg;
+	rec.lon_udeg = last_fix.lon_udeg;
+	rec.unix_ms = last_fix.unix_ms;
+	k_spin_unlock(&lock, key);
+
+	if (record_save(&rec) == 0) {
+		LOG_DBG("Saved GNSS fix for aiding");
+	}
+}
+
+static K_WORK_DEFINE(save_work, save_work_handler);
+
+void app_gnss_aid_fix_update(const struct minmea_sentence_rmc *frame)
+{
+	int32_t lat_udeg = app_gnss_coord_udeg(&frame->latitude);
+	int32_t lon_udeg = app_gnss_coord_udeg(&frame->longitude);
+
+	if (lat_udeg == APP_GNSS_COORD_INVALID || lon_udeg == APP_GNSS_COORD_INVALID) {
+		return;
+	}
+
+	int64_t now = k_uptime_get();
+	int64_t unix_ms = app_gnss_rmc_unix_ms(frame);
+	bool save_due;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	last_fix.valid = true;
+	last_fix.lat_udeg = lat_udeg;
+	last_fix.lon_udeg = lon_udeg;
+	last_fix.unix_ms = unix_ms;
+	last_fix.uptime_ms = now;
+
+	save_due = (last_save_ms == 0) ||
+		   (now - last_save_ms >= CONFIG_APP_GNSS_AIDING_SAVE_INTERVAL_S * MSEC_PER_SEC);
+	if (save_due) {
+		last_save_ms = now;
+	}
+	k_spin_unlock(&lock, key);
+
+	atomic_set(&fix_seen, 1);
+
+	if (save_due) {
+		k_work_submit(&save_work);
+	}
+}
+
+int app_gnss_aid_save(void)
+{
+	struct aid_record rec = {
+		.version = AID_RECORD_VERSION,
+		.flags = AID_FLAG_TIME_VALID,
+	};
+	bool have_time = false;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (last_fix.valid) {
+		rec.lat_udeg = last_fix.lat_udeg;
+		rec.lon_udeg = last_fix.lon_udeg;
+		rec.unix_ms = last_fix.unix_ms + (k_uptime_get() - last_fix.uptime_ms);
+		have_time = true;
+	} else if (stored.version == AID_RECORD_VERSION) {
+		/* No fix since boot; keep the stored position */
+		rec.lat_udeg = stored.lat_udeg;
+		rec.lon_udeg = stored.lon_udeg;
+		rec.unix_ms = stored.unix_ms;
+	} else {
+		k_spin_unlock(&lock, key);
+		return -ENODATA;
+	}
+	k_spin_unlock(&lock, key);
+
+#ifdef CONFIG_DATE_TIME
+	if (!have_time) {
+		have_time = (date_time_now(&rec.unix_ms) == 0);
+	}
+#endif /* CONFIG_DATE_TIME */
+
+	if (!have_time) {
+		rec.flags = 0;
+	}
+
+	return record_save(&rec);
+}
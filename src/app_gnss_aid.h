@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * GNSS start-up aiding.
+ *
+ * The last valid fix is kept in the settings subsystem. At boot it is injected
+ * into the receiver (UBX-MGA-INI) as an approximate position, together with
+ * the UTC time when one is known: either network time from the modem, or the
+ * time saved by app_gnss_aid_save() right before a planned reboot.
+ */
+
+#ifndef __APP_GNSS_AID_H__
+#define __APP_GNSS_AID_H__
+
+#include "lib/minmea/minmea.h"
+
+#ifdef CONFIG_APP_GNSS_AIDING
+
+/**
+ * Send the persisted position and the best known time to the receiver. Must be
+ * called after app_gnss_init() and after settings have been loaded.
+ */
+void app_gnss_aid_inject(void);
+
+/**
+ * Record a valid fix. It is persisted at most once every
+ * CONFIG_APP_GNSS_AIDING_SAVE_INTERVAL_S to limit flash wear.
+ */
+void app_gnss_aid_fix_update(const struct minmea_sentence_rmc *frame);
+
+/**
+ * Persist the last fix and the current UTC time immediately. Call right before
+ * a planned reboot so the time can be injected on the next boot.
+ *
+ * @return 0 on success, negative errno otherwise
+ */
+int app_gnss_aid_save(void);
+
+#else
+
+static inline void app_gnss_aid_inject(void)
+{
+}
+
+static inline void app_gnss_aid_fix_update(const struct minmea_sentence_rmc *frame)
+{
+}
+
+static inline int app_gnss_aid_save(void)
+{
+	return 0;
+}
+
+#endif /* CONFIG_APP_GNSS_AIDING */
+
+#endif /* __APP_GNSS_AID_H__ */
@@ -0,0 +1,468 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_history, LOG_LEVEL_DBG);
+
+#include <golioth/stream.h>
+#include <string.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+
+#include "app_history.h"
+
+#define HISTORY_PARTITION_ID FIXED_PARTITION_ID(history_storage)
+#define HISTORY_ENDP	     "history"
+
+#define HISTORY_MAGIC	0x54534948 /* "HIST" */
+#define HISTORY_VERSION 1
+
+/* Upper bound on sectors in the partition, for the RAM index */
+#define MAX_SECTORS 64
+
+/* Read back from an erased record slot */
+#define ERASED_MS (-1LL)
+
+/* Encoded size of one record: array header and six integers */
+#define RECORD_CBOR_SIZE (1 + 6 * 9)
+#define CHUNK_BUF_SIZE	 (CONFIG_APP_HISTORY_CHUNK_RECORDS * RECORD_CBOR_SIZE + 64)
+
+#define CHUNK_RETRY_DELAY K_SECONDS(10)
+#define CHUNK_RETRIES	  3
+
+struct sector_header {
+	uint32_t magic;
+	uint32_t seq;
+	uint16_t record_size;
+	uint8_t version;
+	uint8_t reserved[5];
+};
+
+#define RECORDS_OFFSET sizeof(struct sector_header)
+
+struct sector_index {
+	bool valid;
+	uint32_t seq;
+	uint16_t count;
+	int64_t first_ms;
+	int64_t last_ms;
+};
+
+static const struct flash_area *fa;
+static size_t sector_size;
+static size_t sector_count;
+static size_t per_sector;
+static struct sector_index sectors[MAX_SECTORS];
+
+/* Sector being written, or -1 before the first record */
+static int head = -1;
+
+static K_MUTEX_DEFINE(history_mutex);
+
+/*
+ * Records are addressed by position: sector sequence number * per_sector +
+ * slot. Positions stay valid while records are appended, and a sector which
+ * has been recycled simply no longer holds the positions of its old number.
+ */
+static struct {
+	bool active;
+	uint32_t id;
+	uint64_t next;
+	uint64_t end;
+	uint32_t stride;
+	uint32_t chunk;
+	uint64_t chunk_end;
+	uint8_t retries;
+} job;
+
+static uint32_t next_job_id;
+static struct golioth_client *history_client;
+
+static void chunk_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(chunk_work, chunk_work_handler);
+
+static off_t slot_offset(size_t sector, size_t slot)
+{
+	return sector * sector_size + RECORDS_OFFSET + slot * sizeof(struct app_backlog_record);
+}
+
+static int record_read(size_t sector, size_t slot, struct app_backlog_record *rec)
+{
+	return flash_area_read(fa, slot_offset(sector, slot), rec, sizeof(*rec));
+}
+
+static int64_t record_ms(size_t sector, size_t slot)
+{
+	struct app_backlog_record rec;
+
+	return record_read(sector, slot, &rec) ? ERASED_MS : rec.unix_ms;
+}
+
+static void sector_scan(size_t s)
+{
+	struct sector_header hdr;
+	struct sector_index *idx = &sectors[s];
+	size_t lo = 0;
+	size_t hi = per_sector;
+
+	memset(idx, 0, sizeof(*idx));
+
+	if (flash_area_read(fa, s * sector_size, &hdr, sizeof(hdr)) ||
+	    hdr.magic != HISTORY_MAGIC || hdr.version != HISTORY_VERSION ||
+	    hdr.record_size != sizeof(struct app_backlog_record)) {
+		return;
+	}
+
+	/* Slots are filled in order; find the first erased one */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (record_ms(s, mid) == ERASED_MS) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	idx->valid = true;
+	idx->seq = hdr.seq;
+	idx->count = lo;
+
+	if (lo) {
+		idx->first_ms = record_ms(s, 0);
+		idx->last_ms = record_ms(s, lo - 1);
+	}
+}
+
+static int sector_open(size_t s, uint32_t seq)
+{
+	struct sector_header hdr = {
+		.magic = HISTORY_MAGIC,
+		.seq = seq,
+		.record_size = sizeof(struct app_backlog_record),
+		.version = HISTORY_VERSION,
+	};
+	int err = flash_area_erase(fa, s * sector_size, sector_size);
+
+	if (!err) {
+		err = flash_area_write(fa, s * sector_size, &hdr, sizeof(hdr));
+	}
+
+	if (err) {
+		LOG_ERR("Unable to open history sector %zu: %d", s, err);
+		sectors[s].valid = false;
+		return err;
+	}
+
+	sectors[s] = (struct sector_index){.valid = true, .seq = seq};
+	head = s;
+
+	return 0;
+}
+
+/* Sector holding sequence number seq, or -1 if it has been recycled */
+static int sector_of_seq(uint32_t seq)
+{
+	uint32_t head_seq = sectors[head].seq;
+
+	if (seq > head_seq || head_seq - seq >= sector_count) {
+		return -1;
+	}
+
+	int s = (head + sector_count - (head_seq - seq)) % sector_count;
+
+	return (sectors[s].valid && sectors[s].seq == seq) ? s : -1;
+}
+
+/* Valid sectors from oldest to newest */
+static size_t sectors_ordered(uint8_t order[MAX_SECTORS])
+{
+	size_t n = 0;
+
+	for (size_t i = 1; i <= sector_count; i++) {
+		size_t s = (head + i) % sector_count;
+
+		if (sectors[s].valid) {
+			order[n++] = s;
+		}
+	}
+
+	return n;
+}
+
+static bool time_passed(int64_t record_ms, int64_t t, bool after)
+{
+	return after ? (record_ms > t) : (record_ms >= t);
+}
+
+/* First position whose time is >= t, or > t if after is set. Reads O(log n) records. */
+static uint64_t position_find(int64_t t, bool after)
+{
+	uint8_t order[MAX_SECTORS];
+	size_t n = sectors_ordered(order);
+	size_t lo = 0;
+	size_t hi = n;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		const struct sector_index *idx = &sectors[order[mid]];
+
+		if (idx->count && time_passed(idx->last_ms, t, after)) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	if (lo == n) {
+		return (uint64_t)sectors[head].seq * per_sector + sectors[head].count;
+	}
+
+	size_t s = order[lo];
+
+	hi = sectors[s].count;
+	lo = 0;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (time_passed(record_ms(s, mid), t, after)) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	return (uint64_t)sectors[s].seq * per_sector + lo;
+}
+
+int app_history_init(void)
+{
+	struct flash_pages_info info;
+	int err = flash_area_open(HISTORY_PARTITION_ID, &fa);
+
+	if (err) {
+		LOG_ERR("Unable to open history partition: %d", err);
+		return err;
+	}
+
+	err = flash_get_page_info_by_offs(flash_area_get_device(fa), fa->fa_off, &info);
+	if (err) {
+		LOG_ERR("Unable to get history sector size: %d", err);
+		return err;
+	}
+
+	sector_size = info.size;
+	sector_count = MIN(fa->fa_size / sector_size, MAX_SECTORS);
+	per_sector = (sector_size - RECORDS_OFFSET) / sizeof(struct app_backlog_record);
+
+	if (sector_count < 2) {
+		LOG_ERR("History partition needs at least two sectors");
+		fa = NULL;
+		return -ENOSPC;
+	}
+
+	for (size_t s = 0; s < sector_count; s++) {
+		sector_scan(s);
+
+		if (sectors[s].valid && (head < 0 || sectors[s].seq > sectors[head].seq)) {
+			head = s;
+		}
+	}
+
+	LOG_INF("History: %zu sectors of %zu records, newest sequence %d", sector_count,
+		per_sector, head < 0 ? -1 : (int)sectors[head].seq);
+
+	return 0;
+}
+
+int app_history_append(const struct app_backlog_record *rec)
+{
+	int err = 0;
+
+	if (!fa) {
+		return -EBADF;
+	}
+
+	k_mutex_lock(&history_mutex, K_FOREVER);
+
+	if (head < 0) {
+		err = sector_open(0, 0);
+	} else if (sectors[head].count == per_sector) {
+		/* Recycle the oldest sector */
+		err = sector_open((head + 1) % sector_count, sectors[head].seq + 1);
+	}
+
+	if (!err) {
+		struct sector_index *idx = &sectors[head];
+
+		err = flash_area_write(fa, slot_offset(head, idx->count), rec, sizeof(*rec));
+		if (!err) {
+			if (idx->count == 0) {
+				idx->first_ms = rec->unix_ms;
+			}
+			idx->last_ms = rec->unix_ms;
+			idx->count++;
+		}
+	}
+
+	k_mutex_unlock(&history_mutex);
+
+	if (err) {
+		LOG_ERR("Unable to append to history: %d", err);
+	}
+
+	return err;
+}
+
+static bool chunk_encode(zcbor_state_t *zse, uint64_t *pos_out)
+{
+	uint64_t pos = job.next;
+	size_t n = 0;
+	bool ok = zcbor_map_start_encode(zse, 4) && zcbor_tstr_put_lit(zse, "id") &&
+		  zcbor_uint32_put(zse, job.id) && zcbor_tstr_put_lit(zse, "chunk") &&
+		  zcbor_uint32_put(zse, job.chunk) && zcbor_tstr_put_lit(zse, "r") &&
+		  zcbor_list_start_encode(zse, CONFIG_APP_HISTORY_CHUNK_RECORDS);
+
+	k_mutex_lock(&history_mutex, K_FOREVER);
+
+	for (; ok && pos < job.end && n < CONFIG_APP_HISTORY_CHUNK_RECORDS; pos += job.stride) {
+		int s = sector_of_seq(pos / per_sector);
+		struct app_backlog_record rec;
+
+		/* Skip records recycled since the fetch started */
+		if (s < 0 || record_read(s, pos % per_sector, &rec)) {
+			continue;
+		}
+
+		ok = zcbor_list_start_encode(zse, 6) && zcbor_int64_put(zse, rec.unix_ms) &&
+		     zcbor_int32_put(zse, rec.lat_udeg) && zcbor_int32_put(zse, rec.lon_udeg) &&
+		     zcbor_int32_put(zse, rec.tem_centi) && zcbor_int32_put(zse, rec.hum_centi) &&
+		     zcbor_int32_put(zse, rec.pre_pa) && zcbor_list_end_encode(zse, 6);
+		n++;
+	}
+
+	k_mutex_unlock(&history_mutex);
+
+	*pos_out = pos;
+
+	return ok && zcbor_list_end_encode(zse, CONFIG_APP_HISTORY_CHUNK_RECORDS) &&
+	       zcbor_tstr_put_lit(zse, "last") && zcbor_bool_put(zse, pos >= job.end) &&
+	       zcbor_map_end_encode(zse, 4);
+}
+
+static void chunk_sent(struct golioth_client *client, enum golioth_status status,
+		       const struct golioth_coap_rsp_code *coap_rsp_code, const char *path,
+		       void *arg)
+{
+	if (status != GOLIOTH_OK) {
+		if (++job.retries > CHUNK_RETRIES) {
+			LOG_ERR("Giving up history fetch %u at chunk %u", job.id, job.chunk);
+			job.active = false;
+			return;
+		}
+
+		k_work_schedule(&chunk_work, CHUNK_RETRY_DELAY);
+		return;
+	}
+
+	job.next = job.chunk_end;
+	job.chunk++;
+	job.retries = 0;
+
+	if (job.next >= job.end) {
+		LOG_INF("History fetch %u sent in %u chunks", job.id, job.chunk);
+		job.active = false;
+		return;
+	}
+
+	k_work_schedule(&chunk_work, K_NO_WAIT);
+}
+
+static void chunk_work_handler(struct k_work *work)
+{
+	/* Only one chunk is in flight, so the buffer is free again when this runs */
+	static uint8_t buf[CHUNK_BUF_SIZE];
+	ZCBOR_STATE_E(zse, 3, buf, sizeof(buf), 1);
+
+	if (!chunk_encode(zse, &job.chunk_end)) {
+		LOG_ERR("History chunk does not fit in %d bytes", CHUNK_BUF_SIZE);
+		job.active = false;
+		return;
+	}
+
+	int err = golioth_stream_set_async(history_client, HISTORY_ENDP,
+					   GOLIOTH_CONTENT_TYPE_CBOR, buf, zse->payload - buf,
+					   chunk_sent, NULL);
+
+	if (err) {
+		chunk_sent(history_client, GOLIOTH_ERR_FAIL, NULL, HISTORY_ENDP, NULL);
+	}
+}
+
+void app_history_set_client(struct golioth_client *client)
+{
+	history_client = client;
+}
+
+int app_history_fetch(int64_t start_ms, int64_t end_ms, uint32_t max_points,
+		      zcbor_state_t *response_detail_map)
+{
+	uint64_t start, end;
+
+	if (!fa || !history_client) {
+		return -ENODEV;
+	}
+
+	if (start_ms > end_ms || max_points == 0) {
+		return -EINVAL;
+	}
+
+	if (job.active) {
+		return -EBUSY;
+	}
+
+	k_mutex_lock(&history_mutex, K_FOREVER);
+
+	if (head < 0) {
+		start = end = 0;
+	} else {
+		start = position_find(start_ms, false);
+		end = position_find(end_ms, true);
+	}
+
+	k_mutex_unlock(&history_mutex);
+
+	uint64_t matched = (end > start) ? end - start : 0;
+	uint32_t stride = (matched > max_points) ? DIV_ROUND_UP(matched, max_points) : 1;
+	uint32_t points = DIV_ROUND_UP(matched, stride);
+
+	job = (typeof(job)){
+		.active = matched > 0,
+		.id = next_job_id++,
+		.next = start,
+		.end = end,
+		.stride = stride,
+	};
+
+	bool ok = zcbor_tstr_put_lit(response_detail_map, "id") &&
+		  zcbor_uint32_put(response_detail_map, job.id) &&
+		  zcbor_tstr_put_lit(response_detail_map, "matched") &&
+		  zcbor_uint64_put(response_detail_map, matched) &&
+		  zcbor_tstr_put_lit(response_detail_map, "stride") &&
+		  zcbor_uint32_put(response_detail_map, stride) &&
+		  zcbor_tstr_put_lit(response_detail_map, "points") &&
+		  zcbor_uint32_put(response_detail_map, points);
+
+	if (job.active) {
+		LOG_INF("History fetch %u: %llu records, sending %u", job.id,
+			(unsigned long long)matched, points);
+		k_work_schedule(&chunk_work, K_NO_WAIT);
+	}
+
+	return ok ? 0 : -ENOMEM;
+}
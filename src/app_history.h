@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * On-device reading history in the history_storage flash partition.
+ *
+ * Every stored reading is appended to a ring of flash sectors, whether or not
+ * it is uploaded later, so the exact record can be fetched after a dispute.
+ * Each sector starts with a header holding its sequence number; a RAM index
+ * keeps the first and last timestamp of every sector. A time range is located
+ * with a binary search over the index and then over the records of the first
+ * and last sector, so a query reads O(log n) records. The matching records
+ * are then streamed to the "history" path in chunks, optionally decimated.
+ *
+ * Records are assumed to be appended in time order, which holds for GNSS time.
+ */
+
+#ifndef __APP_HISTORY_H__
+#define __APP_HISTORY_H__
+
+#include <errno.h>
+#include <stdint.h>
+#include <golioth/client.h>
+#include <zcbor_encode.h>
+
+#include "app_backlog.h"
+
+#ifdef CONFIG_APP_HISTORY
+
+/** Open the partition and rebuild the sector index */
+int app_history_init(void);
+
+/** Append a reading; the oldest sector is erased when the ring is full */
+int app_history_append(const struct app_backlog_record *rec);
+
+/** Stream fetched records with this client */
+void app_history_set_client(struct golioth_client *client);
+
+/**
+ * Start streaming the records between start_ms and end_ms (inclusive, Unix
+ * time), at most max_points of them, evenly decimated. Adds the request ID,
+ * number of matching records, decimation stride and number of points to be
+ * sent to an RPC response map.
+ *
+ * @return 0 on success, -EBUSY while a previous fetch is being sent,
+ *	   -EINVAL for an invalid range, -ENOMEM if the map is full
+ */
+int app_history_fetch(int64_t start_ms, int64_t end_ms, uint32_t max_points,
+		      zcbor_state_t *response_detail_map);
+
+#else
+
+static inline int app_history_init(void)
+{
+	return 0;
+}
+
+static inline int app_history_append(const struct app_backlog_record *rec)
+{
+	return 0;
+}
+
+static inline void app_history_set_client(struct golioth_client *client)
+{
+}
+
+static inline int app_history_fetch(int64_t start_ms, int64_t end_ms, uint32_t max_points,
+				    zcbor_state_t *response_detail_map)
+{
+	return -ENOTSUP;
+}
+
+#endif /* CONFIG_APP_HISTORY */
+
+#endif /* __APP_HISTORY_H__ */
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_live_track, LOG_LEVEL_DBG);
+
+#include <golioth/stream.h>
+#include <zephyr/kernel.h>
+
+#include "app_gnss.h"
+#include "app_live_track.h"
+#include "app_metrics.h"
+#include "app_payloads.h"
+#include "app_workq.h"
+
+#define LIVE_TRACK_ENDP "live_track"
+
+struct live_stats {
+	uint32_t fixes;
+	uint32_t acked;
+	uint32_t failed;
+	uint32_t latency_min_ms;
+	uint32_t latency_max_ms;
+	uint64_t latency_sum_ms;
+};
+
+static struct golioth_client *live_client;
+
+/* Interval of the session in progress, 0 if none */
+static atomic_t session_interval_s;
+static int64_t session_end_ms;
+
+static struct k_spinlock stats_lock;
+static struct live_stats stats;
+
+static void expire_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(expire_work, expire_work_handler);
+
+static void stats_get(struct live_stats *s)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*s = stats;
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats = (struct live_stats){.latency_min_ms = UINT32_MAX};
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+/* Fixes streamed and the latency from fix to acknowledgement */
+static void status_get(struct app_live_track_status *st)
+{
+	struct live_stats s;
+
+	stats_get(&s);
+
+	st->fixes = s.fixes;
+	st->acked = s.acked;
+	st->failed = s.failed;
+	st->latency_min_ms = s.acked ? s.latency_min_ms : 0;
+	st->latency_avg_ms = s.acked ? s.latency_sum_ms / s.acked : 0;
+	st->latency_max_ms = s.latency_max_ms;
+}
+
+static void session_end(void)
+{
+	/* Session reports are minutes apart, so the last one has long been sent */
+	static uint8_t buf[APP_CODEC_CBOR_MAX(APP_LIVE_TRACK_STATUS_FIELDS)];
+	struct app_live_track_status st;
+	uint32_t mask = APP_CODEC_ALL & ~(BIT(APP_LIVE_TRACK_STATUS_interval_s) |
+					  BIT(APP_LIVE_TRACK_STATUS_remaining_s));
+
+	if (atomic_set(&session_interval_s, 0) == 0) {
+		return;
+	}
+
+	status_get(&st);
+
+	LOG_INF("Live tracking ended: %u fixes streamed, %u acked, %u queued instead; "
+		"latency %u/%u/%u ms (min/avg/max)",
+		st.fixes, st.acked, st.failed, st.latency_min_ms, st.latency_avg_ms,
+		st.latency_max_ms);
+
+	if (!live_client || !golioth_client_is_connected(live_client)) {
+		return;
+	}
+
+	int len = app_codec_cbor_encode(&app_live_track_status_schema, &st, mask, buf,
+					sizeof(buf));
+	int err = len < 0 ? len
+			  : golioth_stream_set_async(live_client, LIVE_TRACK_ENDP,
+						     GOLIOTH_CONTENT_TYPE_CBOR, buf, len, NULL,
+						     NULL);
+
+	if (err) {
+		LOG_ERR("Failed to stream live tracking report: %d", err);
+	}
+}
+
+static void expire_work_handler(struct k_work *work)
+{
+	app_metrics_inc(APP_METRICS_WORKQ_RUNS);
+
+	session_end();
+}
+
+void app_live_track_set_client(struct golioth_client *client)
+{
+	live_client = client;
+}
+
+int app_live_track_start(uint32_t duration_s, uint32_t interval_s,
+			 zcbor_state_t *response_detail_map)
+{
+	if (duration_s > CONFIG_APP_LIVE_TRACK_MAX_DURATION_S ||
+	    !IN_RANGE(interval_s, 1, CONFIG_APP_LIVE_TRACK_MAX_INTERVAL_S)) {
+		return -EINVAL;
+	}
+
+	if (duration_s == 0) {
+		k_work_cancel_delayable(&expire_work);
+		session_end();
+	} else {
+		if (atomic_get(&session_interval_s) == 0) {
+			stats_reset();
+			LOG_INF("Live tracking for %u s, a reading every %u s", duration_s,
+				interval_s);
+		}
+
+		session_end_ms = k_uptime_get() + duration_s * MSEC_PER_SEC;
+		atomic_set(&session_interval_s, interval_s);
+
+		/* The cadence may have put the receiver to sleep while stationary */
+		app_gnss_start();
+
+		k_work_reschedule_for_queue(&app_work_q, &expire_work, K_SECONDS(duration_s));
+	}
+
+	struct app_live_track_status st;
+	int64_t remaining_ms;
+
+	st.interval_s = atomic_get(&session_interval_s);
+	remaining_ms = st.interval_s ? MAX(session_end_ms - k_uptime_get(), 0) : 0;
+	st.remaining_s = remaining_ms / MSEC_PER_SEC;
+	status_get(&st);
+
+	return app_codec_cbor_map_put(&app_live_track_status_schema, &st, APP_CODEC_ALL,
+				      response_detail_map);
+}
+
+uint32_t app_live_track_interval_s(void)
+{
+	return atomic_get(&session_interval_s);
+}
+
+void app_live_track_fix_sent(uint32_t rx_ms, bool acked)
+{
+	uint32_t latency_ms = k_uptime_get_32() - rx_ms;
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats.fixes++;
+
+	if (acked) {
+		stats.acked++;
+		stats.latency_min_ms = MIN(stats.latency_min_ms, latency_ms);
+		stats.latency_max_ms = MAX(stats.latency_max_ms, latency_ms);
+		stats.latency_sum_ms += latency_ms;
+	} else {
+		stats.failed++;
+	}
+
+	k_spin_unlock(&stats_lock, key);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Live tracking sessions.
+ *
+ * The `live_track` RPC stores a reading every interval_s for duration_s,
+ * whatever GPS_DELAY_S, the motion-adaptive cadence and the power profile
+ * say, and each reading is streamed as soon as it is taken instead of being
+ * batched. When the session expires the configured cadence applies again;
+ * the settings are never touched, and a reboot ends the session too. The time
+ * from the fix leaving the GNSS receiver to the cloud acknowledging it is
+ * reported by the RPC during the session, and logged and streamed to the
+ * "live_track" path when it ends.
+ */
+
+#ifndef __APP_LIVE_TRACK_H__
+#define __APP_LIVE_TRACK_H__
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <golioth/client.h>
+#include <zcbor_encode.h>
+
+#ifdef CONFIG_APP_LIVE_TRACK
+
+/** Stream session reports with this client */
+void app_live_track_set_client(struct golioth_client *client);
+
+/**
+ * Start a session, or change the one in progress, and add its state to an
+ * RPC response map. A duration of 0 ends the session in progress.
+ *
+ * @return 0 on success, -EINVAL for an invalid duration or interval, -ENOMEM
+ *	   if the map is full
+ */
+int app_live_track_start(uint32_t duration_s, uint32_t interval_s,
+			 zcbor_state_t *response_detail_map);
+
+/** @return the interval (seconds) between readings of the session, 0 if none */
+uint32_t app_live_track_interval_s(void);
+
+/**
+ * Account a reading streamed during a session.
+ *
+ * @param rx_ms uptime (ms) when the fix was received from the GNSS receiver
+ * @param acked whether the cloud acknowledged it; otherwise it goes in the
+ *		upload queue
+ */
+void app_live_track_fix_sent(uint32_t rx_ms, bool acked);
+
+#else
+
+static inline void app_live_track_set_client(struct golioth_client *client)
+{
+}
+
+static inline int app_live_track_start(uint32_t duration_s, uint32_t interval_s,
+				       zcbor_state_t *response_detail_map)
+{
+	return -ENOTSUP;
+}
+
+static inline uint32_t app_live_track_interval_s(void)
+{
+	return 0;
+}
+
+static inline void app_live_track_fix_sent(uint32_t rx_ms, bool acked)
+{
+}
+
+#endif /* CONFIG_APP_LIVE_TRACK */
+
+#endif /* __APP_LIVE_TRACK_H__ */
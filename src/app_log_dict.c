@@ -0,0 +1,441 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_log_dict, LOG_LEVEL_DBG);
+
+#include <golioth/stream.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log_backend.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/logging/log_output.h>
+#include <zephyr/logging/log_output_dict.h>
+#include <zephyr/sys/crc.h>
+
+#include "app_log_dict.h"
+#include "app_ram.h"
+
+#define LOG_DICT_ENDP "logs_dict"
+
+/* Encoded size of a batch around its records */
+#define FRAME_OVERHEAD 128
+
+/* Distinct modules whose suppressed repeats are listed in one batch */
+#define MAX_REPEAT_ENTRIES 8
+
+/* Largest dictionary record of a single message */
+#define MSG_BUF_SIZE 256
+
+/*
+ * Estimated bytes on the wire around each message sent by the Golioth text
+ * backend, which posts every message on its own to the logs service: the
+ * CBOR map keys and headers around the text (36), the CoAP header, token,
+ * Uri-Path and Content-Format options (20) and the DTLS record header,
+ * explicit nonce and AES-CCM-8 tag (29). IP and UDP headers are left out of
+ * both sides of the comparison.
+ */
+#define TEXT_MSG_WIRE_OVERHEAD 85
+
+/* The same around each batch of this backend: CoAP for .s/logs_dict and DTLS */
+#define BATCH_WIRE_OVERHEAD 57
+
+enum log_dict_stat {
+	STAT_MESSAGES,		/* messages given to the backend */
+	STAT_SENT,		/* records added to a batch */
+	STAT_RATE_LIMITED,	/* dropped by the per-module rate limit */
+	STAT_REPEATS,		/* repeats of the previous message of a module */
+	STAT_OVERFLOW,		/* dropped, batch buffer full or record too large */
+	STAT_CORE_DROPPED,	/* dropped by the logging core before the backend */
+	STAT_BATCHES,
+	STAT_BATCH_FAILED,
+	STAT_BATCH_BYTES,	/* encoded batches handed to the Golioth client */
+	STAT_DICT_BYTES,	/* record bytes */
+	STAT_DICT_CYCLES,	/* filtering and dictionary encoding */
+	STAT_TEXT_BYTES,	/* the same messages formatted as text */
+	STAT_TEXT_CYCLES,	/* text formatting */
+	STAT_COUNT
+};
+
+static const char *const stat_names[STAT_COUNT] = {
+	[STAT_MESSAGES] = "messages",
+	[STAT_SENT] = "sent",
+	[STAT_RATE_LIMITED] = "rate_limited",
+	[STAT_REPEATS] = "repeats",
+	[STAT_OVERFLOW] = "overflow",
+	[STAT_CORE_DROPPED] = "core_dropped",
+	[STAT_BATCHES] = "batches",
+	[STAT_BATCH_FAILED] = "batch_failed",
+	[STAT_BATCH_BYTES] = "batch_bytes",
+	[STAT_DICT_BYTES] = "dict_bytes",
+	[STAT_DICT_CYCLES] = "dict_cycles",
+	[STAT_TEXT_BYTES] = "text_bytes",
+	[STAT_TEXT_CYCLES] = "text_cycles",
+};
+
+struct source_state {
+	uint32_t last_crc;
+	uint32_t repeats;
+	int64_t refill_ms;
+	uint16_t tokens;
+};
+
+struct repeat_entry {
+	uint16_t source;
+	uint32_t count;
+};
+
+static struct source_state sources[CONFIG_APP_LOG_DICT_MAX_SOURCES];
+
+/* Records waiting to be sent, and suppressed repeats since the last batch */
+static uint8_t records[CONFIG_APP_LOG_DICT_BUF_SIZE];
+static size_t records_len;
+static size_t records_peak;
+static struct repeat_entry repeats[MAX_REPEAT_ENTRIES];
+static size_t repeats_len;
+static uint32_t batch_seq;
+/* 64-bit, so only read or written with lock held */
+static uint64_t stats[STAT_COUNT];
+static struct k_spinlock lock;
+
+/* Dictionary record of the message being processed */
+static uint8_t msg_buf[MSG_BUF_SIZE];
+static size_t msg_len;
+static bool msg_truncated;
+
+static struct golioth_client *log_client;
+
+static void stat_add(enum log_dict_stat stat, uint64_t value)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	stats[stat] += value;
+	k_spin_unlock(&lock, key);
+}
+
+static void flush_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_handler);
+
+static int dict_out(uint8_t *data, size_t length, void *ctx)
+{
+	if (msg_len + length > sizeof(msg_buf)) {
+		msg_truncated = true;
+	} else {
+		memcpy(&msg_buf[msg_len], data, length);
+		msg_len += length;
+	}
+
+	return length;
+}
+
+static uint8_t dict_out_buf[64];
+LOG_OUTPUT_DEFINE(log_output_dict, dict_out, dict_out_buf, sizeof(dict_out_buf));
+
+#ifdef CONFIG_APP_LOG_DICT_COMPARE
+/* Text bytes of the message being processed */
+static size_t text_len;
+
+static int text_out(uint8_t *data, size_t length, void *ctx)
+{
+	text_len += length;
+
+	return length;
+}
+
+static uint8_t text_out_buf[128];
+LOG_OUTPUT_DEFINE(log_output_text, text_out, text_out_buf, sizeof(text_out_buf));
+#endif
+
+static int16_t msg_source_id(struct log_msg *msg)
+{
+	const void *source = log_msg_get_source(msg);
+
+	if (!source) {
+		return -1;
+	}
+
+	return IS_ENABLED(CONFIG_LOG_RUNTIME_FILTERING)
+		       ? log_dynamic_source_id((struct log_source_dynamic_data *)source)
+		       : log_const_source_id((const struct log_source_const_data *)source);
+}
+
+static bool rate_limit_pass(struct source_state *src, uint8_t level)
+{
+	int64_t now = k_uptime_get();
+	uint32_t refill = ((now - src->refill_ms) * CONFIG_APP_LOG_DICT_RATE_PER_S) / MSEC_PER_SEC;
+
+	if (refill) {
+		src->tokens = MIN(src->tokens + refill, CONFIG_APP_LOG_DICT_BURST);
+		src->refill_ms = now;
+	}
+
+	/* Errors are never rate limited */
+	if (level == LOG_LEVEL_ERR) {
+		return true;
+	}
+
+	if (src->tokens == 0) {
+		return false;
+	}
+
+	src->tokens--;
+	return true;
+}
+
+static void repeats_record(int16_t source, uint32_t count)
+{
+	for (size_t i = 0; i < repeats_len; i++) {
+		if (repeats[i].source == source) {
+			repeats[i].count += count;
+			return;
+		}
+	}
+
+	if (repeats_len < ARRAY_SIZE(repeats)) {
+		repeats[repeats_len++] = (struct repeat_entry){.source = source, .count = count};
+	}
+}
+
+/* Called by the log processing thread only, so the source table needs no lock */
+static bool msg_filter(struct log_msg *msg)
+{
+	int16_t id = msg_source_id(msg);
+	uint8_t level = log_msg_get_level(msg);
+
+	if (id < 0 || id >= ARRAY_SIZE(sources)) {
+		return true;
+	}
+
+	struct source_state *src = &sources[id];
+	size_t pkg_len;
+	uint8_t *pkg = log_msg_get_package(msg, &pkg_len);
+	uint32_t crc = crc32_ieee_update(crc32_ieee(&level, sizeof(level)), pkg, pkg_len);
+
+	if (crc == src->last_crc) {
+		src->repeats++;
+		stat_add(STAT_REPEATS, 1);
+		return false;
+	}
+
+	if (src->repeats) {
+		k_spinlock_key_t key = k_spin_lock(&lock);
+
+		repeats_record(id, src->repeats);
+		k_spin_unlock(&lock, key);
+		src->repeats = 0;
+	}
+
+	src->last_crc = crc;
+
+	if (!rate_limit_pass(src, level)) {
+		stat_add(STAT_RATE_LIMITED, 1);
+		return false;
+	}
+
+	return true;
+}
+
+static void msg_commit(void)
+{
+	bool flush_now = false;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (msg_truncated || records_len + msg_len > sizeof(records)) {
+		stats[STAT_OVERFLOW]++;
+	} else {
+		memcpy(&records[records_len], msg_buf, msg_len);
+		records_len += msg_len;
+		records_peak = MAX(records_peak, records_len);
+		stats[STAT_SENT]++;
+		stats[STAT_DICT_BYTES] += msg_len;
+		flush_now = records_len > (sizeof(records) * 3) / 4;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	/* While disconnected the periodic flush keeps checking; don't requeue it per message */
+	if (flush_now && log_client && golioth_client_is_connected(log_client)) {
+		k_work_reschedule(&flush_work, K_NO_WAIT);
+	}
+}
+
+static void process(const struct log_backend *const backend, union log_msg_generic *msg)
+{
+	uint32_t start = k_cycle_get_32();
+
+	stat_add(STAT_MESSAGES, 1);
+
+#ifdef CONFIG_APP_LOG_DICT_COMPARE
+	text_len = 0;
+	log_output_msg_process(&log_output_text, &msg->log, LOG_OUTPUT_FLAG_LEVEL);
+	log_output_flush(&log_output_text);
+
+	uint32_t text_end = k_cycle_get_32();
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	stats[STAT_TEXT_BYTES] += text_len;
+	stats[STAT_TEXT_CYCLES] += text_end - start;
+	k_spin_unlock(&lock, key);
+	start = text_end;
+#endif
+
+	if (msg_filter(&msg->log)) {
+		msg_len = 0;
+		msg_truncated = false;
+
+		log_dict_output_msg_process(&log_output_dict, &msg->log, 0);
+		log_output_flush(&log_output_dict);
+
+		msg_commit();
+	}
+
+	stat_add(STAT_DICT_CYCLES, k_cycle_get_32() - start);
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	stat_add(STAT_CORE_DROPPED, cnt);
+}
+
+static void panic(const struct log_backend *const backend)
+{
+	/* Nothing can be sent after a panic; keep the batch for the core dump */
+}
+
+static const struct log_backend_api log_dict_api = {
+	.process = process,
+	.dropped = dropped,
+	.panic = panic,
+};
+
+LOG_BACKEND_DEFINE(app_log_dict_backend, log_dict_api, true);
+
+static bool encode_u64(zcbor_state_t *zse, const char *key, uint64_t value)
+{
+	return zcbor_tstr_encode_ptr(zse, key, strlen(key)) && zcbor_uint64_put(zse, value);
+}
+
+static bool batch_encode(zcbor_state_t *zse)
+{
+	bool ok = zcbor_map_start_encode(zse, 4) && encode_u64(zse, "seq", batch_seq) &&
+		  encode_u64(zse, "uptime_ms", k_uptime_get()) &&
+		  zcbor_tstr_put_lit(zse, "rep") && zcbor_map_start_encode(zse, repeats_len);
+
+	for (size_t i = 0; i < repeats_len && ok; i++) {
+		ok = zcbor_uint32_put(zse, repeats[i].source) &&
+		     zcbor_uint32_put(zse, repeats[i].count);
+	}
+
+	return ok && zcbor_map_end_encode(zse, repeats_len) && zcbor_tstr_put_lit(zse, "d") &&
+	       zcbor_bstr_encode_ptr(zse, (const char *)records, records_len) &&
+	       zcbor_map_end_encode(zse, 4);
+}
+
+static void flush_work_handler(struct k_work *work)
+{
+	static uint8_t buf[CONFIG_APP_LOG_DICT_BUF_SIZE + FRAME_OVERHEAD];
+	ZCBOR_STATE_E(zse, 2, buf, sizeof(buf), 1);
+	k_spinlock_key_t key;
+	bool ok;
+
+	k_work_reschedule(&flush_work, K_SECONDS(CONFIG_APP_LOG_DICT_FLUSH_INTERVAL_S));
+
+	if (!log_client || !golioth_client_is_connected(log_client)) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+
+	if (records_len == 0 && repeats_len == 0) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	ok = batch_encode(zse);
+	records_len = 0;
+	repeats_len = 0;
+	batch_seq++;
+
+	k_spin_unlock(&lock, key);
+
+	int err = ok ? golioth_stream_set_async(log_client, LOG_DICT_ENDP,
+						GOLIOTH_CONTENT_TYPE_CBOR, buf,
+						zse->payload - buf, NULL, NULL)
+		     : -ENOMEM;
+
+	key = k_spin_lock(&lock);
+	stats[err ? STAT_BATCH_FAILED : STAT_BATCHES]++;
+	if (!err) {
+		stats[STAT_BATCH_BYTES] += zse->payload - buf;
+	}
+	k_spin_unlock(&lock, key);
+}
+
+void app_log_dict_set_client(struct golioth_client *client)
+{
+	log_client = client;
+	k_work_schedule(&flush_work, K_SECONDS(CONFIG_APP_LOG_DICT_FLUSH_INTERVAL_S));
+}
+
+int app_log_dict_add_to_map(zcbor_state_t *response_detail_map)
+{
+	uint64_t snapshot[STAT_COUNT];
+	size_t pending;
+	bool ok = true;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	memcpy(snapshot, stats, sizeof(snapshot));
+	pending = records_len;
+	k_spin_unlock(&lock, key);
+
+	for (int i = 0; i < STAT_COUNT && ok; i++) {
+		ok = encode_u64(response_detail_map, stat_names[i], snapshot[i]);
+	}
+
+	/*
+	 * Savings against the text backend, per message given to the backend.
+	 * The wire figures add the framing each side pays: the text backend
+	 * once per message, this one once per batch.
+	 */
+	if (IS_ENABLED(CONFIG_APP_LOG_DICT_COMPARE) && ok && snapshot[STAT_MESSAGES]) {
+		uint64_t msgs = snapshot[STAT_MESSAGES];
+		uint64_t text_wire = snapshot[STAT_TEXT_BYTES] + msgs * TEXT_MSG_WIRE_OVERHEAD;
+		uint64_t dict_wire = snapshot[STAT_BATCH_BYTES] + pending +
+				     snapshot[STAT_BATCHES] * BATCH_WIRE_OVERHEAD;
+
+		ok = encode_u64(response_detail_map, "text_us",
+				k_cyc_to_us_floor64(snapshot[STAT_TEXT_CYCLES])) &&
+		     encode_u64(response_detail_map, "dict_us",
+				k_cyc_to_us_floor64(snapshot[STAT_DICT_CYCLES])) &&
+		     encode_u64(response_detail_map, "text_bytes_per_msg",
+				snapshot[STAT_TEXT_BYTES] / msgs) &&
+		     encode_u64(response_detail_map, "dict_bytes_per_msg",
+				snapshot[STAT_DICT_BYTES] / msgs) &&
+		     encode_u64(response_detail_map, "text_wire_bytes_per_msg", text_wire / msgs) &&
+		     encode_u64(response_detail_map, "dict_wire_bytes_per_msg", dict_wire / msgs);
+	}
+
+	return ok ? 0 : -ENOMEM;
+}
+
+size_t app_log_dict_ram_usage(struct app_ram_usage *usage, size_t max)
+{
+	if (max == 0) {
+		return 0;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	*usage = (struct app_ram_usage){
+		.name = "log_dict",
+		.size = sizeof(records),
+		.used = records_len,
+		.peak = records_peak,
+	};
+	k_spin_unlock(&lock, key);
+
+	return 1;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Dictionary log backend.
+ *
+ * Log messages are sent as Zephyr dictionary records (a message ID and the
+ * binary arguments) batched into the "logs_dict" stream, instead of one
+ * formatted text message each. Messages are rate limited per module and
+ * repeats of the previous message of a module are counted instead of sent.
+ * Decode with utility/log_dict_decode.py and the log_dictionary.json database
+ * generated in the build directory. Statistics, including the cost of the
+ * same messages as text when CONFIG_APP_LOG_DICT_COMPARE is enabled, are
+ * reported by the `get_log_stats` RPC.
+ */
+
+#ifndef __APP_LOG_DICT_H__
+#define __APP_LOG_DICT_H__
+
+#include <errno.h>
+#include <golioth/client.h>
+#include <zcbor_encode.h>
+
+#ifdef CONFIG_APP_LOG_DICT
+
+/** Send buffered log records with this client */
+void app_log_dict_set_client(struct golioth_client *client);
+
+/** Add backend statistics to an RPC response map */
+int app_log_dict_add_to_map(zcbor_state_t *response_detail_map);
+
+struct app_ram_usage;
+
+/**
+ * Report the RAM of the record buffer.
+ *
+ * @return number of entries filled, at most max
+ */
+size_t app_log_dict_ram_usage(struct app_ram_usage *usage, size_t max);
+
+#else
+
+static inline void app_log_dict_set_client(struct golioth_client *client)
+{
+}
+
+static inline int app_log_dict_add_to_map(zcbor_state_t *response_detail_map)
+{
+	return -ENOTSUP;
+}
+
+struct app_ram_usage;
+
+static inline size_t app_log_dict_ram_usage(struct app_ram_usage *usage, size_t max)
+{
+	return 0;
+}
+
+#endif /* CONFIG_APP_LOG_DICT */
+
+#endif /* __APP_LOG_DICT_H__ */
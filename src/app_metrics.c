@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_metrics, LOG_LEVEL_DBG);
+
+#include <golioth/stream.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "app_metrics.h"
+
+#define METRICS_ENDP "metrics"
+
+/* Bucket i counts values below 2^i; the last bucket counts everything above */
+#define HIST_BUCKETS 20
+
+/* Upper bound on threads, only used as a hint for the encoder */
+#define MAX_THREADS 32
+
+/* Encoded size of one periodic metrics report */
+#define STREAM_BUF_SIZE 1024
+
+static const char *const counter_names[APP_METRICS_COUNTER_COUNT] = {
+	[APP_METRICS_NMEA_RX] = "nmea_rx",
+	[APP_METRICS_NMEA_DROPPED] = "nmea_dropped",
+	[APP_METRICS_NMEA_FILTERED] = "nmea_filtered",
+	[APP_METRICS_PARSE_FAILED] = "parse_failed",
+	[APP_METRICS_READINGS_QUEUED] = "readings_queued",
+	[APP_METRICS_READINGS_DROPPED] = "readings_dropped",
+	[APP_METRICS_READINGS_THINNED] = "readings_thinned",
+	[APP_METRICS_READINGS_BUSY] = "readings_dropped_busy",
+	[APP_METRICS_READINGS_STREAMED] = "readings_streamed",
+	[APP_METRICS_UPLOAD_BATCHES] = "upload_batches",
+	[APP_METRICS_UPLOAD_FAILED] = "upload_failed",
+	[APP_METRICS_UPLOAD_BYTES] = "upload_bytes",
+	[APP_METRICS_WORKQ_RUNS] = "workq_runs",
+};
+
+static const char *const hwm_names[APP_METRICS_HWM_COUNT] = {
+	[APP_METRICS_HWM_READING_MSGQ] = "reading_msgq_hwm",
+	[APP_METRICS_HWM_COLDCHAIN_MSGQ] = "coldchain_msgq_hwm",
+};
+
+static const char *const hist_names[APP_METRICS_HIST_COUNT] = {
+	[APP_METRICS_HIST_RX_TO_PARSE_US] = "rx_to_parse_us",
+	[APP_METRICS_HIST_PARSE_US] = "parse_us",
+	[APP_METRICS_HIST_QUEUE_MS] = "queue_ms",
+	[APP_METRICS_HIST_SERIALIZE_US] = "serialize_us",
+	[APP_METRICS_HIST_UPLOAD_MS] = "upload_ms",
+	[APP_METRICS_HIST_E2E_MS] = "e2e_ms",
+};
+
+static atomic_t counters[APP_METRICS_COUNTER_COUNT];
+static atomic_t hwms[APP_METRICS_HWM_COUNT];
+static atomic_t hists[APP_METRICS_HIST_COUNT][HIST_BUCKETS];
+
+void app_metrics_add(enum app_metrics_counter counter, uint32_t value)
+{
+	atomic_add(&counters[counter], value);
+}
+
+uint32_t app_metrics_counter_get(enum app_metrics_counter counter)
+{
+	return (uint32_t)atomic_get(&counters[counter]);
+}
+
+void app_metrics_hwm_update(enum app_metrics_hwm hwm, uint32_t value)
+{
+	atomic_val_t old;
+
+	do {
+		old = atomic_get(&hwms[hwm]);
+		if ((uint32_t)old >= value) {
+			return;
+		}
+	} while (!atomic_cas(&hwms[hwm], old, value));
+}
+
+uint32_t app_metrics_hwm_get(enum app_metrics_hwm hwm)
+{
+	return (uint32_t)atomic_get(&hwms[hwm]);
+}
+
+void app_metrics_hist_record(enum app_metrics_hist hist, uint32_t value)
+{
+	size_t bucket = (value == 0) ? 0 : (32 - __builtin_clz(value));
+
+	atomic_inc(&hists[hist][MIN(bucket, HIST_BUCKETS - 1)]);
+}
+
+static bool encode_str(zcbor_state_t *zse, const char *str)
+{
+	return zcbor_tstr_encode_ptr(zse, str, strlen(str));
+}
+
+struct thread_walk {
+	zcbor_state_t *zse;
+	uint64_t total_cycles;
+	bool ok;
+};
+
+static void thread_encode(const struct k_thread *cthread, void *user_data)
+{
+	struct thread_walk *walk = user_data;
+	struct k_thread *thread = (struct k_thread *)cthread;
+	uint32_t cpu_permille = 0;
+	size_t stack_unused = 0;
+	char name[16];
+
+	if (!walk->ok) {
+		return;
+	}
+
+	const char *tname = k_thread_name_get(thread);
+
+	if (tname && tname[0]) {
+		snprintk(name, sizeof(name), "%s", tname);
+	} else {
+		snprintk(name, sizeof(name), "%p", thread);
+	}
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	k_thread_runtime_stats_t stats;
+
+	if (walk->total_cycles && k_thread_runtime_stats_get(thread, &stats) == 0) {
+		cpu_permille = (stats.execution_cycles * 1000) / walk->total_cycles;
+	}
+#endif
+
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
+	k_thread_stack_space_get(thread, &stack_unused);
+#endif
+
+	/* "name": [cpu permille since boot, unused stack bytes] */
+	walk->ok = encode_str(walk->zse, name) && zcbor_list_start_encode(walk->zse, 2) &&
+		   zcbor_uint32_put(walk->zse, cpu_permille) &&
+		   zcbor_uint32_put(walk->zse, stack_unused) && zcbor_list_end_encode(walk->zse, 2);
+}
+
+static bool threads_encode(zcbor_state_t *zse)
+{
+	struct thread_walk walk = {.zse = zse, .ok = true};
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	k_thread_runtime_stats_t all;
+
+	if (k_thread_runtime_stats_all_get(&all) == 0) {
+		walk.total_cycles = all.execution_cycles;
+	}
+#endif
+
+	if (!encode_str(zse, "threads") || !zcbor_map_start_encode(zse, MAX_THREADS)) {
+		return false;
+	}
+
+	k_thread_foreach_unlocked(thread_encode, &walk);
+
+	return walk.ok && zcbor_map_end_encode(zse, MAX_THREADS);
+}
+
+/* Add counters, high-water marks and threads as key/value pairs to an open map */
+static int metrics_encode(zcbor_state_t *zse)
+{
+	bool ok = true;
+
+	for (int i = 0; i < APP_METRICS_COUNTER_COUNT && ok; i++) {
+		ok = encode_str(zse, counter_names[i]) &&
+		     zcbor_uint32_put(zse, (uint32_t)atomic_get(&counters[i]));
+	}
+
+	for (int i = 0; i < APP_METRICS_HWM_COUNT && ok; i++) {
+		ok = encode_str(zse, hwm_names[i]) &&
+		     zcbor_uint32_put(zse, (uint32_t)atomic_get(&hwms[i]));
+	}
+
+	ok = ok && threads_encode(zse);
+
+	return ok ? 0 : -ENOMEM;
+}
+
+/* Add each histogram as a list of bucket counts to an open map */
+static int hists_encode(zcbor_state_t *zse)
+{
+	bool ok = true;
+
+	for (int i = 0; i < APP_METRICS_HIST_COUNT && ok; i++) {
+		ok = encode_str(zse, hist_names[i]) && zcbor_list_start_encode(zse, HIST_BUCKETS);
+
+		for (int b = 0; b < HIST_BUCKETS && ok; b++) {
+			ok = zcbor_uint32_put(zse, (uint32_t)atomic_get(&hists[i][b]));
+		}
+
+		ok = ok && zcbor_list_end_encode(zse, HIST_BUCKETS);
+	}
+
+	return ok ? 0 : -ENOMEM;
+}
+
+int app_metrics_add_to_map(zcbor_state_t *response_detail_map)
+{
+	return metrics_encode(response_detail_map);
+}
+
+int app_metrics_latency_add_to_map(zcbor_state_t *response_detail_map)
+{
+	return hists_encode(response_detail_map);
+}
+
+#if CONFIG_APP_METRICS_STREAM_INTERVAL_S > 0
+static struct golioth_client *metrics_client;
+
+static void stream_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(stream_work, stream_work_handler);
+
+static void stream_work_handler(struct k_work *work)
+{
+	static uint8_t buf[STREAM_BUF_SIZE];
+	ZCBOR_STATE_E(zse, 2, buf, sizeof(buf), 1);
+
+	k_work_reschedule(&stream_work, K_SECONDS(CONFIG_APP_METRICS_STREAM_INTERVAL_S));
+
+	if (!golioth_client_is_connected(metrics_client)) {
+		return;
+	}
+
+	bool ok = zcbor_map_start_encode(zse, 64) && (metrics_encode(zse) == 0) &&
+		  (hists_encode(zse) == 0) && zcbor_map_end_encode(zse, 64);
+
+	if (!ok) {
+		LOG_ERR("Metrics report does not fit in %d bytes", STREAM_BUF_SIZE);
+		return;
+	}
+
+	int err = golioth_stream_set_async(metrics_client, METRICS_ENDP, GOLIOTH_CONTENT_TYPE_CBOR,
+					   buf, zse->payload - buf, NULL, NULL);
+
+	if (err) {
+		LOG_ERR("Failed to stream metrics: %d", err);
+	}
+}
+#endif /* CONFIG_APP_METRICS_STREAM_INTERVAL_S > 0 */
+
+void app_metrics_stream_start(struct golioth_client *client)
+{
+#if CONFIG_APP_METRICS_STREAM_INTERVAL_S > 0
+	metrics_client = client;
+	k_work_schedule(&stream_work, K_SECONDS(CONFIG_APP_METRICS_STREAM_INTERVAL_S));
+#endif
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Runtime performance metrics.
+ *
+ * Counters, high-water marks and log2 histograms are plain atomics, cheap
+ * enough to update from the UART ISR. Counters and high-water marks are
+ * reported, together with per-thread CPU and stack usage, by the
+ * `get_perf_stats` RPC; the per-stage latency histograms of the reading
+ * pipeline by the `get_latency` RPC. Everything may also be streamed to the
+ * "metrics" path every CONFIG_APP_METRICS_STREAM_INTERVAL_S.
+ */
+
+#ifndef __APP_METRICS_H__
+#define __APP_METRICS_H__
+
+#include <errno.h>
+#include <stdint.h>
+#include <golioth/client.h>
+#include <zcbor_encode.h>
+#include <zephyr/sys/util.h>
+
+#ifdef CONFIG_APP_METRICS_TRACE_EVENTS
+#include <zephyr/tracing/tracing.h>
+#endif
+
+enum app_metrics_counter {
+	APP_METRICS_NMEA_RX,		/* sentences received from the GNSS UART */
+	APP_METRICS_NMEA_DROPPED,	/* sentences dropped, reading_msgq full */
+	APP_METRICS_NMEA_FILTERED,	/* sentences which did not produce a reading */
+	APP_METRICS_PARSE_FAILED,	/* RMC sentences which failed to parse */
+	APP_METRICS_READINGS_QUEUED,	/* readings added to coldchain_msgq */
+	APP_METRICS_READINGS_DROPPED,	/* readings dropped, coldchain_msgq full */
+	APP_METRICS_READINGS_THINNED,	/* queued readings removed to make room */
+	APP_METRICS_READINGS_BUSY,	/* readings dropped while an upload held the queue */
+	APP_METRICS_READINGS_STREAMED,	/* live tracking readings acknowledged */
+	APP_METRICS_UPLOAD_BATCHES,
+	APP_METRICS_UPLOAD_FAILED,
+	APP_METRICS_UPLOAD_BYTES,
+	APP_METRICS_WORKQ_RUNS,		/* work items run on the app and upload work queues */
+	APP_METRICS_COUNTER_COUNT
+};
+
+enum app_metrics_hwm {
+	APP_METRICS_HWM_READING_MSGQ,
+	APP_METRICS_HWM_COLDCHAIN_MSGQ,
+	APP_METRICS_HWM_COUNT
+};
+
+/* Stages of the reading pipeline, from UART to cloud acknowledgement */
+enum app_metrics_hist {
+	APP_METRICS_HIST_RX_TO_PARSE_US, /* sentence complete in ISR -> parser */
+	APP_METRICS_HIST_PARSE_US,	 /* parse, filter and enqueue */
+	APP_METRICS_HIST_QUEUE_MS,	 /* time waiting in coldchain_msgq */
+	APP_METRICS_HIST_SERIALIZE_US,	 /* JSON encoding of one batch */
+	APP_METRICS_HIST_UPLOAD_MS,	 /* batch sent -> acknowledged */
+	APP_METRICS_HIST_E2E_MS,	 /* sentence received -> acknowledged */
+	APP_METRICS_HIST_COUNT
+};
+
+#ifdef CONFIG_APP_METRICS
+
+void app_metrics_add(enum app_metrics_counter counter, uint32_t value);
+
+/** Current value of a counter */
+uint32_t app_metrics_counter_get(enum app_metrics_counter counter);
+
+/** Raise a high-water mark to value if it is higher */
+void app_metrics_hwm_update(enum app_metrics_hwm hwm, uint32_t value);
+
+/** Current value of a high-water mark */
+uint32_t app_metrics_hwm_get(enum app_metrics_hwm hwm);
+
+/** Count a value in its log2 histogram bucket */
+void app_metrics_hist_record(enum app_metrics_hist hist, uint32_t value);
+
+/** Add counters, high-water marks and thread statistics to an RPC response map */
+int app_metrics_add_to_map(zcbor_state_t *response_detail_map);
+
+/** Add the latency histograms to an RPC response map */
+int app_metrics_latency_add_to_map(zcbor_state_t *response_detail_map);
+
+/** Start the periodic metrics stream, if enabled */
+void app_metrics_stream_start(struct golioth_client *client);
+
+#else
+
+static inline void app_metrics_add(enum app_metrics_counter counter, uint32_t value)
+{
+}
+
+static inline uint32_t app_metrics_counter_get(enum app_metrics_counter counter)
+{
+	return 0;
+}
+
+static inline void app_metrics_hwm_update(enum app_metrics_hwm hwm, uint32_t value)
+{
+}
+
+static inline uint32_t app_metrics_hwm_get(enum app_metrics_hwm hwm)
+{
+	return 0;
+}
+
+static inline void app_metrics_hist_record(enum app_metrics_hist hist, uint32_t value)
+{
+}
+
+static inline int app_metrics_add_to_map(zcbor_state_t *response_detail_map)
+{
+	return -ENOTSUP;
+}
+
+static inline int app_metrics_latency_add_to_map(zcbor_state_t *response_detail_map)
+{
+	return -ENOTSUP;
+}
+
+static inline void app_metrics_stream_start(struct golioth_client *client)
+{
+}
+
+#endif /* CONFIG_APP_METRICS */
+
+static inline void app_metrics_inc(enum app_metrics_counter counter)
+{
+	app_metrics_add(counter, 1);
+}
+
+/** Emit a named tracing event (e.g. for a CTF timeline) when enabled */
+static inline void app_metrics_trace(const char *name, uint32_t arg0, uint32_t arg1)
+{
+	IF_ENABLED(CONFIG_APP_METRICS_TRACE_EVENTS, (sys_trace_named_event(name, arg0, arg1);));
+}
+
+#endif /* __APP_METRICS_H__ */
@@ -0,0 +1,685 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_ota_delta, LOG_LEVEL_DBG);
+
+#include <string.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/crc.h>
+
+#include "app_ota_delta.h"
+
+#if defined(CONFIG_BUILD_WITH_TFM) && defined(CONFIG_PARTITION_MANAGER_ENABLED)
+#include <pm_config.h>
+/* The TF-M part of the primary slot is secure flash; only the rest can be read */
+#define OLD_READABLE_START (PM_APP_ADDRESS - PM_MCUBOOT_PRIMARY_ADDRESS)
+#else
+#define OLD_READABLE_START 0
+#endif
+
+#define OP_END	  0x00
+#define OP_ADD	  0x01
+#define OP_INSERT 0x02
+
+/* Output is written to flash in blocks of this size */
+#define OUT_BUF_SIZE 512
+#define OLD_BUF_SIZE 64
+
+enum delta_state {
+	DELTA_HEADER,
+	DELTA_OP,
+	DELTA_LEN,
+	DELTA_OFFSET,
+	DELTA_PAIR,
+	DELTA_PAIR_SKIP,
+	DELTA_PAIR_COUNT,
+	DELTA_DIFF,
+	DELTA_LITERAL,
+	DELTA_DONE,
+};
+
+static struct {
+	enum delta_state state;
+	struct app_ota_delta_header hdr;
+	size_t hdr_len;
+
+	uint8_t op;
+	uint32_t varint;
+	uint8_t shift;
+
+	/* Bytes left in the current operation and in the current run */
+	uint32_t op_len;
+	uint32_t skip;
+	uint32_t run;
+
+	uint32_t old_pos;
+	uint32_t new_pos;
+	uint32_t crc;
+
+	const struct flash_area *old_fa;
+	const struct flash_area *new_fa;
+	size_t erased_end;
+	size_t write_block;
+
+	uint8_t out[OUT_BUF_SIZE];
+	size_t out_len;
+
+	uint8_t old[OLD_BUF_SIZE];
+	uint32_t old_base;
+	size_t old_len;
+} ctx;
+
+static int erase_to(size_t end)
+{
+	while (ctx.erased_end < end) {
+		struct flash_pages_info info;
+		int err = flash_get_page_info_by_offs(flash_area_get_device(ctx.new_fa),
+						      ctx.new_fa->fa_off + ctx.erased_end, &info);
+
+		if (!err) {
+			err = flash_area_erase(ctx.new_fa, ctx.erased_end, info.size);
+		}
+
+		if (err) {
+			LOG_ERR("Unable to erase secondary slot at 0x%zx: %d", ctx.erased_end, err);
+			return err;
+		}
+
+		ctx.erased_end += info.size;
+	}
+
+	return 0;
+}
+
+static int out_flush(void)
+{
+	size_t offset = ctx.new_pos - ctx.out_len;
+	size_t len = ROUND_UP(ctx.out_len, ctx.write_block);
+	int err;
+
+	if (!ctx.out_len) {
+		return 0;
+	}
+
+	/* Only the last block is short; pad it to the write block size */
+	memset(&ctx.out[ctx.out_len], 0xff, len - ctx.out_len);
+
+	err = erase_to(offset + len);
+	if (!err) {
+		err = flash_area_write(ctx.new_fa, offset, ctx.out, len);
+	}
+
+	ctx.out_len = 0;
+
+	return err;
+}
+
+static int out_put(const uint8_t *data, size_t len)
+{
+	if (ctx.new_pos + len > ctx.hdr.new_size) {
+		return -EINVAL;
+	}
+
+	ctx.crc = crc32_ieee_update(ctx.crc, data, len);
+
+	while (len) {
+		size_t n = MIN(len, sizeof(ctx.out) - ctx.out_len);
+
+		memcpy(&ctx.out[ctx.out_len], data, n);
+		ctx.out_len += n;
+		ctx.new_pos += n;
+		data += n;
+		len -= n;
+
+		if (ctx.out_len == sizeof(ctx.out)) {
+			int err = out_flush();
+
+			if (err) {
+				return err;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int old_get(uint32_t pos, uint8_t *byte)
+{
+	if (pos < ctx.old_base || pos >= ctx.old_base + ctx.old_len) {
+		ctx.old_base = pos;
+		ctx.old_len = MIN(sizeof(ctx.old), ctx.hdr.old_size - pos);
+
+		int err = flash_area_read(ctx.old_fa, pos, ctx.old, ctx.old_len);
+
+		if (err) {
+			ctx.old_len = 0;
+			return err;
+		}
+	}
+
+	*byte = ctx.old[pos - ctx.old_base];
+
+	return 0;
+}
+
+/* Copy len unchanged bytes of the old image */
+static int old_copy(uint32_t len)
+{
+	while (len) {
+		uint8_t byte;
+		int err = old_get(ctx.old_pos, &byte);
+
+		if (err) {
+			return err;
+		}
+
+		/* Whole cached reads at a time */
+		size_t n = MIN(len, ctx.old_base + ctx.old_len - ctx.old_pos);
+
+		err = out_put(&ctx.old[ctx.old_pos - ctx.old_base], n);
+		if (err) {
+			return err;
+		}
+
+		ctx.old_pos += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static int old_check(void)
+{
+	const struct app_ota_delta_header *hdr = &ctx.hdr;
+	uint32_t old_start = hdr->old_start;
+	uint32_t crc = 0;
+
+	if (old_start < OLD_READABLE_START || old_start > hdr->old_size ||
+	    hdr->old_size > ctx.old_fa->fa_size) {
+		LOG_ERR("Patch reads old image from 0x%x, readable from 0x%x", old_start,
+			OLD_READABLE_START);
+		return -ENOENT;
+	}
+
+	for (uint32_t pos = old_start; pos < hdr->old_size; pos += sizeof(ctx.old)) {
+		size_t n = MIN(sizeof(ctx.old), hdr->old_size - pos);
+		int err = flash_area_read(ctx.old_fa, pos, ctx.old, n);
+
+		if (err) {
+			return err;
+		}
+
+		crc = crc32_ieee_update(crc, ctx.old, n);
+	}
+
+	if (crc != hdr->old_crc) {
+		LOG_ERR("Patch is for another image (CRC 0x%08x, running 0x%08x)", hdr->old_crc,
+			crc);
+		return -ENOENT;
+	}
+
+	ctx.old_pos = old_start;
+
+	return 0;
+}
+
+/* MCUboot writes its trailer to the last sector of the slot */
+static int trailer_sector(struct flash_pages_info *info)
+{
+	return flash_get_page_info_by_offs(flash_area_get_device(ctx.new_fa),
+					   ctx.new_fa->fa_off + ctx.new_fa->fa_size - 1, info);
+}
+
+static int header_check(void)
+{
+	const struct app_ota_delta_header *hdr = &ctx.hdr;
+	struct flash_pages_info trailer;
+	int err = trailer_sector(&trailer);
+
+	if (err) {
+		return err;
+	}
+
+	if (memcmp(hdr->magic, APP_OTA_DELTA_MAGIC, sizeof(hdr->magic)) ||
+	    hdr->version != APP_OTA_DELTA_VERSION) {
+		LOG_ERR("Not a delta patch");
+		return -EINVAL;
+	}
+
+	if (hdr->new_size > trailer.start_offset - ctx.new_fa->fa_off) {
+		LOG_ERR("New image of %u bytes does not fit", hdr->new_size);
+		return -EFBIG;
+	}
+
+	return old_check();
+}
+
+/* Returns 1 when a complete number has been read */
+static int varint_feed(uint8_t byte)
+{
+	if (ctx.shift > 28) {
+		return -EINVAL;
+	}
+
+	ctx.varint |= (uint32_t)(byte & 0x7f) << ctx.shift;
+	ctx.shift += 7;
+
+	if (byte & 0x80) {
+		return 0;
+	}
+
+	ctx.shift = 0;
+	return 1;
+}
+
+static uint32_t varint_take(void)
+{
+	uint32_t value = ctx.varint;
+
+	ctx.varint = 0;
+	return value;
+}
+
+static enum delta_state next_op_state(void)
+{
+	return ctx.op_len ? DELTA_PAIR : DELTA_OP;
+}
+
+static int pair_start(void)
+{
+	if (ctx.skip + ctx.run > ctx.op_len) {
+		return -EINVAL;
+	}
+
+	ctx.op_len -= ctx.skip + ctx.run;
+	ctx.state = ctx.run ? DELTA_DIFF : next_op_state();
+
+	return old_copy(ctx.skip);
+}
+
+static int op_start(uint32_t offset)
+{
+	/* Zigzag encoded move of the old cursor */
+	int64_t pos = (int64_t)ctx.old_pos + ((offset & 1) ? -(int64_t)((offset + 1) >> 1)
+							   : (int64_t)(offset >> 1));
+
+	if (pos < ctx.hdr.old_start || pos + ctx.op_len > ctx.hdr.old_size) {
+		return -EINVAL;
+	}
+
+	ctx.old_pos = pos;
+	ctx.state = next_op_state();
+
+	return 0;
+}
+
+static int feed(const uint8_t *data, size_t len)
+{
+	int ret = 0;
+
+	while (len && ret >= 0) {
+		uint8_t byte = *data;
+		size_t used = 1;
+
+		switch (ctx.state) {
+		case DELTA_HEADER:
+			used = MIN(len, sizeof(ctx.hdr) - ctx.hdr_len);
+			memcpy((uint8_t *)&ctx.hdr + ctx.hdr_len, data, used);
+			ctx.hdr_len += used;
+
+			if (ctx.hdr_len == sizeof(ctx.hdr)) {
+				ret = header_check();
+				ctx.state = DELTA_OP;
+			}
+			break;
+		case DELTA_OP:
+			ctx.op = byte;
+			if (byte == OP_END) {
+				ctx.state = DELTA_DONE;
+			} else if (byte == OP_ADD || byte == OP_INSERT) {
+				ctx.state = DELTA_LEN;
+			} else {
+				ret = -EINVAL;
+			}
+			break;
+		case DELTA_LEN:
+			ret = varint_feed(byte);
+			if (ret == 1) {
+				ctx.op_len = varint_take();
+				if (ctx.op == OP_ADD) {
+					ctx.state = DELTA_OFFSET;
+				} else {
+					ctx.state = ctx.op_len ? DELTA_LITERAL : DELTA_OP;
+				}
+			}
+			break;
+		case DELTA_OFFSET:
+			ret = varint_feed(byte);
+			if (ret == 1) {
+				ret = op_start(varint_take());
+			}
+			break;
+		case DELTA_PAIR:
+			ctx.skip = byte >> 4;
+			ctx.run = byte & 0x0f;
+			if (ctx.skip == 15) {
+				ctx.state = DELTA_PAIR_SKIP;
+			} else if (ctx.run == 15) {
+				ctx.state = DELTA_PAIR_COUNT;
+			} else {
+				ret = pair_start();
+			}
+			break;
+		case DELTA_PAIR_SKIP:
+			ret = varint_feed(byte);
+			if (ret == 1) {
+				ctx.skip += varint_take();
+				if (ctx.run == 15) {
+					ctx.state = DELTA_PAIR_COUNT;
+				} else {
+					ret = pair_start();
+				}
+			}
+			break;
+		case DELTA_PAIR_COUNT:
+			ret = varint_feed(byte);
+			if (ret == 1) {
+				ctx.run += varint_take();
+				ret = pair_start();
+			}
+			break;
+		case DELTA_DIFF: {
+			uint8_t old;
+
+			ret = old_get(ctx.old_pos, &old);
+			if (!ret) {
+				old += byte;
+				ctx.old_pos++;
+				ret = out_put(&old, 1);
+			}
+			if (--ctx.run == 0) {
+				ctx.state = next_op_state();
+			}
+			break;
+		}
+		case DELTA_LITERAL:
+			used = MIN(len, ctx.op_len);
+			ret = out_put(data, used);
+			ctx.op_len -= used;
+			if (ctx.op_len == 0) {
+				ctx.state = DELTA_OP;
+			}
+			break;
+		case DELTA_DONE:
+			/* Block padding after the end is ignored */
+			used = len;
+			break;
+		}
+
+		data += used;
+		len -= used;
+	}
+
+	return MIN(ret, 0);
+}
+
+static atomic_t slot_owner = ATOMIC_INIT(APP_OTA_SLOT_FREE);
+static K_SEM_DEFINE(slot_sem, 1, 1);
+
+int app_ota_slot_claim(enum app_ota_slot_owner owner, k_timeout_t timeout)
+{
+	if (atomic_get(&slot_owner) == owner) {
+		return 0;
+	}
+
+	if (k_sem_take(&slot_sem, timeout)) {
+		return -EBUSY;
+	}
+
+	atomic_set(&slot_owner, owner);
+
+	return 0;
+}
+
+void app_ota_slot_release(enum app_ota_slot_owner owner)
+{
+	if (atomic_cas(&slot_owner, owner, APP_OTA_SLOT_FREE)) {
+		k_sem_give(&slot_sem);
+	}
+}
+
+int app_ota_delta_begin(void)
+{
+	int err;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	err = flash_area_open(APP_OTA_DELTA_OLD_SLOT, &ctx.old_fa);
+	if (!err) {
+		err = flash_area_open(APP_OTA_DELTA_NEW_SLOT, &ctx.new_fa);
+	}
+
+	if (err) {
+		LOG_ERR("Unable to open image slots: %d", err);
+		return err;
+	}
+
+	ctx.write_block = flash_get_write_block_size(flash_area_get_device(ctx.new_fa));
+
+	return 0;
+}
+
+int app_ota_delta_write(const uint8_t *data, size_t len)
+{
+	return feed(data, len);
+}
+
+int app_ota_delta_finish(void)
+{
+	int err;
+
+	if (ctx.state != DELTA_DONE || ctx.new_pos != ctx.hdr.new_size) {
+		LOG_ERR("Patch ended after %u of %u bytes", ctx.new_pos, ctx.hdr.new_size);
+		return -EBADMSG;
+	}
+
+	err = out_flush();
+	if (err) {
+		return err;
+	}
+
+	if (ctx.crc != ctx.hdr.new_crc) {
+		LOG_ERR("Patched image CRC 0x%08x, expected 0x%08x", ctx.crc, ctx.hdr.new_crc);
+		return -EBADMSG;
+	}
+
+	struct flash_pages_info trailer;
+
+	err = trailer_sector(&trailer);
+	if (!err) {
+		err = flash_area_erase(ctx.new_fa, trailer.start_offset - ctx.new_fa->fa_off,
+				       trailer.size);
+	}
+
+	return err ? err : (int)ctx.new_pos;
+}
+
+#ifdef CONFIG_GOLIOTH_FW_UPDATE
+#include <golioth/ota.h>
+#include <zephyr/dfu/mcuboot.h>
+#include <zephyr/sys/reboot.h>
+
+#include "app_gnss_aid.h"
+#include "app_sensors.h"
+
+#define DELTA_THREAD_STACK 2048
+#define REPORT_TIMEOUT_S   10
+
+static struct golioth_client *ota_client;
+static const char *running_version;
+static struct golioth_ota_manifest manifest;
+static struct golioth_ota_component component;
+static atomic_t busy;
+
+static K_SEM_DEFINE(update_sem, 0, 1);
+
+static void report(enum golioth_ota_state state, enum golioth_ota_reason reason)
+{
+	golioth_ota_report_state_sync(ota_client, state, reason, component.package,
+				      running_version, component.version, REPORT_TIMEOUT_S);
+}
+
+static enum golioth_ota_reason reason_from_err(int err)
+{
+	switch (err) {
+	case -ENOENT:
+		return GOLIOTH_OTA_REASON_UNSUPPORTED_PACKAGE_TYPE;
+	case -EBADMSG:
+		return GOLIOTH_OTA_REASON_INTEGRITY_CHECK_FAILURE;
+	case -EFBIG:
+		return GOLIOTH_OTA_REASON_NOT_ENOUGH_FLASH_MEMORY;
+	default:
+		return GOLIOTH_OTA_REASON_FIRMWARE_UPDATE_FAILED;
+	}
+}
+
+static enum golioth_status write_block(const struct golioth_ota_component *component,
+				       uint32_t block_idx, uint8_t *block_buffer,
+				       size_t block_size, bool is_last,
+				       size_t negotiated_block_size, void *arg)
+{
+	int *err = arg;
+
+	*err = app_ota_delta_write(block_buffer, block_size);
+
+	return *err ? GOLIOTH_ERR_FAIL : GOLIOTH_OK;
+}
+
+static void delta_update(void)
+{
+	uint32_t next_block = 0;
+	int64_t start = k_uptime_get();
+	int err = app_ota_delta_begin();
+
+	LOG_INF("Applying %s %s (%d bytes) to %s", component.package, component.version,
+		component.size, running_version);
+
+	report(GOLIOTH_OTA_STATE_DOWNLOADING, GOLIOTH_OTA_REASON_READY);
+
+	if (!err) {
+		enum golioth_status status = golioth_ota_download_component(
+			ota_client, &component, &next_block, write_block, &err);
+
+		if (status != GOLIOTH_OK && !err) {
+			LOG_ERR("Patch download failed: %d", status);
+			report(GOLIOTH_OTA_STATE_IDLE, GOLIOTH_OTA_REASON_CONNECTION_LOST);
+			return;
+		}
+	}
+
+	if (!err) {
+		int size = app_ota_delta_finish();
+
+		err = MIN(size, 0);
+		if (size > 0) {
+			LOG_INF("Patched %d byte image in %lld ms", size, k_uptime_get() - start);
+		}
+	}
+
+	if (err) {
+		LOG_ERR("Unable to apply patch: %d", err);
+		report(GOLIOTH_OTA_STATE_IDLE, reason_from_err(err));
+		return;
+	}
+
+	report(GOLIOTH_OTA_STATE_DOWNLOADED, GOLIOTH_OTA_REASON_READY);
+
+	err = boot_request_upgrade(BOOT_UPGRADE_TEST);
+	if (err) {
+		LOG_ERR("Unable to mark the new image for boot: %d", err);
+		report(GOLIOTH_OTA_STATE_IDLE, GOLIOTH_OTA_REASON_FIRMWARE_UPDATE_FAILED);
+		return;
+	}
+
+	report(GOLIOTH_OTA_STATE_UPDATING, GOLIOTH_OTA_REASON_READY);
+
+	/* The new image is about to boot; preserve queued readings first */
+	uint32_t sent, saved;
+
+	app_sensors_shutdown(CONFIG_APP_SHUTDOWN_FLUSH_TIMEOUT_MS, &sent, &saved);
+	app_gnss_aid_save();
+
+	LOG_PANIC();
+	sys_reboot(SYS_REBOOT_COLD);
+}
+
+static void delta_thread(void *p1, void *p2, void *p3)
+{
+	while (true) {
+		k_sem_take(&update_sem, K_FOREVER);
+		delta_update();
+		app_ota_slot_release(APP_OTA_SLOT_DELTA);
+		atomic_clear(&busy);
+	}
+}
+
+K_THREAD_DEFINE(ota_delta_tid, DELTA_THREAD_STACK, delta_thread, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+
+static void on_manifest(struct golioth_client *client, enum golioth_status status,
+			const struct golioth_coap_rsp_code *coap_rsp_code, const char *path,
+			const uint8_t *payload, size_t payload_size, void *arg)
+{
+	if (status != GOLIOTH_OK || atomic_get(&busy)) {
+		return;
+	}
+
+	if (golioth_ota_payload_as_manifest(payload, payload_size, &manifest) != GOLIOTH_OK) {
+		LOG_ERR("Unable to parse OTA manifest");
+		return;
+	}
+
+	const struct golioth_ota_component *patch =
+		golioth_ota_find_component(&manifest, CONFIG_APP_OTA_DELTA_PACKAGE);
+
+	if (!patch || strcmp(patch->version, running_version) == 0) {
+		return;
+	}
+
+	if (!atomic_cas(&busy, 0, 1)) {
+		return;
+	}
+
+	/* A full image download is writing the secondary slot; try again at the next manifest */
+	if (app_ota_slot_claim(APP_OTA_SLOT_DELTA, K_NO_WAIT)) {
+		LOG_WRN("Full image update in progress, not applying %s", patch->version);
+		atomic_clear(&busy);
+		return;
+	}
+
+	/* Whether the patch fits the running image is checked from its header */
+	component = *patch;
+	k_sem_give(&update_sem);
+}
+
+void app_ota_delta_observe(struct golioth_client *client, const char *current_version)
+{
+	ota_client = client;
+	running_version = current_version;
+
+	int err = golioth_ota_observe_manifest_async(client, on_manifest, NULL);
+
+	if (err) {
+		LOG_ERR("Unable to observe OTA manifest: %d", err);
+	}
+}
+#else
+void app_ota_delta_observe(struct golioth_client *client, const char *current_version)
+{
+}
+#endif /* CONFIG_GOLIOTH_FW_UPDATE */
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Delta firmware updates.
+ *
+ * A patch generated by utility/ota_delta.py against the running image is
+ * published as its own OTA package (CONFIG_APP_OTA_DELTA_PACKAGE). It is
+ * applied while it downloads: the new image is rebuilt from the primary slot
+ * and the patch stream into the secondary slot, which is then marked for
+ * MCUboot to test, the same as a full image. The applier keeps one flash write
+ * buffer and a few parser fields in RAM, whatever the image size. Full image
+ * updates of the "main" package still work as before, for devices running an
+ * image no patch was generated against.
+ */
+
+#ifndef __APP_OTA_DELTA_H__
+#define __APP_OTA_DELTA_H__
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <golioth/client.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+
+#ifdef CONFIG_PARTITION_MANAGER_ENABLED
+#define APP_OTA_DELTA_OLD_SLOT FIXED_PARTITION_ID(mcuboot_primary)
+#define APP_OTA_DELTA_NEW_SLOT FIXED_PARTITION_ID(mcuboot_secondary)
+#else
+#define APP_OTA_DELTA_OLD_SLOT FIXED_PARTITION_ID(slot0_partition)
+#define APP_OTA_DELTA_NEW_SLOT FIXED_PARTITION_ID(slot1_partition)
+#endif
+
+#define APP_OTA_DELTA_MAGIC   "CCDP"
+#define APP_OTA_DELTA_VERSION 1
+
+struct app_ota_delta_header {
+	uint8_t magic[4];
+	uint8_t version;
+	uint8_t reserved[3];
+	uint32_t old_size;
+	uint32_t old_crc;
+	uint32_t new_size;
+	uint32_t new_crc;
+	/* The old image is only read, and its CRC taken, from this offset */
+	uint32_t old_start;
+	uint32_t reserved2;
+} __packed;
+
+/* Updaters which write the secondary slot */
+enum app_ota_slot_owner {
+	APP_OTA_SLOT_FREE,
+	APP_OTA_SLOT_DELTA, /* this patch applier */
+	APP_OTA_SLOT_FULL,  /* the Golioth fw_update full image download */
+};
+
+#ifdef CONFIG_APP_OTA_DELTA
+
+/**
+ * Take the secondary slot for an updater, so a delta and a full image update
+ * never write it at the same time. Taking it again is a no-op.
+ *
+ * @return 0 on success, -EBUSY if the other updater still holds it at timeout
+ */
+int app_ota_slot_claim(enum app_ota_slot_owner owner, k_timeout_t timeout);
+
+/** Give the secondary slot back, if owner holds it */
+void app_ota_slot_release(enum app_ota_slot_owner owner);
+
+/** Start applying a patch to the secondary slot */
+int app_ota_delta_begin(void);
+
+/**
+ * Apply the next part of the patch; parts may be split anywhere.
+ *
+ * @return 0 on success, -ENOENT if the patch was generated against another
+ *	   image, -EINVAL if it is malformed, or a flash error
+ */
+int app_ota_delta_write(const uint8_t *data, size_t len);
+
+/**
+ * Flush the new image and check it against the CRC in the patch.
+ *
+ * @return size of the new image, or -EBADMSG if the patch was incomplete or
+ *	   the image does not match
+ */
+int app_ota_delta_finish(void);
+
+/** Watch the OTA manifest for patches against the running image */
+void app_ota_delta_observe(struct golioth_client *client, const char *current_version);
+
+#else
+
+static inline int app_ota_slot_claim(enum app_ota_slot_owner owner, k_timeout_t timeout)
+{
+	return 0;
+}
+
+static inline void app_ota_slot_release(enum app_ota_slot_owner owner)
+{
+}
+
+static inline int app_ota_delta_begin(void)
+{
+	return -ENOTSUP;
+}
+
+static inline int app_ota_delta_write(const uint8_t *data, size_t len)
+{
+	return -ENOTSUP;
+}
+
+static inline int app_ota_delta_finish(void)
+{
+	return -ENOTSUP;
+}
+
+static inline void app_ota_delta_observe(struct golioth_client *client,
+					 const char *current_version)
+{
+}
+
+#endif /* CONFIG_APP_OTA_DELTA */
+
+#endif /* __APP_OTA_DELTA_H__ */
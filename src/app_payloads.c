@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include "app_payloads.h"
+
+APP_CODEC_SCHEMA_DEFINE(app_reading, APP_READING_FIELDS);
+APP_CODEC_SCHEMA_DEFINE(app_state, APP_STATE_FIELDS);
+APP_CODEC_SCHEMA_DEFINE(app_live_track_status, APP_LIVE_TRACK_STATUS_FIELDS);
+APP_CODEC_SCHEMA_DEFINE(app_live_track_params, APP_LIVE_TRACK_PARAMS_FIELDS);
+APP_CODEC_SCHEMA_DEFINE(app_fetch_readings_params, APP_FETCH_READINGS_PARAMS_FIELDS);
+APP_CODEC_SCHEMA_DEFINE(app_set_log_level_params, APP_SET_LOG_LEVEL_PARAMS_FIELDS);
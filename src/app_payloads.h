@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Schemas of the payloads exchanged with the cloud.
+ *
+ * Each schema lists its fields as X(T, name, kind, flags, ...), see
+ * app_codec.h. For each one a struct, an enum of field indexes (for the masks
+ * passed to the codecs) and a `<type>_schema` field table are generated, and
+ * APP_CODEC_JSON_MAX() and APP_CODEC_CBOR_MAX() give its exact maximum
+ * encoded size. Adding a field here is all it takes to send or receive it;
+ * keep field names to 23 characters.
+ */
+
+#ifndef __APP_PAYLOADS_H__
+#define __APP_PAYLOADS_H__
+
+#include "app_codec.h"
+
+/** Declare the struct, field indexes and field table of a schema */
+#define APP_PAYLOAD_DECLARE(type, prefix, list)                                                    \
+	struct type {                                                                              \
+		list(APP_CODEC_MEMBER, _)                                                          \
+	};                                                                                         \
+	enum type##_field {                                                                        \
+		list(APP_CODEC_INDEX, prefix)                                                      \
+		prefix##_FIELD_COUNT                                                               \
+	};                                                                                         \
+	extern const struct app_codec_schema type##_schema
+
+/**
+ * One reading, streamed to the "gps" path in batches: position (degrees),
+ * the time of the fix, temperature (°C), pressure (kPa) and humidity (%RH).
+ * Sensor values which could not be read are left out.
+ */
+#define APP_READING_FIELDS(X, T)                                                                   \
+	X(T, lat, MICRO, 0)                                                                        \
+	X(T, lon, MICRO, 0)                                                                        \
+	X(T, time, TIME, 0)                                                                        \
+	X(T, tem, MICRO, 0)                                                                        \
+	X(T, pre, MICRO, 0)                                                                        \
+	X(T, hum, MICRO, 0)
+
+APP_PAYLOAD_DECLARE(app_reading, APP_READING, APP_READING_FIELDS);
+
+/**
+ * LightDB State fields, both the "desired" values set by the cloud and the
+ * "state" reported by the device: X(T, name, INT, 0, min, max, default,
+ * on_change). Only INT fields are supported. See app_state.h.
+ */
+#define APP_STATE_FIELDS(X, T)                                                                     \
+	X(T, example_int0, INT, 0, 0, 65535, 0, NULL)                                              \
+	X(T, example_int1, INT, 0, 0, 65535, 1, NULL)
+
+APP_PAYLOAD_DECLARE(app_state, APP_STATE, APP_STATE_FIELDS);
+
+/**
+ * Live tracking session: the live_track RPC response, and the report streamed
+ * to the "live_track" path, without interval_s and remaining_s, when the
+ * session ends.
+ */
+#define APP_LIVE_TRACK_STATUS_FIELDS(X, T)                                                         \
+	X(T, interval_s, UINT, 0)                                                                  \
+	X(T, remaining_s, UINT, 0)                                                                 \
+	X(T, fixes, UINT, 0)                                                                       \
+	X(T, acked, UINT, 0)                                                                       \
+	X(T, failed, UINT, 0)                                                                      \
+	X(T, latency_min_ms, UINT, 0)                                                              \
+	X(T, latency_avg_ms, UINT, 0)                                                              \
+	X(T, latency_max_ms, UINT, 0)
+
+APP_PAYLOAD_DECLARE(app_live_track_status, APP_LIVE_TRACK_STATUS, APP_LIVE_TRACK_STATUS_FIELDS);
+
+/* RPC parameters, in order */
+
+#define APP_LIVE_TRACK_PARAMS_FIELDS(X, T)                                                         \
+	X(T, duration_s, UINT, 0)                                                                  \
+	X(T, interval_s, UINT, APP_CODEC_OPTIONAL)
+
+APP_PAYLOAD_DECLARE(app_live_track_params, APP_LIVE_TRACK_PARAMS, APP_LIVE_TRACK_PARAMS_FIELDS);
+
+#define APP_FETCH_READINGS_PARAMS_FIELDS(X, T)                                                     \
+	X(T, start_s, I64, 0)                                                                      \
+	X(T, end_s, I64, 0)                                                                        \
+	X(T, max_points, UINT, APP_CODEC_OPTIONAL)
+
+APP_PAYLOAD_DECLARE(app_fetch_readings_params, APP_FETCH_READINGS_PARAMS,
+		    APP_FETCH_READINGS_PARAMS_FIELDS);
+
+#define APP_SET_LOG_LEVEL_PARAMS_FIELDS(X, T) X(T, level, INT, 0)
+
+APP_PAYLOAD_DECLARE(app_set_log_level_params, APP_SET_LOG_LEVEL_PARAMS,
+		    APP_SET_LOG_LEVEL_PARAMS_FIELDS);
+
+#endif /* __APP_PAYLOADS_H__ */
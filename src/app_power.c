@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_power, LOG_LEVEL_DBG);
+
+#include <battery_monitor.h>
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+
+#include "app_power.h"
+
+#ifdef CONFIG_LIB_OSTENTUS
+#include "app_display.h"
+#define NORMAL_DISPLAY_REFRESH_MS CONFIG_APP_DISPLAY_MIN_REFRESH_MS
+#else
+#define NORMAL_DISPLAY_REFRESH_MS 0
+#endif
+
+struct power_profile {
+	const char *name;
+	uint16_t gps_delay_pct;	      /* scale applied to GPS_DELAY_S */
+	uint16_t loop_delay_pct;      /* scale applied to LOOP_DELAY_S */
+	uint16_t sensor_period_s;     /* time between weather sensor reads */
+	uint16_t recorder_period_pct; /* scale applied to the recorder period, 0 pauses it */
+	uint16_t flush_min_queued;    /* readings to accumulate before uploading */
+	uint16_t flush_max_age_s;     /* upload anyway once the oldest has waited this long */
+	uint32_t display_refresh_ms;
+};
+
+/* utility/power_projection.py reads this table */
+static const struct power_profile profiles[APP_POWER_PROFILE_COUNT] = {
+	[APP_POWER_PROFILE_NORMAL] = {
+		.name = "normal",
+		.gps_delay_pct = 100,
+		.loop_delay_pct = 100,
+		.sensor_period_s = 1,
+		.recorder_period_pct = 100,
+		.flush_min_queued = 1,
+		.flush_max_age_s = 0,
+		.display_refresh_ms = NORMAL_DISPLAY_REFRESH_MS,
+	},
+	[APP_POWER_PROFILE_SAVER] = {
+		.name = "saver",
+		.gps_delay_pct = 300,
+		.loop_delay_pct = 400,
+		.sensor_period_s = 10,
+		.recorder_period_pct = 1000,
+		.flush_min_queued = 20,
+		.flush_max_age_s = 900,
+		.display_refresh_ms = 60000,
+	},
+	[APP_POWER_PROFILE_CRITICAL] = {
+		.name = "critical",
+		.gps_delay_pct = 1000,
+		.loop_delay_pct = 1200,
+		.sensor_period_s = 60,
+		.recorder_period_pct = 0,
+		.flush_min_queued = 100,
+		.flush_max_age_s = 3600,
+		.display_refresh_ms = 600000,
+	},
+};
+
+/* Levels are tracked in parts per ten thousand (pptt), as reported by the battery monitor */
+#define SAVER_PPTT	(CONFIG_APP_POWER_SAVER_LEVEL_PCT * 100)
+#define CRITICAL_PPTT	(CONFIG_APP_POWER_CRITICAL_LEVEL_PCT * 100)
+#define HYSTERESIS_PPTT (CONFIG_APP_POWER_HYSTERESIS_PCT * 100)
+
+/* Minimum time between samples used for the discharge trend */
+#define TREND_MIN_INTERVAL_MS (60 * MSEC_PER_SEC)
+#define MS_PER_HOUR	      (3600 * MSEC_PER_SEC)
+
+static enum app_power_profile active_profile = APP_POWER_PROFILE_NORMAL;
+
+static int32_t last_level_pptt = -1;
+static int64_t last_level_ms;
+/* Exponentially weighted discharge rate in pptt per hour (negative when discharging) */
+static int32_t trend_pptt_per_h;
+
+static void update_trend(int32_t level_pptt, int64_t now)
+{
+	if (last_level_pptt < 0) {
+		last_level_pptt = level_pptt;
+		last_level_ms = now;
+		return;
+	}
+
+	int64_t dt = now - last_level_ms;
+
+	if (dt < TREND_MIN_INTERVAL_MS) {
+		return;
+	}
+
+	int32_t rate = (int32_t)(((int64_t)(level_pptt - last_level_pptt) * MS_PER_HOUR) / dt);
+
+	trend_pptt_per_h = (trend_pptt_per_h * 3 + rate) / 4;
+	last_level_pptt = level_pptt;
+	last_level_ms = now;
+}
+
+static enum app_power_profile classify(int32_t level_pptt)
+{
+	if (level_pptt < CRITICAL_PPTT) {
+		return APP_POWER_PROFILE_CRITICAL;
+	}
+
+	if (level_pptt < SAVER_PPTT) {
+		return APP_POWER_PROFILE_SAVER;
+	}
+
+	return APP_POWER_PROFILE_NORMAL;
+}
+
+static enum app_power_profile select_profile(int32_t level_pptt)
+{
+	/* Look ahead while discharging so fast drains change profile early */
+	int32_t projected = level_pptt;
+
+	if (trend_pptt_per_h < 0) {
+		projected += trend_pptt_per_h * CONFIG_APP_POWER_TREND_LOOKAHEAD_H;
+	}
+
+	enum app_power_profile target = classify(projected);
+
+	if (target < active_profile) {
+		/* Only relax to a less restrictive profile once clear of the hysteresis band */
+		target = MIN(active_profile, classify(projected - HYSTERESIS_PPTT));
+	}
+
+	return target;
+}
+
+void app_power_update(void)
+{
+	struct battery_data batt;
+	int err = read_battery_data(&batt);
+
+	if (err) {
+		LOG_ERR("Unable to read battery: %d", err);
+		return;
+	}
+
+	int32_t level_pptt = batt.battery_level_pptt;
+
+	update_trend(level_pptt, k_uptime_get());
+
+	enum app_power_profile profile = select_profile(level_pptt);
+
+	if (profile == active_profile) {
+		return;
+	}
+
+	LOG_INF("Power profile %s -> %s (battery %d.%02d%%, trend %d.%02d%%/h)",
+		profiles[active_profile].name, profiles[profile].name, level_pptt / 100,
+		level_pptt % 100, trend_pptt_per_h / 100, abs(trend_pptt_per_h % 100));
+
+	active_profile = profile;
+
+	IF_ENABLED(CONFIG_LIB_OSTENTUS,
+		   (app_display_min_refresh_set(profiles[profile].display_refresh_ms);));
+}
+
+enum app_power_profile app_power_profile_get(void)
+{
+	return active_profile;
+}
+
+const char *app_power_profile_name(enum app_power_profile profile)
+{
+	return (profile < APP_POWER_PROFILE_COUNT) ? profiles[profile].name : "unknown";
+}
+
+int32_t app_power_gps_delay_s(int32_t configured_s)
+{
+	return (int32_t)(((int64_t)configured_s * profiles[active_profile].gps_delay_pct) / 100);
+}
+
+int32_t app_power_loop_delay_s(int32_t configured_s)
+{
+	return (int32_t)(((int64_t)configured_s * profiles[active_profile].loop_delay_pct) / 100);
+}
+
+uint32_t app_power_sensor_period_s(void)
+{
+	return profiles[active_profile].sensor_period_s;
+}
+
+uint32_t app_power_recorder_period_ms(uint32_t configured_ms)
+{
+	return (uint32_t)(((uint64_t)configured_ms * profiles[active_profile].recorder_period_pct) /
+			  100);
+}
+
+uint32_t app_power_flush_max_age_s(void)
+{
+	return profiles[active_profile].flush_max_age_s;
+}
+
+bool app_power_flush_due(uint32_t queued, uint32_t capacity, uint32_t oldest_age_s)
+{
+	uint32_t max_age_s = profiles[active_profile].flush_max_age_s;
+
+	/* Never let batching push the queue close to dropping readings, or hold them for hours
+	 * at a slow cadence
+	 */
+	return (queued >= profiles[active_profile].flush_min_queued) ||
+	       (queued >= (capacity * 3) / 4) || (max_age_s > 0 && oldest_age_s >= max_age_s);
+}
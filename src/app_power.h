@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Battery-aware power policy.
+ *
+ * The battery level and its trend select an operating profile which stretches
+ * the cloud-configured `GPS_DELAY_S` and `LOOP_DELAY_S`, slows weather sensor
+ * sampling and the flight recorder, batches uploads and slows display refreshes
+ * as the battery drains. The profile is applied on top of the settings; it
+ * never replaces them.
+ *
+ * Without a battery monitor the policy is compiled out and all values pass
+ * through unchanged.
+ */
+
+#ifndef __APP_POWER_H__
+#define __APP_POWER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+enum app_power_profile {
+	APP_POWER_PROFILE_NORMAL,
+	APP_POWER_PROFILE_SAVER,
+	APP_POWER_PROFILE_CRITICAL,
+	APP_POWER_PROFILE_COUNT
+};
+
+#ifdef CONFIG_APP_POWER_POLICY
+
+/**
+ * Read the battery and select the operating profile. Called from the battery
+ * work on the app work queue after the battery has been reported.
+ */
+void app_power_update(void);
+
+enum app_power_profile app_power_profile_get(void);
+const char *app_power_profile_name(enum app_power_profile profile);
+
+/** @return GPS_DELAY_S adjusted for the active profile */
+int32_t app_power_gps_delay_s(int32_t configured_s);
+
+/** @return LOOP_DELAY_S adjusted for the active profile */
+int32_t app_power_loop_delay_s(int32_t configured_s);
+
+/** @return seconds between weather sensor reads for the active profile */
+uint32_t app_power_sensor_period_s(void);
+
+/**
+ * @return flight recorder sample period adjusted for the active profile, 0 if
+ *	   the recorder is paused
+ */
+uint32_t app_power_recorder_period_ms(uint32_t configured_ms);
+
+/**
+ * @return seconds the oldest queued reading may wait for an upload in the
+ *	   active profile, 0 if uploads are not held back
+ */
+uint32_t app_power_flush_max_age_s(void);
+
+/**
+ * @param queued number of readings waiting to be uploaded
+ * @param capacity size of the reading queue
+ * @param oldest_age_s seconds the oldest queued reading has waited
+ *
+ * @return true if the queued readings should be uploaded now
+ */
+bool app_power_flush_due(uint32_t queued, uint32_t capacity, uint32_t oldest_age_s);
+
+#else
+
+static inline void app_power_update(void)
+{
+}
+
+static inline int32_t app_power_gps_delay_s(int32_t configured_s)
+{
+	return configured_s;
+}
+
+static inline int32_t app_power_loop_delay_s(int32_t configured_s)
+{
+	return configured_s;
+}
+
+static inline uint32_t app_power_sensor_period_s(void)
+{
+	return 1;
+}
+
+static inline uint32_t app_power_recorder_period_ms(uint32_t configured_ms)
+{
+	return configured_ms;
+}
+
+static inline uint32_t app_power_flush_max_age_s(void)
+{
+	return 0;
+}
+
+static inline bool app_power_flush_due(uint32_t queued, uint32_t capacity, uint32_t oldest_age_s)
+{
+	return true;
+}
+
+#endif /* CONFIG_APP_POWER_POLICY */
+
+#endif /* __APP_POWER_H__ */
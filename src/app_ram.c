@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_ram, LOG_LEVEL_DBG);
+
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "app_log_dict.h"
+#include "app_ram.h"
+#include "app_recorder.h"
+#include "app_sensors.h"
+#include "app_workq.h"
+
+/* Upper bound on the entries reported by all subsystems */
+#define MAX_REGIONS 12
+
+#if defined(CONFIG_HEAP_MEM_POOL_SIZE) && (CONFIG_HEAP_MEM_POOL_SIZE > 0) && \
+	defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
+/* k_malloc() pool, defined by the kernel */
+extern struct k_heap _system_heap;
+#endif
+
+/*
+ * The heaps are not app buffers, but they are what the app buffers compete
+ * with for RAM.
+ */
+static size_t heap_ram_usage(struct app_ram_usage *usage, size_t max)
+{
+	size_t n = 0;
+
+#if defined(CONFIG_HEAP_MEM_POOL_SIZE) && (CONFIG_HEAP_MEM_POOL_SIZE > 0)
+	if (n < max) {
+		usage[n] = (struct app_ram_usage){
+			.name = "heap",
+			.size = CONFIG_HEAP_MEM_POOL_SIZE,
+		};
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+		struct sys_memory_stats stats;
+
+		if (sys_heap_runtime_stats_get(&_system_heap.heap, &stats) == 0) {
+			usage[n].used = stats.allocated_bytes;
+			usage[n].peak = stats.max_allocated_bytes;
+		}
+#endif
+		n++;
+	}
+#endif
+
+#ifdef CONFIG_MBEDTLS_ENABLE_HEAP
+	if (n < max) {
+		usage[n++] = (struct app_ram_usage){
+			.name = "mbedtls_heap",
+			.size = CONFIG_MBEDTLS_HEAP_SIZE,
+		};
+	}
+#endif
+
+	return n;
+}
+
+static size_t (*const providers[])(struct app_ram_usage *usage, size_t max) = {
+	app_sensors_ram_usage,
+	app_log_dict_ram_usage,
+	app_recorder_ram_usage,
+	app_workq_ram_usage,
+	heap_ram_usage,
+};
+
+static size_t ram_usage_get(struct app_ram_usage usage[MAX_REGIONS])
+{
+	size_t n = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(providers); i++) {
+		n += providers[i](&usage[n], MAX_REGIONS - n);
+	}
+
+	return n;
+}
+
+void app_ram_log(void)
+{
+	struct app_ram_usage usage[MAX_REGIONS];
+	size_t n = ram_usage_get(usage);
+	uint32_t total = 0;
+
+	for (size_t i = 0; i < n; i++) {
+		LOG_INF("RAM %-16s %6u bytes, %u used, peak %u", usage[i].name, usage[i].size,
+			usage[i].used, usage[i].peak);
+		total += usage[i].size;
+	}
+
+	LOG_INF("RAM total %u bytes", total);
+}
+
+int app_ram_add_to_map(zcbor_state_t *response_detail_map)
+{
+	struct app_ram_usage usage[MAX_REGIONS];
+	size_t n = ram_usage_get(usage);
+	uint32_t total = 0;
+	bool ok = true;
+
+	/* "name": [bytes reserved, bytes used, peak bytes used] */
+	for (size_t i = 0; i < n && ok; i++) {
+		ok = zcbor_tstr_encode_ptr(response_detail_map, usage[i].name,
+					   strlen(usage[i].name)) &&
+		     zcbor_list_start_encode(response_detail_map, 3) &&
+		     zcbor_uint32_put(response_detail_map, usage[i].size) &&
+		     zcbor_uint32_put(response_detail_map, usage[i].used) &&
+		     zcbor_uint32_put(response_detail_map, usage[i].peak) &&
+		     zcbor_list_end_encode(response_detail_map, 3);
+		total += usage[i].size;
+	}
+
+	ok = ok && zcbor_tstr_put_lit(response_detail_map, "total") &&
+	     zcbor_uint32_put(response_detail_map, total);
+
+	return ok ? 0 : -ENOMEM;
+}
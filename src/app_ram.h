@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * RAM budget report.
+ *
+ * App buffers are all allocated statically and sized through Kconfig; the
+ * heap is left to the Golioth SDK and mbedTLS. The buffers which are meant to
+ * be resized per board report what they reserve and how much of it is used,
+ * in the boot log and through the `get_ram_budget` RPC. After each build,
+ * utility/ram_budget.py breaks down the RAM of every subsystem, libraries
+ * included, from the link map.
+ */
+
+#ifndef __APP_RAM_H__
+#define __APP_RAM_H__
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zcbor_encode.h>
+
+struct app_ram_usage {
+	const char *name;
+	uint32_t size; /* bytes reserved at build time */
+	uint32_t used; /* bytes in use now */
+	uint32_t peak; /* most bytes in use since boot; 0 if not tracked */
+};
+
+#ifdef CONFIG_APP_RAM_BUDGET
+
+/**
+ * Log the RAM reserved and used by each app buffer. Called after the first
+ * upload, since before it the buffers have barely been used.
+ */
+void app_ram_log(void);
+
+/** Add the RAM budget to an RPC response map */
+int app_ram_add_to_map(zcbor_state_t *response_detail_map);
+
+#else
+
+static inline void app_ram_log(void)
+{
+}
+
+static inline int app_ram_add_to_map(zcbor_state_t *response_detail_map)
+{
+	return -ENOTSUP;
+}
+
+#endif /* CONFIG_APP_RAM_BUDGET */
+
+#endif /* __APP_RAM_H__ */
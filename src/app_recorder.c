@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_recorder, LOG_LEVEL_DBG);
+
+#include <string.h>
+#include <golioth/stream.h>
+#include <zcbor_encode.h>
+#include <zephyr/kernel.h>
+
+#ifdef CONFIG_DATE_TIME
+#include <date_time.h>
+#endif
+
+#include "app_backlog.h"
+#include "app_ram.h"
+#include "app_recorder.h"
+#include "app_workq.h"
+
+#define RECORDER_ENDP "recorder"
+
+#define PRE_SAMPLES  ((CONFIG_APP_RECORDER_PRE_S * MSEC_PER_SEC) / CONFIG_APP_RECORDER_PERIOD_MS)
+#define POST_SAMPLES ((CONFIG_APP_RECORDER_POST_S * MSEC_PER_SEC) / CONFIG_APP_RECORDER_PERIOD_MS)
+/* The pre-trigger samples, the trigger sample and the post-trigger samples */
+#define RING_SAMPLES (PRE_SAMPLES + 1 + POST_SAMPLES)
+
+/* Room for the CBOR map around the "d" byte string */
+#define BURST_HEADER_SIZE 96
+
+/* Failed sends of a burst before it is dropped; waits for a connection do not count */
+#define BURST_RETRIES	    5
+#define BURST_RETRY_DELAY_S 30
+
+static const char *const trigger_names[] = {
+	[APP_RECORDER_EXCURSION] = "excursion",
+	[APP_RECORDER_BUTTON] = "button",
+	[APP_RECORDER_RPC] = "rpc",
+};
+
+static struct app_recorder_sample ring[RING_SAMPLES];
+/* Samples added since boot; the newest is at (written - 1) % RING_SAMPLES */
+static uint32_t written;
+/* First sample taken at the current period */
+static uint32_t ring_start;
+static bool in_excursion;
+
+/* Sample period set by the power profile, 0 while paused */
+static uint32_t period_ms = CONFIG_APP_RECORDER_PERIOD_MS;
+/* Keeps a trigger and a period change from crossing */
+static struct k_spinlock period_lock;
+
+/* Set from app_recorder_trigger() until the burst is sent or dropped */
+static atomic_t busy;
+/* Trigger reason + 1, picked up with the next sample */
+static atomic_t pending;
+
+/* Capture in progress; only used from the app work queue */
+static struct {
+	bool active;
+	enum app_recorder_trigger reason;
+	uint32_t trigger_at;
+	int64_t uptime_ms;
+	int64_t unix_ms;
+} capture;
+
+static uint8_t deltas[CONFIG_APP_RECORDER_BURST_SIZE];
+static uint8_t burst[CONFIG_APP_RECORDER_BURST_SIZE + BURST_HEADER_SIZE];
+static size_t burst_len;
+static uint8_t burst_retries;
+
+static struct golioth_client *recorder_client;
+
+static void send_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(send_work, send_work_handler);
+
+static bool is_excursion(int16_t tem_centi)
+{
+	return tem_centi != APP_BACKLOG_NO_VALUE &&
+	       (tem_centi < CONFIG_APP_EXCURSION_TEMP_MIN_CENTI ||
+		tem_centi > CONFIG_APP_EXCURSION_TEMP_MAX_CENTI);
+}
+
+/* Append a signed value as a zigzag LEB128 varint; returns false if it does not fit */
+static bool varint_put(uint8_t *buf, size_t size, size_t *len, int32_t value)
+{
+	uint32_t zz = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+
+	do {
+		if (*len >= size) {
+			return false;
+		}
+
+		buf[(*len)++] = (zz & 0x7f) | ((zz > 0x7f) ? 0x80 : 0);
+		zz >>= 7;
+	} while (zz);
+
+	return true;
+}
+
+/* Differences of each sample from the previous one; returns the samples encoded */
+static uint32_t deltas_encode(uint32_t first, uint32_t count, size_t *len)
+{
+	const struct app_recorder_sample *prev = &ring[first % RING_SAMPLES];
+	uint32_t n = 1;
+
+	*len = 0;
+
+	for (; n < count; n++) {
+		const struct app_recorder_sample *s = &ring[(first + n) % RING_SAMPLES];
+		size_t used = *len;
+
+		if (!varint_put(deltas, sizeof(deltas), &used, s->tem_centi - prev->tem_centi) ||
+		    !varint_put(deltas, sizeof(deltas), &used, s->hum_centi - prev->hum_centi) ||
+		    !varint_put(deltas, sizeof(deltas), &used, s->pre_pa - prev->pre_pa)) {
+			break;
+		}
+
+		*len = used;
+		prev = s;
+	}
+
+	return n;
+}
+
+static bool burst_encode(void)
+{
+	uint32_t first = MAX(capture.trigger_at - MIN(capture.trigger_at, PRE_SAMPLES), ring_start);
+	uint32_t count = written - first;
+	size_t deltas_len;
+	uint32_t n = deltas_encode(first, count, &deltas_len);
+	const struct app_recorder_sample *s = &ring[first % RING_SAMPLES];
+	ZCBOR_STATE_E(zse, 2, burst, sizeof(burst), 1);
+
+	if (n < count) {
+		LOG_WRN("Burst truncated to %u of %u samples", n, count);
+	}
+
+	bool ok = zcbor_map_start_encode(zse, 8) && zcbor_tstr_put_lit(zse, "reason") &&
+		  zcbor_tstr_encode_ptr(zse, trigger_names[capture.reason],
+					strlen(trigger_names[capture.reason])) &&
+		  zcbor_tstr_put_lit(zse, "uptime_ms") && zcbor_int64_put(zse, capture.uptime_ms) &&
+		  zcbor_tstr_put_lit(zse, "period_ms") && zcbor_uint32_put(zse, period_ms) &&
+		  zcbor_tstr_put_lit(zse, "pre") &&
+		  zcbor_uint32_put(zse, capture.trigger_at - first) &&
+		  zcbor_tstr_put_lit(zse, "n") && zcbor_uint32_put(zse, n) &&
+		  zcbor_tstr_put_lit(zse, "first") && zcbor_list_start_encode(zse, 3) &&
+		  zcbor_int32_put(zse, s->tem_centi) && zcbor_int32_put(zse, s->hum_centi) &&
+		  zcbor_int32_put(zse, s->pre_pa) && zcbor_list_end_encode(zse, 3) &&
+		  zcbor_tstr_put_lit(zse, "d") &&
+		  zcbor_bstr_encode_ptr(zse, (const char *)deltas, deltas_len);
+
+	/* Unix time of the trigger, when network time is known */
+	if (ok && capture.unix_ms) {
+		ok = zcbor_tstr_put_lit(zse, "time") && zcbor_int64_put(zse, capture.unix_ms);
+	}
+
+	ok = ok && zcbor_map_end_encode(zse, 8);
+
+	burst_len = ok ? zse->payload - burst : 0;
+
+	LOG_INF("Captured %s burst: %u samples in %zu bytes", trigger_names[capture.reason], n,
+		burst_len);
+
+	return ok;
+}
+
+static void burst_sent(struct golioth_client *client, enum golioth_status status,
+		       const struct golioth_coap_rsp_code *coap_rsp_code, const char *path,
+		       void *arg)
+{
+	if (status == GOLIOTH_OK) {
+		atomic_clear(&busy);
+		return;
+	}
+
+	if (++burst_retries > BURST_RETRIES) {
+		LOG_ERR("Giving up sending burst: %d", status);
+		atomic_clear(&busy);
+		return;
+	}
+
+	k_work_schedule_for_queue(&app_work_q, &send_work, K_SECONDS(BURST_RETRY_DELAY_S));
+}
+
+static void send_work_handler(struct k_work *work)
+{
+	if (!recorder_client || !golioth_client_is_connected(recorder_client)) {
+		k_work_schedule_for_queue(&app_work_q, &send_work, K_SECONDS(BURST_RETRY_DELAY_S));
+		return;
+	}
+
+	/* Only one burst is in flight, so the buffer is not touched until it is sent */
+	int err = golioth_stream_set_async(recorder_client, RECORDER_ENDP,
+					   GOLIOTH_CONTENT_TYPE_CBOR, burst, burst_len,
+					   burst_sent, NULL);
+
+	if (err) {
+		burst_sent(recorder_client, GOLIOTH_ERR_FAIL, NULL, RECORDER_ENDP, NULL);
+	}
+}
+
+void app_recorder_set_client(struct golioth_client *client)
+{
+	recorder_client = client;
+}
+
+uint32_t app_recorder_period_set(uint32_t requested_ms)
+{
+	k_spinlock_key_t key = k_spin_lock(&period_lock);
+
+	/* A capture keeps the period it started with until its burst is encoded */
+	if (requested_ms != period_ms && !capture.active && !atomic_get(&pending)) {
+		LOG_INF("Sample period %u -> %u ms", period_ms, requested_ms);
+		period_ms = requested_ms;
+		/* Bursts have a single period, so older samples are not sent */
+		ring_start = written;
+	}
+
+	uint32_t current_ms = period_ms;
+
+	k_spin_unlock(&period_lock, key);
+
+	return current_ms;
+}
+
+void app_recorder_add(const struct app_recorder_sample *sample)
+{
+	ring[written % RING_SAMPLES] = *sample;
+	written++;
+
+	bool excursion = is_excursion(sample->tem_centi);
+
+	if (excursion && !in_excursion) {
+		app_recorder_trigger(APP_RECORDER_EXCURSION);
+	}
+	in_excursion = excursion;
+
+	atomic_val_t reason = atomic_set(&pending, 0);
+
+	if (reason) {
+		capture.active = true;
+		capture.reason = reason - 1;
+		capture.trigger_at = written - 1;
+		capture.uptime_ms = k_uptime_get();
+		capture.unix_ms = 0;
+		IF_ENABLED(CONFIG_DATE_TIME, (
+			if (date_time_now(&capture.unix_ms)) {
+				capture.unix_ms = 0;
+			}
+		));
+		LOG_INF("Recorder triggered by %s", trigger_names[capture.reason]);
+	}
+
+	if (!capture.active || written - capture.trigger_at <= POST_SAMPLES) {
+		return;
+	}
+
+	capture.active = false;
+
+	if (!burst_encode()) {
+		LOG_ERR("Burst does not fit in %zu bytes", sizeof(burst));
+		atomic_clear(&busy);
+		return;
+	}
+
+	burst_retries = 0;
+	k_work_schedule_for_queue(&app_work_q, &send_work, K_NO_WAIT);
+}
+
+int app_recorder_trigger(enum app_recorder_trigger reason)
+{
+	k_spinlock_key_t key = k_spin_lock(&period_lock);
+	int err = 0;
+
+	if (period_ms == 0) {
+		err = -EAGAIN;
+	} else if (!atomic_cas(&busy, 0, 1)) {
+		err = -EBUSY;
+	} else {
+		atomic_set(&pending, reason + 1);
+	}
+
+	k_spin_unlock(&period_lock, key);
+
+	return err;
+}
+
+size_t app_recorder_ram_usage(struct app_ram_usage *usage, size_t max)
+{
+	const struct app_ram_usage regions[] = {
+		{
+			.name = "recorder_ring",
+			.size = sizeof(ring),
+			.used = sizeof(ring[0]) * MIN(written, RING_SAMPLES),
+			.peak = sizeof(ring[0]) * MIN(written, RING_SAMPLES),
+		},
+		{
+			/* Only holds data from a capture until it is sent */
+			.name = "recorder_burst",
+			.size = sizeof(deltas) + sizeof(burst),
+			.used = atomic_get(&busy) ? burst_len : 0,
+		},
+	};
+	size_t count = MIN(max, ARRAY_SIZE(regions));
+
+	memcpy(usage, regions, count * sizeof(regions[0]));
+
+	return count;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Temperature flight recorder.
+ *
+ * The weather sensor is sampled every CONFIG_APP_RECORDER_PERIOD_MS into a
+ * ring in RAM, whatever the reading interval. When a temperature excursion
+ * starts, the user button is pressed or the `record_burst` RPC is called, the
+ * CONFIG_APP_RECORDER_PRE_S before the trigger and the
+ * CONFIG_APP_RECORDER_POST_S after it are streamed to the "recorder" path as
+ * one burst: the first sample, then the difference of each sample from the
+ * previous one as zigzag varints in the "d" byte string. Decode exported
+ * bursts with utility/recorder_decode.py.
+ *
+ * One burst is captured and sent at a time; triggers meanwhile are ignored.
+ * The power policy slows the recorder in the saver profile and pauses it in the
+ * critical profile.
+ */
+
+#ifndef __APP_RECORDER_H__
+#define __APP_RECORDER_H__
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <golioth/client.h>
+
+enum app_recorder_trigger {
+	APP_RECORDER_EXCURSION,
+	APP_RECORDER_BUTTON,
+	APP_RECORDER_RPC,
+};
+
+/** One sample; values not available are APP_BACKLOG_NO_VALUE */
+struct app_recorder_sample {
+	int16_t tem_centi; /* degrees Celsius * 100 */
+	int16_t hum_centi; /* %RH * 100 */
+	int32_t pre_pa;
+};
+
+struct app_ram_usage;
+
+#ifdef CONFIG_APP_RECORDER
+
+/** Send bursts with this client */
+void app_recorder_set_client(struct golioth_client *client);
+
+/**
+ * Change the sample period. A capture in progress keeps its period until its
+ * burst is encoded; otherwise samples taken at the previous period are
+ * discarded. Called from the app work queue before each sample.
+ *
+ * @param requested_ms new period, 0 to pause the recorder
+ *
+ * @return the period in effect, 0 if paused
+ */
+uint32_t app_recorder_period_set(uint32_t requested_ms);
+
+/**
+ * Add the latest sample. Called once per period from the app work queue;
+ * starts a capture when a temperature excursion begins.
+ */
+void app_recorder_add(const struct app_recorder_sample *sample);
+
+/**
+ * Capture a burst around the next sample. Safe to call from an ISR.
+ *
+ * @return 0 on success, -EBUSY while a burst is being captured or sent,
+ *	   -EAGAIN while the recorder is paused
+ */
+int app_recorder_trigger(enum app_recorder_trigger reason);
+
+/**
+ * Report the RAM of the sample ring and the burst buffer.
+ *
+ * @return number of entries filled, at most max
+ */
+size_t app_recorder_ram_usage(struct app_ram_usage *usage, size_t max);
+
+#else
+
+static inline void app_recorder_set_client(struct golioth_client *client)
+{
+}
+
+static inline uint32_t app_recorder_period_set(uint32_t requested_ms)
+{
+	return 0;
+}
+
+static inline void app_recorder_add(const struct app_recorder_sample *sample)
+{
+}
+
+static inline int app_recorder_trigger(enum app_recorder_trigger reason)
+{
+	return -ENOTSUP;
+}
+
+static inline size_t app_recorder_ram_usage(struct app_ram_usage *usage, size_t max)
+{
+	return 0;
+}
+
+#endif /* CONFIG_APP_RECORDER */
+
+#endif /* __APP_RECORDER_H__ */
@@ -16,7 +16,24 @@ LOG_MODULE_REGISTER(app_rpc, LOG_LEVEL_DBG);
 #include <network_info.h>
 #endif
 
+#include "app_boot.h"
+#include "app_energy.h"
+#include "app_gnss_aid.h"
+#include "app_history.h"
+#include "app_live_track.h"
+#include "app_log_dict.h"
+#include "app_metrics.h"
+#include "app_payloads.h"
+#include "app_ram.h"
+#include "app_recorder.h"
 #include "app_rpc.h"
+#include "app_sensors.h"
+
+/* Points returned by fetch_readings when max_points is not given */
+#define FETCH_READINGS_DEFAULT_POINTS 500
+
+/* Seconds between readings of live_track when interval_s is not given */
+#define LIVE_TRACK_DEFAULT_INTERVAL_S 5
 
 static void reboot_work_handler(struct k_work *work)
 {
@@ -27,6 +44,9 @@ static void reboot_work_handler(struct k_work *work)
 		k_sleep(K_SECONDS(1));
 	}
 
+	/* Let the GNSS receiver start with a known time after reboot */
+	app_gnss_aid_save();
+
 	/* Sync logs before reboot */
 	LOG_PANIC();
 
@@ -34,6 +54,12 @@ static void reboot_work_handler(struct k_work *work)
 }
 K_WORK_DEFINE(reboot_work, reboot_work_handler);
 
+/* Queued readings have been uploaded or saved to flash; reboot */
+static void reboot_shutdown_done(int err, uint32_t sent, uint32_t saved)
+{
+	k_work_submit(&reboot_work);
+}
+
 static enum golioth_rpc_status on_get_network_info(zcbor_state_t *request_params_array,
 						   zcbor_state_t *response_detail_map,
 						   void *callback_arg)
@@ -47,26 +73,25 @@ static enum golioth_rpc_status on_set_log_level(zcbor_state_t *request_params_ar
 						zcbor_state_t *response_detail_map,
 						void *callback_arg)
 {
-	double param_0;
+	struct app_set_log_level_params params;
 	uint8_t log_level;
 	bool ok;
 
 	LOG_WRN("on_set_log_level");
 
-	ok = zcbor_float_decode(request_params_array, &param_0);
-	if (!ok) {
+	if (app_codec_cbor_list_decode(&app_set_log_level_params_schema, request_params_array,
+				       &params) < 0) {
 		LOG_ERR("Failed to decode array item");
 		return GOLIOTH_RPC_INVALID_ARGUMENT;
 	}
 
-	log_level = (uint8_t)param_0;
-
-	if ((log_level < 0) || (log_level > LOG_LEVEL_DBG)) {
-
-		LOG_ERR("Requested log level is out of bounds: %d", log_level);
+	if (!IN_RANGE(params.level, LOG_LEVEL_NONE, LOG_LEVEL_DBG)) {
+		LOG_ERR("Requested log level is out of bounds: %d", params.level);
 		return GOLIOTH_RPC_INVALID_ARGUMENT;
 	}
 
+	log_level = params.level;
+
 	int source_id = 0;
 	char *source_name;
 
@@ -91,10 +116,174 @@ static enum golioth_rpc_status on_set_log_level(zcbor_state_t *request_params_ar
 static enum golioth_rpc_status on_reboot(zcbor_state_t *request_params_array,
 					 zcbor_state_t *response_detail_map, void *callback_arg)
 {
-	/* Use work queue so this RPC can return confirmation to Golioth */
-	k_work_submit(&reboot_work);
+	/* This runs in the Golioth client thread, which has to carry the uploads; reply first,
+	 * then upload queued readings and save the rest to flash from the upload work queue
+	 */
+	int queued = app_sensors_shutdown_async(CONFIG_APP_SHUTDOWN_FLUSH_TIMEOUT_MS,
+						reboot_shutdown_done);
 
-	return GOLIOTH_RPC_OK;
+	if (queued < 0) {
+		return GOLIOTH_RPC_UNAVAILABLE;
+	}
+
+	bool ok = zcbor_tstr_put_lit(response_detail_map, "queued") &&
+		  zcbor_uint32_put(response_detail_map, queued);
+
+	return ok ? GOLIOTH_RPC_OK : GOLIOTH_RPC_RESOURCE_EXHAUSTED;
+}
+
+static enum golioth_rpc_status on_get_boot_times(zcbor_state_t *request_params_array,
+						 zcbor_state_t *response_detail_map,
+						 void *callback_arg)
+{
+	int err = app_boot_add_to_map(response_detail_map);
+
+	return err ? GOLIOTH_RPC_RESOURCE_EXHAUSTED : GOLIOTH_RPC_OK;
+}
+
+static enum golioth_rpc_status on_get_perf_stats(zcbor_state_t *request_params_array,
+						 zcbor_state_t *response_detail_map,
+						 void *callback_arg)
+{
+	int err = app_metrics_add_to_map(response_detail_map);
+
+	if (err == -ENOTSUP) {
+		return GOLIOTH_RPC_UNIMPLEMENTED;
+	}
+
+	return err ? GOLIOTH_RPC_RESOURCE_EXHAUSTED : GOLIOTH_RPC_OK;
+}
+
+static enum golioth_rpc_status on_get_ram_budget(zcbor_state_t *request_params_array,
+						 zcbor_state_t *response_detail_map,
+						 void *callback_arg)
+{
+	int err = app_ram_add_to_map(response_detail_map);
+
+	if (err == -ENOTSUP) {
+		return GOLIOTH_RPC_UNIMPLEMENTED;
+	}
+
+	return err ? GOLIOTH_RPC_RESOURCE_EXHAUSTED : GOLIOTH_RPC_OK;
+}
+
+static enum golioth_rpc_status on_get_latency(zcbor_state_t *request_params_array,
+					      zcbor_state_t *response_detail_map,
+					      void *callback_arg)
+{
+	int err = app_metrics_latency_add_to_map(response_detail_map);
+
+	if (err == -ENOTSUP) {
+		return GOLIOTH_RPC_UNIMPLEMENTED;
+	}
+
+	return err ? GOLIOTH_RPC_RESOURCE_EXHAUSTED : GOLIOTH_RPC_OK;
+}
+
+static enum golioth_rpc_status on_get_energy(zcbor_state_t *request_params_array,
+					     zcbor_state_t *response_detail_map,
+					     void *callback_arg)
+{
+	int err = app_energy_add_to_map(response_detail_map);
+
+	if (err == -ENOTSUP) {
+		return GOLIOTH_RPC_UNIMPLEMENTED;
+	}
+
+	return err ? GOLIOTH_RPC_RESOURCE_EXHAUSTED : GOLIOTH_RPC_OK;
+}
+
+static enum golioth_rpc_status on_get_log_stats(zcbor_state_t *request_params_array,
+						zcbor_state_t *response_detail_map,
+						void *callback_arg)
+{
+	int err = app_log_dict_add_to_map(response_detail_map);
+
+	if (err == -ENOTSUP) {
+		return GOLIOTH_RPC_UNIMPLEMENTED;
+	}
+
+	return err ? GOLIOTH_RPC_RESOURCE_EXHAUSTED : GOLIOTH_RPC_OK;
+}
+
+static enum golioth_rpc_status on_fetch_readings(zcbor_state_t *request_params_array,
+						 zcbor_state_t *response_detail_map,
+						 void *callback_arg)
+{
+	struct app_fetch_readings_params params = {.max_points = FETCH_READINGS_DEFAULT_POINTS};
+
+	if (app_codec_cbor_list_decode(&app_fetch_readings_params_schema, request_params_array,
+				       &params) < 0) {
+		LOG_ERR("fetch_readings needs a start and end time (Unix seconds)");
+		return GOLIOTH_RPC_INVALID_ARGUMENT;
+	}
+
+	if (!IN_RANGE(params.max_points, 1, UINT16_MAX)) {
+		return GOLIOTH_RPC_INVALID_ARGUMENT;
+	}
+
+	int err = app_history_fetch(params.start_s * MSEC_PER_SEC,
+				    params.end_s * MSEC_PER_SEC + 999, params.max_points,
+				    response_detail_map);
+
+	switch (err) {
+	case 0:
+		return GOLIOTH_RPC_OK;
+	case -ENOTSUP:
+		return GOLIOTH_RPC_UNIMPLEMENTED;
+	case -EINVAL:
+		return GOLIOTH_RPC_INVALID_ARGUMENT;
+	case -EBUSY:
+	case -ENODEV:
+		return GOLIOTH_RPC_UNAVAILABLE;
+	default:
+		return GOLIOTH_RPC_RESOURCE_EXHAUSTED;
+	}
+}
+
+static enum golioth_rpc_status on_record_burst(zcbor_state_t *request_params_array,
+					       zcbor_state_t *response_detail_map,
+					       void *callback_arg)
+{
+	int err = app_recorder_trigger(APP_RECORDER_RPC);
+
+	switch (err) {
+	case 0:
+		return GOLIOTH_RPC_OK;
+	case -ENOTSUP:
+		return GOLIOTH_RPC_UNIMPLEMENTED;
+	case -EBUSY:
+	case -EAGAIN:
+		return GOLIOTH_RPC_UNAVAILABLE;
+	default:
+		return GOLIOTH_RPC_RESOURCE_EXHAUSTED;
+	}
+}
+
+static enum golioth_rpc_status on_live_track(zcbor_state_t *request_params_array,
+					     zcbor_state_t *response_detail_map,
+					     void *callback_arg)
+{
+	struct app_live_track_params params = {.interval_s = LIVE_TRACK_DEFAULT_INTERVAL_S};
+
+	if (app_codec_cbor_list_decode(&app_live_track_params_schema, request_params_array,
+				       &params) < 0) {
+		LOG_ERR("live_track needs a duration (seconds, 0 to stop)");
+		return GOLIOTH_RPC_INVALID_ARGUMENT;
+	}
+
+	int err = app_live_track_start(params.duration_s, params.interval_s, response_detail_map);
+
+	switch (err) {
+	case 0:
+		return GOLIOTH_RPC_OK;
+	case -ENOTSUP:
+		return GOLIOTH_RPC_UNIMPLEMENTED;
+	case -EINVAL:
+		return GOLIOTH_RPC_INVALID_ARGUMENT;
+	default:
+		return GOLIOTH_RPC_RESOURCE_EXHAUSTED;
+	}
 }
 
 static void rpc_log_if_register_failure(int err)
@@ -118,4 +307,31 @@ void app_rpc_register(struct golioth_client *client)
 
 	err = golioth_rpc_register(rpc, "set_log_level", on_set_log_level, NULL);
 	rpc_log_if_register_failure(err);
+
+	err = golioth_rpc_register(rpc, "get_boot_times", on_get_boot_times, NULL);
+	rpc_log_if_register_failure(err);
+
+	err = golioth_rpc_register(rpc, "get_perf_stats", on_get_perf_stats, NULL);
+	rpc_log_if_register_failure(err);
+
+	err = golioth_rpc_register(rpc, "get_ram_budget", on_get_ram_budget, NULL);
+	rpc_log_if_register_failure(err);
+
+	err = golioth_rpc_register(rpc, "get_latency", on_get_latency, NULL);
+	rpc_log_if_register_failure(err);
+
+	err = golioth_rpc_register(rpc, "get_energy", on_get_energy, NULL);
+	rpc_log_if_register_failure(err);
+
+	err = golioth_rpc_register(rpc, "get_log_stats", on_get_log_stats, NULL);
+	rpc_log_if_register_failure(err);
+
+	err = golioth_rpc_register(rpc, "fetch_readings", on_fetch_readings, NULL);
+	rpc_log_if_register_failure(err);
+
+	err = golioth_rpc_register(rpc, "record_burst", on_record_burst, NULL);
+	rpc_log_if_register_failure(err);
+
+	err = golioth_rpc_register(rpc, "live_track", on_live_track, NULL);
+	rpc_log_if_register_failure(err);
 }
@@ -13,6 +13,10 @@
  * - `reboot`: reboot the device (no arguments)
  * - `set_log_level`: adjust the logging level for all registered modules (valid
  *   argument values: 0..4)
+ * - `get_boot_times`: return the uptime (ms) at which each boot phase was reached
+ * - `get_perf_stats`: return queue, upload and per-thread CPU/stack metrics
+ * - `get_latency`: return per-stage latency histograms of the reading pipeline
+ * - `get_energy`: return estimated modem, GNSS and CPU charge per reading and byte
  *
  * https://docs.golioth.io/firmware/zephyr-device-sdk/remote-procedure-call
  */
@@ -10,21 +10,34 @@ LOG_MODULE_REGISTER(app_sensors, LOG_LEVEL_DBG);
 #include <golioth/client.h>
 #include <golioth/stream.h>
 #include <zephyr/device.h>
-#include <zephyr/drivers/gpio.h>
 #include <zephyr/kernel.h>
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/drivers/uart.h>
 #include <zephyr/zbus/zbus.h>
 
+#include "app_backlog.h"
+#include "app_boot.h"
+#include "app_cadence.h"
+#include "app_decimate.h"
+#include "app_geofence.h"
+#include "app_gnss.h"
+#include "app_gnss_aid.h"
+#include "app_history.h"
+#include "app_live_track.h"
+#include "app_metrics.h"
+#include "app_payloads.h"
+#include "app_power.h"
+#include "app_ram.h"
+#include "app_recorder.h"
 #include "app_sensors.h"
 #include "app_settings.h"
+#include "app_workq.h"
 #include "lib/minmea/minmea.h"
 #include <stdio.h>
 #include <stdlib.h>
 
 #ifdef CONFIG_LIB_OSTENTUS
-#include <libostentus.h>
-static const struct device *o_dev = DEVICE_DT_GET_ANY(golioth_ostentus);
+#include "app_display.h"
 #endif
 #ifdef CONFIG_ALUDEL_BATTERY_MONITOR
 #include <battery_monitor.h>
@@ -33,15 +46,17 @@ static const struct device *o_dev = DEVICE_DT_GET_ANY(golioth_ostentus);
 #define UART_DEVICE_NODE DT_ALIAS(click_uart)
 static const struct device *const uart_dev = DEVICE_DT_GET(UART_DEVICE_NODE);
 
-#define UART_SEL DT_ALIAS(gnss7_sel)
-static const struct gpio_dt_spec gnss7_sel = GPIO_DT_SPEC_GET(UART_SEL, gpios);
-
-#define MAX_BATCH_STREAM_SIZE 1000
-#define MIN_REMAINING_FOR_BATCH_UPLOAD 128
+#define MAX_BATCH_STREAM_SIZE CONFIG_APP_UPLOAD_BUF_SIZE
+/* Longest reading in a batch, see APP_READING_FIELDS */
+#define READING_JSON_MAX APP_CODEC_JSON_MAX(APP_READING_FIELDS)
 #define NMEA_SIZE 128
 
 /* Max number of parsed readings to queue between uploads (96 bytes each) */
-#define MAX_QUEUED_DATA 500
+#define MAX_QUEUED_DATA CONFIG_APP_READING_QUEUE_DEPTH
+/* Queue depth at which an upload starts right away instead of at the loop delay */
+#define FLUSH_WATERMARK ((MAX_QUEUED_DATA * 3) / 4)
+/* Smallest oldest segment worth thinning when the queue is full */
+#define THIN_MIN_SEGMENT 8
 #define GPS_BATCH_STREAM_TIMEOUT_S 2
 
 /* GPS stream endpoint on Golioth */
@@ -56,6 +71,23 @@ struct weather_data {
 struct cold_chain_data {
 	struct weather_data weather;
 	struct minmea_sentence_rmc frame;
+#ifdef CONFIG_APP_METRICS_LATENCY
+	/* Uptime (ms) when the sentence was received and queued; 0 if restored from flash */
+	uint32_t rx_ms;
+	uint32_t enqueue_ms;
+#endif
+};
+
+/* NMEA sentence passed from the UART ISR to the parser work */
+struct nmea_msg {
+	char text[NMEA_SIZE];
+	uint32_t rx_cyc;
+	uint32_t rx_ms;
+};
+
+struct nmea_rx {
+	struct nmea_msg msg;
+	size_t pos;
 };
 
 #define ERROR_VAL1 999
@@ -68,27 +100,46 @@ ZBUS_CHAN_DEFINE(weather_chan, struct weather_data, NULL, NULL, ZBUS_OBS_DECLARE
 
 static const struct sensor_value reading_error = {.val1 = ERROR_VAL1, .val2 = ERROR_VAL2};
 
+#if defined(CONFIG_APP_READING_OVERFLOW_LTTB)
+#define OVERFLOW_POLICY APP_DECIMATE_LTTB
+#elif defined(CONFIG_APP_READING_OVERFLOW_THIN)
+#define OVERFLOW_POLICY APP_DECIMATE_EVERY_OTHER
+#else
+#define OVERFLOW_POLICY APP_DECIMATE_NONE
+#endif
+
 /* Processed data waiting to be sent to Golioth */
 K_MSGQ_DEFINE(coldchain_msgq, sizeof(struct cold_chain_data), MAX_QUEUED_DATA, 4);
 
-static char rx_buf[NMEA_SIZE];
-static int rx_buf_pos;
+/* Sentence being framed by the UART ISR */
+static struct nmea_rx uart_rx;
 
 static struct golioth_client *client;
+
+/* Set by app_sensors_shutdown() so no new readings are queued */
+static atomic_t sampling_stopped;
+
+/* Serializes uploads and checkpoints of coldchain_msgq */
+K_MUTEX_DEFINE(upload_mutex);
+
+/* JSON batch being uploaded; only used with upload_mutex held */
+static char upload_buf[MAX_BATCH_STREAM_SIZE];
+BUILD_ASSERT(MAX_BATCH_STREAM_SIZE >= READING_JSON_MAX + 3,
+	     "A batch must fit at least one reading, its brackets and the NUL");
+static uint32_t upload_buf_peak;
+
 /* Add Sensor structs here */
 const struct device *weather_dev;
 
-/* Thread reads weather sensor and publishes latest data on zbus */
-K_SEM_DEFINE(bme280_initialized_sem, 0, 1); /* Wait until sensor is ready */
-
-void weather_sensor_data_fetch(void)
+/* Reads the weather sensor and publishes the latest data on zbus */
+int weather_sensor_data_fetch(void)
 {
 	int err;
 
 	err = sensor_sample_fetch(weather_dev);
 	if (err != 0) {
 		LOG_ERR("Failed to fetch sensor data: %d", err);
-		return;
+		return err;
 	}
 
 	struct weather_data reading;
@@ -96,43 +147,30 @@ void weather_sensor_data_fetch(void)
 	err = sensor_channel_get(weather_dev, SENSOR_CHAN_AMBIENT_TEMP, &reading.tem);
 	if (err != 0) {
 		LOG_ERR("Failed to get sensor channel %u: %d", SENSOR_CHAN_AMBIENT_TEMP, err);
-		return;
+		return err;
 	}
 
 	err = sensor_channel_get(weather_dev, SENSOR_CHAN_PRESS, &reading.pre);
 	if (err != 0) {
 		LOG_ERR("Failed to get sensor channel %u: %d", SENSOR_CHAN_PRESS, err);
-		return;
+		return err;
 	}
 
 	err = sensor_channel_get(weather_dev, SENSOR_CHAN_HUMIDITY, &reading.hum);
 	if (err != 0) {
 		LOG_ERR("Failed to get sensor channel %u: %d", SENSOR_CHAN_HUMIDITY, err);
-		return;
+		return err;
 	}
 
 	err = zbus_chan_pub(&weather_chan, &reading, K_MSEC(100));
 	if (err != 0) {
 		LOG_ERR("Failed to publish sensor data: %d", err);
-		return;
+		return err;
 	}
-}
-
-#define WEATHER_STACK 1024
 
-extern void weather_sensor_thread(void *d0, void *d1, void *d2)
-{
-	/* Block until sensor is available */
-	k_sem_take(&bme280_initialized_sem, K_FOREVER);
-	while (1) {
-		weather_sensor_data_fetch();
-		k_sleep(K_SECONDS(1));
-	}
+	return 0;
 }
 
-K_THREAD_DEFINE(weather_sensor_tid, WEATHER_STACK, weather_sensor_thread, NULL, NULL, NULL,
-		K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
-
 /** @brief Check if a given time delay has passed
  *
  * The stored start time is used to generate a delta time from the system clock. If the delta time
@@ -162,117 +200,342 @@ static bool target_time_elapsed(uint64_t *stored_start_time, uint32_t delay_s,
 	return false;
 }
 
+/* Uptime (ms) of the last weather sample */
+static uint64_t last_weather_ms;
+
+/*
+ * Sample the weather sensor if the last sample is older than the sensor period
+ * of the power profile. Called when a reading is about to be stored, so the
+ * sensor is only read when its values are used.
+ */
+static void weather_sensor_refresh(void)
+{
+	if (!weather_dev) {
+		return;
+	}
+
+	if (target_time_elapsed(&last_weather_ms, app_power_sensor_period_s(), true)) {
+		weather_sensor_data_fetch();
+	}
+}
+
+#ifdef CONFIG_APP_RECORDER
+static void recorder_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(recorder_work, recorder_work_handler);
+
+/* Uptime (ms) the next flight recorder sample is due */
+static int64_t recorder_next_ms;
+
+/* Sample the weather sensor for the flight recorder at the period of the power profile */
+static void recorder_work_handler(struct k_work *work)
+{
+	struct app_recorder_sample sample = {
+		.tem_centi = APP_BACKLOG_NO_VALUE,
+		.hum_centi = APP_BACKLOG_NO_VALUE,
+		.pre_pa = APP_BACKLOG_NO_VALUE,
+	};
+	struct weather_data w;
+
+	app_metrics_inc(APP_METRICS_WORKQ_RUNS);
+
+	uint32_t period_ms = app_power_recorder_period_ms(CONFIG_APP_RECORDER_PERIOD_MS);
+
+	/* A capture in progress keeps the period it started with */
+	period_ms = app_recorder_period_set(period_ms);
+
+	if (!period_ms) {
+		/* Paused; recorder_resume() restarts sampling */
+		return;
+	}
+
+	/* Absolute deadlines, so the sample rate does not drift with the work done */
+	recorder_next_ms = MAX(recorder_next_ms + period_ms, k_uptime_get());
+	k_work_schedule_for_queue(&app_work_q, &recorder_work, K_TIMEOUT_ABS_MS(recorder_next_ms));
+
+	/* Readings stored meanwhile use this sample rather than reading the sensor again */
+	last_weather_ms = k_uptime_get();
+
+	if (weather_sensor_data_fetch() == 0 &&
+	    zbus_chan_read(&weather_chan, &w, K_MSEC(50)) == 0) {
+		sample.tem_centi = w.tem.val1 * 100 + w.tem.val2 / 10000;
+		sample.hum_centi = w.hum.val1 * 100 + w.hum.val2 / 10000;
+		/* Pressure is reported in kPa */
+		sample.pre_pa = w.pre.val1 * 1000 + w.pre.val2 / 1000;
+	}
+
+	app_recorder_add(&sample);
+}
+
+/* Restart sampling after the power profile stops pausing the recorder */
+static void recorder_resume(void)
+{
+	if (weather_dev && app_power_recorder_period_ms(CONFIG_APP_RECORDER_PERIOD_MS)) {
+		/* Does nothing while the next sample is already scheduled */
+		k_work_schedule_for_queue(&app_work_q, &recorder_work, K_NO_WAIT);
+	}
+}
+#endif /* CONFIG_APP_RECORDER */
+
 #ifdef CONFIG_LIB_OSTENTUS
-static void update_ostentus_gps(float lat, float lon, char *tem_str, char tem_len)
+static void format_udeg(char *buf, size_t len, int32_t udeg)
+{
+	uint32_t abs_udeg = (udeg < 0) ? -(int64_t)udeg : udeg;
+
+	snprintk(buf, len, "%s%u.%06u", (udeg < 0) ? "-" : "", abs_udeg / 1000000,
+		 abs_udeg % 1000000);
+}
+
+/* Only publishes the values; the display worker performs the (slow) I2C writes */
+static void update_ostentus_gps(const struct minmea_sentence_rmc *frame, const char *tem_str)
 {
 	char lat_str[12];
 	char lon_str[12];
 
-	snprintk(lat_str, sizeof(lat_str), "%f", (double) lat);
-	snprintk(lon_str, sizeof(lon_str), "%f", (double) lon);
+	format_udeg(lat_str, sizeof(lat_str), app_gnss_coord_udeg(&frame->latitude));
+	format_udeg(lon_str, sizeof(lon_str), app_gnss_coord_udeg(&frame->longitude));
 
-	ostentus_slide_set(o_dev, SLIDE_LAT, lat_str, strlen(lat_str));
-	ostentus_slide_set(o_dev, SLIDE_LON, lon_str, strlen(lon_str));
-	ostentus_slide_set(o_dev, SLIDE_TEM, tem_str, tem_len);
+	app_display_slide_set(SLIDE_LAT, lat_str);
+	app_display_slide_set(SLIDE_LON, lon_str);
+	app_display_slide_set(SLIDE_TEM, tem_str);
 }
 #endif
 
 /* Raw string data waiting for the NMEA parser to run */
-K_MSGQ_DEFINE(reading_msgq, NMEA_SIZE, 16, 4);
+K_MSGQ_DEFINE(reading_msgq, sizeof(struct nmea_msg), CONFIG_APP_NMEA_QUEUE_DEPTH, 4);
+
+/* Sentences the UART ISR could not queue, logged by the parser */
+static atomic_t nmea_dropped;
+
+/* Set while the receiver reports a valid fix; read by the UART ISR */
+static atomic_t sat_lock;
+
+/* timestamp when the previous GPS value was stored */
+static uint64_t last_gps;
+
+/* timestamp when the previous satellite lock message was sent */
+static uint64_t last_sat_msg;
+
+static void record_from_data(const struct cold_chain_data *data, struct app_backlog_record *rec);
+static void history_record(const struct cold_chain_data *data);
+static void flush_schedule(uint32_t queued);
+static uint32_t readings_overflow(void);
+static int live_send(const struct cold_chain_data *data, uint32_t rx_ms);
 
-#define PARSER_STACK 1024
+/* Whether a fix is due to be stored: at the live tracking interval, else by the cadence */
+static bool reading_due(const struct minmea_sentence_rmc *frame)
+{
+	uint32_t live_interval_s = app_live_track_interval_s();
+
+	if (live_interval_s > 0) {
+		return target_time_elapsed(&last_gps, live_interval_s, true);
+	}
+
+#ifdef CONFIG_APP_GPS_CADENCE
+	/* Adaptive interval elapsed or significant movement */
+	return app_cadence_should_store(frame, app_power_gps_delay_s(get_gps_delay_s()));
+#else
+	return target_time_elapsed(&last_gps, app_power_gps_delay_s(get_gps_delay_s()), true);
+#endif
+}
 
-extern void nmea_parser_thread(void *d0, void *d1, void *d2)
+static void nmea_parse(const struct nmea_msg *msg)
 {
-	char raw_readings[NMEA_SIZE];
+	const char *raw_readings = msg->text;
 	enum minmea_sentence_id sid;
-	bool sat_lock = false;
 	int err;
 
-	/* timestamp when the previous GPS value was stored */
-	uint64_t last_gps = 0;
+	uint32_t parse_cyc = k_cycle_get_32();
 
-	/* timestamp when the previous satellite lock message was sent */
-	uint64_t last_sat_msg = 0;
+	app_metrics_hist_record(APP_METRICS_HIST_RX_TO_PARSE_US,
+				k_cyc_to_us_floor32(parse_cyc - msg->rx_cyc));
+
+	if (atomic_get(&sampling_stopped)) {
+		return;
+	}
 
-	while (1) {
-		k_msgq_get(&reading_msgq, &raw_readings, K_FOREVER);
-		sid = minmea_sentence_id(raw_readings, false);
+	sid = minmea_sentence_id(raw_readings, false);
 
-		if (!sat_lock && sid == MINMEA_SENTENCE_GSV) {
+	if (!atomic_get(&sat_lock) && sid == MINMEA_SENTENCE_GSV) {
 
-			if (target_time_elapsed(&last_sat_msg, 3, true)) {
-				struct minmea_sentence_gsv lock_frame;
+		if (target_time_elapsed(&last_sat_msg, 3, true)) {
+			struct minmea_sentence_gsv lock_frame;
 
-				minmea_parse_gsv(&lock_frame, raw_readings);
-				LOG_INF("Awaiting GPS lock. Satellite count: %d",
-					lock_frame.total_sats);
-			}
+			minmea_parse_gsv(&lock_frame, raw_readings);
+			LOG_INF("Awaiting GPS lock. Satellite count: %d",
+				lock_frame.total_sats);
 		}
+	}
 
-		if (sid != MINMEA_SENTENCE_RMC) {
-			/* We only care about RMC sentences because that's the data we need */
-			continue;
-		}
+	if (sid != MINMEA_SENTENCE_RMC) {
+		/* We only care about RMC sentences because that's the data we need */
+		app_metrics_inc(APP_METRICS_NMEA_FILTERED);
+		return;
+	}
 
-		struct cold_chain_data cc_data;
-		bool success = minmea_parse_rmc(&cc_data.frame, raw_readings);
+	struct cold_chain_data cc_data;
+	bool success = minmea_parse_rmc(&cc_data.frame, raw_readings);
 
-		if (!success) {
-			/* Failed to partse NMEA sentence */
-			continue;
+	if (!success) {
+		/* Failed to partse NMEA sentence */
+		app_metrics_inc(APP_METRICS_PARSE_FAILED);
+		return;
+	}
+
+	atomic_set(&sat_lock, cc_data.frame.valid);
+
+	if (!cc_data.frame.valid) {
+		app_metrics_inc(APP_METRICS_NMEA_FILTERED);
+		return;
+	}
+
+	app_boot_mark(APP_BOOT_FIRST_FIX);
+	app_gnss_aid_fix_update(&cc_data.frame);
+
+	IF_ENABLED(CONFIG_APP_GEOFENCE, (app_geofence_evaluate(&cc_data.frame);));
+
+	if (!reading_due(&cc_data.frame)) {
+		app_metrics_inc(APP_METRICS_NMEA_FILTERED);
+		return;
+	}
+
+	weather_sensor_refresh();
+
+	err = zbus_chan_read(&weather_chan, &cc_data.weather, K_MSEC(50));
+	if (err) {
+		LOG_ERR("Cannot access weather data: %d", err);
+		/* Use an obvious error value so these are not used uninitialized */
+		cc_data.weather.tem = reading_error;
+		cc_data.weather.pre = reading_error;
+		cc_data.weather.hum = reading_error;
+	}
+
+	IF_ENABLED(CONFIG_APP_METRICS_LATENCY, (
+		cc_data.rx_ms = msg->rx_ms;
+		cc_data.enqueue_ms = k_uptime_get_32();
+	));
+
+	/* During live tracking each reading is streamed on its own, bypassing the queue */
+	bool streamed = app_live_track_interval_s() > 0 && live_send(&cc_data, msg->rx_ms) == 0;
+
+	if (streamed) {
+		err = 0;
+	} else {
+		/* Don't hold up parsing waiting for an upload to make space; thin instead */
+		err = k_msgq_put(&coldchain_msgq, &cc_data, K_NO_WAIT);
+		if (err == -ENOMSG && readings_overflow() > 0) {
+			err = k_msgq_put(&coldchain_msgq, &cc_data, K_NO_WAIT);
 		}
+	}
 
-		sat_lock = cc_data.frame.valid;
+	/* The history is kept whether or not the reading could be queued for upload */
+	history_record(&cc_data);
 
-		if (!sat_lock) {
-			continue;
+	if (err) {
+		LOG_ERR("Unable to queue parsed coldchain data: %d", err);
+		app_metrics_inc(APP_METRICS_READINGS_DROPPED);
+	} else {
+		app_boot_mark(APP_BOOT_FIRST_RECORD);
+		if (!streamed) {
+			app_metrics_inc(APP_METRICS_READINGS_QUEUED);
 		}
 
-		if (!target_time_elapsed(&last_gps, get_gps_delay_s(), true)) {
-			/* gps_delay_s has not elapsed since last reading */
-			continue;
+		app_metrics_hist_record(APP_METRICS_HIST_PARSE_US,
+					k_cyc_to_us_floor32(k_cycle_get_32() - parse_cyc));
+		app_metrics_trace("reading_queued", msg->rx_ms, k_uptime_get_32());
+
+		char tem_str[12];
+
+		snprintk(tem_str, sizeof(tem_str), "%d.%02dc", cc_data.weather.tem.val1,
+			 cc_data.weather.tem.val2 / 10000);
+
+		LOG_DBG("nmea: %s t: %s", raw_readings, tem_str);
+
+		IF_ENABLED(CONFIG_LIB_OSTENTUS, (
+			update_ostentus_gps(&cc_data.frame, tem_str);
+		));
+
+		if (streamed) {
+			return;
 		}
 
-		err = zbus_chan_read(&weather_chan, &cc_data.weather, K_MSEC(50));
-		if (err) {
-			LOG_ERR("Cannot access weather data: %d", err);
-			/* Use an obvious error value so these are not used uninitialized */
-			cc_data.weather.tem = reading_error;
-			cc_data.weather.pre = reading_error;
-			cc_data.weather.hum = reading_error;
+		uint32_t msg_cnt = k_msgq_num_used_get(&coldchain_msgq);
+
+		app_metrics_hwm_update(APP_METRICS_HWM_COLDCHAIN_MSGQ, msg_cnt);
+
+		if (msg_cnt > 0 && (msg_cnt % 5 == 0)) {
+			LOG_INF("%d readings queued; %d slots remain", msg_cnt,
+				MAX_QUEUED_DATA - msg_cnt);
 		}
 
-		err = k_msgq_put(&coldchain_msgq, &cc_data, K_MSEC(1));
+		flush_schedule(msg_cnt);
+	}
+}
 
-		if (err) {
-			LOG_ERR("Unable to queue parsed coldchain data: %d", err);
-		} else {
-			char tem_str[12];
+/* Parse every sentence the ISR has queued since the last run */
+static void nmea_parse_work_handler(struct k_work *work)
+{
+	struct nmea_msg msg;
 
-			snprintk(tem_str, sizeof(tem_str), "%d.%02dc", cc_data.weather.tem.val1,
-				 cc_data.weather.tem.val2 / 10000);
+	app_metrics_inc(APP_METRICS_WORKQ_RUNS);
 
-			LOG_DBG("nmea: %s t: %s", raw_readings, tem_str);
+	atomic_val_t dropped = atomic_set(&nmea_dropped, 0);
 
-			IF_ENABLED(CONFIG_LIB_OSTENTUS, (
-				update_ostentus_gps(minmea_tocoord(&cc_data.frame.latitude),
-						    minmea_tocoord(&cc_data.frame.longitude),
-						    tem_str, strlen(tem_str));
-			));
+	if (dropped) {
+		LOG_ERR("Message queue full, dropped %ld sentences", (long)dropped);
+	}
 
-			uint32_t msg_cnt = k_msgq_num_used_get(&coldchain_msgq);
+	while (k_msgq_get(&reading_msgq, &msg, K_NO_WAIT) == 0) {
+		nmea_parse(&msg);
+	}
+}
+static K_WORK_DEFINE(nmea_parse_work, nmea_parse_work_handler);
 
-			if (msg_cnt > 0 && (msg_cnt % 5 == 0)) {
-				LOG_INF("%d readings queued; %d slots remain", msg_cnt,
-					MAX_QUEUED_DATA - msg_cnt);
-			}
+/*
+ * Add a byte received from the GNSS UART to the sentence being framed.
+ * Returns true when rx->msg holds a complete, NUL-terminated sentence.
+ */
+static bool nmea_rx_byte(struct nmea_rx *rx, uint8_t c)
+{
+	if ((c == '\n') && rx->pos > 0) {
+		/* terminate string */
+		if (rx->pos == (NMEA_SIZE - 1)) {
+			rx->msg.text[rx->pos] = '\0';
+		} else {
+			rx->msg.text[rx->pos] = '\n';
+			rx->msg.text[rx->pos + 1] = '\0';
 		}
+
+		/* reset the buffer (the caller copies the sentence out) */
+		rx->pos = 0;
+		return true;
 	}
+
+	if (rx->pos < (sizeof(rx->msg.text) - 1)) {
+		rx->msg.text[rx->pos++] = c;
+	}
+	/* else: characters beyond buffer size are dropped */
+
+	return false;
 }
 
-K_THREAD_DEFINE(nmea_parser_tid, PARSER_STACK, nmea_parser_thread, NULL, NULL, NULL,
-		K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+/*
+ * Only RMC sentences produce readings, and GSV sentences are only logged while
+ * waiting for a fix. Passing just those on from the ISR means the parser work
+ * runs once per fix instead of once per sentence the receiver sends.
+ */
+static bool nmea_wanted(const char *text)
+{
+	/* "$GPRMC,...": talker ID, then the sentence type */
+	if (text[0] != '$') {
+		return false;
+	}
+
+	if (strncmp(&text[3], "RMC", 3) == 0) {
+		return true;
+	}
+
+	return !atomic_get(&sat_lock) && (strncmp(&text[3], "GSV", 3) == 0);
+}
 
 /* UART callback */
 void serial_cb(const struct device *dev, void *user_data)
@@ -287,25 +550,29 @@ void serial_cb(const struct device *dev, void *user_data)
 
 		uart_fifo_read(uart_dev, &c, 1);
 
-		if ((c == '\n') && rx_buf_pos > 0) {
-			/* terminate string */
-			if (rx_buf_pos == (NMEA_SIZE - 1)) {
-				rx_buf[rx_buf_pos] = '\0';
-			} else {
-				rx_buf[rx_buf_pos] = '\n';
-				rx_buf[rx_buf_pos + 1] = '\0';
-			}
+		if (!nmea_rx_byte(&uart_rx, c)) {
+			continue;
+		}
 
-			if (k_msgq_put(&reading_msgq, &rx_buf, K_NO_WAIT) != 0) {
-				LOG_ERR("Message queue full, dropping reading.");
-			}
+		uart_rx.msg.rx_cyc = k_cycle_get_32();
+		uart_rx.msg.rx_ms = k_uptime_get_32();
+
+		app_metrics_inc(APP_METRICS_NMEA_RX);
+
+		if (!nmea_wanted(uart_rx.msg.text)) {
+			app_metrics_inc(APP_METRICS_NMEA_FILTERED);
+			continue;
+		}
 
-			/* reset the buffer (it was copied to the msgq) */
-			rx_buf_pos = 0;
-		} else if (rx_buf_pos < (sizeof(rx_buf) - 1)) {
-			rx_buf[rx_buf_pos++] = c;
+		if (k_msgq_put(&reading_msgq, &uart_rx.msg, K_NO_WAIT) != 0) {
+			/* No logging in the ISR; the parser, which is due to run, reports it */
+			atomic_inc(&nmea_dropped);
+			app_metrics_inc(APP_METRICS_NMEA_DROPPED);
+		} else {
+			app_metrics_hwm_update(APP_METRICS_HWM_READING_MSGQ,
+					       k_msgq_num_used_get(&reading_msgq));
+			k_work_submit_to_queue(&app_work_q, &nmea_parse_work);
 		}
-		/* else: characters beyond buffer size are dropped */
 	}
 }
 
@@ -332,157 +599,1056 @@ static const struct device *get_bme280_device(void)
 
 	LOG_DBG("Found device \"%s\", getting sensor data", bme_dev->name);
 
-	/* Give semaphore to signal sensor is ready for reading */
-	k_sem_give(&bme280_initialized_sem);
 	return bme_dev;
 }
 
-static void get_sensor_string_or_empty(struct sensor_value v, char *buf, uint8_t buf_len, char *key)
+static bool sensor_value_valid(const struct sensor_value *v)
 {
-	if ((v.val1 == reading_error.val1) && (v.val2 == reading_error.val2)) {
-		buf[0] = '\0';
-	} else {
-		snprintk(buf, buf_len, ",\"%s\":%d.%06d", key, v.val1, abs(v.val2));
-	}
+	return (v->val1 != reading_error.val1) || (v->val2 != reading_error.val2);
 }
 
-static void batch_upload_to_golioth(void)
+/* Write one reading as a JSON object; returns its length or a negative error */
+static int reading_format(char *buf, size_t size, const struct cold_chain_data *data)
+{
+	const struct weather_data *w = &data->weather;
+	struct app_reading r = {
+		.lat = app_gnss_coord_udeg(&data->frame.latitude),
+		.lon = app_gnss_coord_udeg(&data->frame.longitude),
+		.time = app_gnss_rmc_unix_ms(&data->frame),
+		.tem = sensor_value_to_micro(&w->tem),
+		.pre = sensor_value_to_micro(&w->pre),
+		.hum = sensor_value_to_micro(&w->hum),
+	};
+	uint32_t mask = BIT(APP_READING_lat) | BIT(APP_READING_lon) | BIT(APP_READING_time);
+
+	/* Sensor values which could not be read are left out */
+	mask |= sensor_value_valid(&w->tem) ? BIT(APP_READING_tem) : 0;
+	mask |= sensor_value_valid(&w->pre) ? BIT(APP_READING_pre) : 0;
+	mask |= sensor_value_valid(&w->hum) ? BIT(APP_READING_hum) : 0;
+
+	return app_codec_json_encode(&app_reading_schema, &r, mask, buf, size);
+}
+
+/*
+ * Upload queued readings in batches until the queue is empty or deadline_ms
+ * (uptime) has passed. Readings are only removed from the queue once the batch
+ * containing them has been accepted. Must be called with upload_mutex held.
+ *
+ * Returns the number of readings uploaded.
+ */
+static uint32_t batch_upload_to_golioth(int64_t deadline_ms)
 {
 	uint32_t msg_cnt = k_msgq_num_used_get(&coldchain_msgq);
 
 	if (msg_cnt == 0) {
-		return;
+		return 0;
 	}
 
 	LOG_INF("Uploading cached data to Golioth");
 
-	/* Packets will be no larger than 1024 characters
-	 *
-	 * {"lat":-90.123456,"lon":-180.123456,"time":"2023-09-18T22:52:42.000Z","tem":-100.123456,
-	 *  "pre":-100.123456,"hum":-100.123456}"
-	 *
-	 * Round up for the comma, and overall open/close bracket.
-	 * Size the overall buffer to be smaller than 1024 which is most efficient for Golioth
-	 */
-	static const char r_fmt[] = "{\"lat\":%f,\"lon\":%f,\""
-				    "time\":\"20%02d-%02d-%02dT%02d:%02d:%02d.%03dZ\""
-				    "%s%s%s}";
-	uint16_t remaining_len;
 	uint16_t tot_pushed = 0;
+	uint32_t tot_bytes = 0;
+	uint32_t batched = 0;
+	int64_t upload_start = k_uptime_get();
 	struct cold_chain_data cached_data;
+	char *buf = upload_buf;
+	size_t used = 1;
 
-	char *buf = (char *) malloc(sizeof(char) * MAX_BATCH_STREAM_SIZE);
+	buf[0] = '[';
 
-	if (!buf) {
-		LOG_ERR("Enable to allocate memory for batch upload");
-		return;
-	}
-
-	snprintk(buf, MAX_BATCH_STREAM_SIZE, "%s", "[");
+	/* Start of serialization of the current batch */
+	uint32_t serialize_cyc = k_cycle_get_32();
+#ifdef CONFIG_APP_METRICS_LATENCY
+	uint32_t serialize_ms = k_uptime_get_32();
+#endif
 
-	while (msg_cnt > 0) {
-		int err = k_msgq_get(&coldchain_msgq, &cached_data, K_MSEC(10));
+	while (batched < msg_cnt) {
+		int err = k_msgq_peek_at(&coldchain_msgq, &cached_data, batched);
 
 		if (err) {
 			LOG_ERR("Error fetching cached reading: %d", err);
-			goto free_after_stream;
+			goto done;
 		}
 
-		char tem_str[19], pre_str[19], hum_str[19];
+		/* Written in place after the separator, leaving room for the closing bracket */
+		size_t sep = (batched > 0) ? 1 : 0;
+		int len = reading_format(buf + used + sep, MAX_BATCH_STREAM_SIZE - used - sep - 1,
+					 &cached_data);
 
-		get_sensor_string_or_empty(cached_data.weather.tem, tem_str, sizeof(tem_str),
-					   "tem");
-		get_sensor_string_or_empty(cached_data.weather.pre, pre_str, sizeof(pre_str),
-					   "pre");
-		get_sensor_string_or_empty(cached_data.weather.hum, hum_str, sizeof(hum_str),
-					   "hum");
+		if (len >= 0) {
+			if (sep) {
+				buf[used] = ',';
+			}
+			used += sep + len;
+			batched++;
+		} else if (len != -ENOMEM) {
+			LOG_ERR("Unable to encode cached reading: %d", len);
+			goto done;
+		}
 
-		snprintk(buf + strlen(buf), MAX_BATCH_STREAM_SIZE - strlen(buf), r_fmt,
-			 (double) minmea_tocoord(&cached_data.frame.latitude),
-			 (double) minmea_tocoord(&cached_data.frame.longitude),
-			 cached_data.frame.date.year, cached_data.frame.date.month,
-			 cached_data.frame.date.day, cached_data.frame.time.hours,
-			 cached_data.frame.time.minutes, cached_data.frame.time.seconds,
-			 cached_data.frame.time.microseconds,
-			 tem_str, pre_str, hum_str);
+		/* A batch is sent when the next reading does not fit */
+		if (batched == msg_cnt || len == -ENOMEM) {
+			buf[used++] = ']';
 
-		msg_cnt = k_msgq_num_used_get(&coldchain_msgq);
-		remaining_len = MAX_BATCH_STREAM_SIZE - strlen(buf) - 1;
-		tot_pushed++;
+			uint32_t serialize_us =
+				k_cyc_to_us_floor32(k_cycle_get_32() - serialize_cyc);
 
-		if (msg_cnt == 0 || remaining_len < MIN_REMAINING_FOR_BATCH_UPLOAD) {
-			snprintk(buf + strlen(buf), MAX_BATCH_STREAM_SIZE - strlen(buf), "%s", "]");
+			upload_buf_peak = MAX(upload_buf_peak, used);
 
+			app_metrics_hist_record(APP_METRICS_HIST_SERIALIZE_US, serialize_us);
+			app_metrics_trace("batch_send", batched, used);
+
+			int64_t start = k_uptime_get();
 			int err = golioth_stream_set_sync(client,
 							  GPS_ENDP,
 							  GOLIOTH_CONTENT_TYPE_JSON,
 							  buf,
-							  strlen(buf),
+							  used,
 							  GPS_BATCH_STREAM_TIMEOUT_S);
 
+			app_metrics_hist_record(APP_METRICS_HIST_UPLOAD_MS, k_uptime_get() - start);
+
 			if (err) {
 				LOG_ERR("Failed to send sensor data to Golioth: %d", err);
-				goto free_after_stream;
+				app_metrics_inc(APP_METRICS_UPLOAD_FAILED);
+				goto done;
 			}
 
-			if (msg_cnt) {
-				snprintk(buf, MAX_BATCH_STREAM_SIZE, "%s", "[");
+			app_metrics_inc(APP_METRICS_UPLOAD_BATCHES);
+			app_metrics_add(APP_METRICS_UPLOAD_BYTES, used);
+			tot_bytes += used;
+
+			uint32_t ack_ms = k_uptime_get_32();
+
+			app_metrics_trace("batch_acked", batched, ack_ms - (uint32_t)start);
+
+			/* Accepted by Golioth; drop the readings from the queue */
+			for (; batched > 0; batched--) {
+				k_msgq_get(&coldchain_msgq, &cached_data, K_NO_WAIT);
+				tot_pushed++;
+
+#ifdef CONFIG_APP_METRICS_LATENCY
+				if (cached_data.rx_ms) {
+					app_metrics_hist_record(APP_METRICS_HIST_QUEUE_MS,
+								serialize_ms -
+								cached_data.enqueue_ms);
+					app_metrics_hist_record(APP_METRICS_HIST_E2E_MS,
+								ack_ms - cached_data.rx_ms);
+				}
+#endif
 			}
-		} else {
-			snprintk(buf + strlen(buf), MAX_BATCH_STREAM_SIZE - strlen(buf), "%s", ",");
+
+			msg_cnt = k_msgq_num_used_get(&coldchain_msgq);
+			if (msg_cnt && k_uptime_get() >= deadline_ms) {
+				LOG_WRN("Upload deadline reached; %u readings remain", msg_cnt);
+				break;
+			}
+
+			used = 1;
+			serialize_cyc = k_cycle_get_32();
+			IF_ENABLED(CONFIG_APP_METRICS_LATENCY, (serialize_ms = k_uptime_get_32();));
 		}
 	}
 
-	LOG_INF("Pushed %d cached readings up to Golioth.", tot_pushed);
+	LOG_INF("Pushed %d cached readings (%u bytes) up to Golioth in %u ms.", tot_pushed,
+		tot_bytes, (uint32_t)(k_uptime_get() - upload_start));
+
+	/* Only now have the queues, the upload buffer and the stacks seen real use */
+	static bool ram_logged;
 
-free_after_stream:
-	free(buf);
+	if (!ram_logged && tot_pushed > 0) {
+		ram_logged = true;
+		app_ram_log();
+	}
 
+done:
+	return tot_pushed;
 }
 
-/* This will be called by the main() loop */
-/* Do all of your work here! */
-void app_sensors_read_and_stream(void)
+/* Temperature in 0.01 C, or APP_BACKLOG_NO_VALUE */
+static int16_t reading_tem_centi(const struct cold_chain_data *data)
 {
-	/* Golioth custom hardware for demos */
-	IF_ENABLED(CONFIG_ALUDEL_BATTERY_MONITOR, (
-		read_and_report_battery(client);
-		IF_ENABLED(CONFIG_LIB_OSTENTUS, (
-			ostentus_slide_set(o_dev,
-					   BATTERY_V,
-					   get_batt_v_str(),
-					   strlen(get_batt_v_str()));
-			ostentus_slide_set(o_dev,
-					   BATTERY_LVL,
-					   get_batt_lvl_str(),
-					   strlen(get_batt_lvl_str()));
-		));
-	));
+	const struct sensor_value *tem = &data->weather.tem;
 
-	if (golioth_client_is_connected(client)) {
-		batch_upload_to_golioth();
+	if (tem->val1 == ERROR_VAL1 && tem->val2 == ERROR_VAL2) {
+		return APP_BACKLOG_NO_VALUE;
 	}
+
+	return tem->val1 * 100 + tem->val2 / 10000;
 }
 
-void app_sensors_set_client(struct golioth_client *sensors_client)
+static bool tem_is_excursion(int16_t tem_centi)
 {
-	client = sensors_client;
+	return tem_centi != APP_BACKLOG_NO_VALUE &&
+	       (tem_centi < CONFIG_APP_EXCURSION_TEMP_MIN_CENTI ||
+		tem_centi > CONFIG_APP_EXCURSION_TEMP_MAX_CENTI);
 }
 
-void app_sensors_init(void)
+static void record_from_data(const struct cold_chain_data *data, struct app_backlog_record *rec)
 {
-	LOG_INF("Initializing UART");
+	const struct weather_data *w = &data->weather;
+	bool pre_ok = (w->pre.val1 != ERROR_VAL1) || (w->pre.val2 != ERROR_VAL2);
+	bool hum_ok = (w->hum.val1 != ERROR_VAL1) || (w->hum.val2 != ERROR_VAL2);
+
+	rec->lat_udeg = app_gnss_coord_udeg(&data->frame.latitude);
+	rec->lon_udeg = app_gnss_coord_udeg(&data->frame.longitude);
+	rec->unix_ms = app_gnss_rmc_unix_ms(&data->frame);
+	rec->tem_centi = reading_tem_centi(data);
+	rec->hum_centi = hum_ok ? (w->hum.val1 * 100 + w->hum.val2 / 10000) : APP_BACKLOG_NO_VALUE;
+	/* Pressure is reported in kPa */
+	rec->pre_pa = pre_ok ? (w->pre.val1 * 1000 + w->pre.val2 / 1000) : APP_BACKLOG_NO_VALUE;
+}
+
+/*
+ * Add one reading per CONFIG_APP_HISTORY_INTERVAL_S to the history, plus each
+ * reading where the temperature leaves or comes back into range, so an
+ * excursion is bracketed even between interval readings.
+ */
+static void history_record(const struct cold_chain_data *data)
+{
+#ifdef CONFIG_APP_HISTORY
+	static int64_t last_ms;
+	static bool in_excursion;
+	struct app_backlog_record rec;
+	int64_t now = k_uptime_get();
+
+	record_from_data(data, &rec);
 
-	int err = gpio_pin_configure_dt(&gnss7_sel, GPIO_OUTPUT_ACTIVE);
+	bool excursion = tem_is_excursion(rec.tem_centi);
+	bool edge = excursion != in_excursion;
 
-	if (err < 0) {
-		LOG_ERR("Unable to configure GNSS SEL Pin: %d", err);
+	in_excursion = excursion;
+
+	if (!edge && last_ms && now - last_ms < CONFIG_APP_HISTORY_INTERVAL_S * MSEC_PER_SEC) {
+		return;
 	}
 
-	/* configure interrupt and callback to receive data */
-	uart_irq_callback_user_data_set(uart_dev, serial_cb, NULL);
-	uart_irq_rx_enable(uart_dev);
+	last_ms = now;
+	app_history_append(&rec);
+#endif
+}
 
-	weather_dev = get_bme280_device();
-	weather_sensor_data_fetch();
+static struct sensor_value centi_to_sensor_value(int16_t centi)
+{
+	if (centi == APP_BACKLOG_NO_VALUE) {
+		return reading_error;
+	}
+
+	return (struct sensor_value){.val1 = centi / 100, .val2 = (centi % 100) * 10000};
+}
+
+static void backlog_restore_cb(const struct app_backlog_record *rec)
+{
+	struct cold_chain_data data = {0};
+
+	data.frame.valid = true;
+	data.frame.latitude = app_gnss_udeg_to_coord(rec->lat_udeg);
+	data.frame.longitude = app_gnss_udeg_to_coord(rec->lon_udeg);
+	app_gnss_rmc_time_set(&data.frame, rec->unix_ms);
+
+	data.weather.tem = centi_to_sensor_value(rec->tem_centi);
+	data.weather.hum = centi_to_sensor_value(rec->hum_centi);
+	if (rec->pre_pa == APP_BACKLOG_NO_VALUE) {
+		data.weather.pre = reading_error;
+	} else {
+		data.weather.pre.val1 = rec->pre_pa / 1000;
+		data.weather.pre.val2 = (rec->pre_pa % 1000) * 1000;
+	}
+
+	if (k_msgq_put(&coldchain_msgq, &data, K_NO_WAIT)) {
+		LOG_ERR("Queue full, dropping restored reading");
+	}
+}
+
+static int thin_point_get(size_t i, struct app_decimate_point *pt, void *user_data)
+{
+	struct cold_chain_data data;
+	int err = k_msgq_peek_at(user_data, &data, i);
+
+	if (err) {
+		return err;
+	}
+
+	int16_t tem_centi = reading_tem_centi(&data);
+
+	pt->t_ms = app_gnss_rmc_unix_ms(&data.frame);
+	pt->value = tem_centi;
+	pt->pinned = tem_is_excursion(tem_centi);
+
+	return 0;
+}
+
+/*
+ * Thin the oldest segment of readings of a queue to about half, keeping
+ * excursions. keep is a bitmap of one bit per queue slot.
+ *
+ * @return number of queue slots freed
+ */
+static uint32_t readings_thin_segment(struct k_msgq *q, uint32_t segment,
+				      enum app_decimate_policy policy, atomic_t *keep)
+{
+	struct cold_chain_data data;
+
+	segment = MIN(segment, k_msgq_num_used_get(q));
+	if (policy == APP_DECIMATE_NONE || segment < THIN_MIN_SEGMENT) {
+		return 0;
+	}
+
+	int freed = app_decimate_msgq(q, segment, policy, thin_point_get, keep, &data);
+
+	return MAX(freed, 0);
+}
+
+/*
+ * Thin the oldest half of a reading queue, or the whole queue when the oldest
+ * half is all excursions. Only the uploads take readings out of the queue, so
+ * this must be called with upload_mutex held for coldchain_msgq.
+ *
+ * @return number of queue slots freed
+ */
+static uint32_t readings_thin(struct k_msgq *q, enum app_decimate_policy policy,
+			      atomic_t *keep)
+{
+	uint32_t used = k_msgq_num_used_get(q);
+	uint32_t freed = readings_thin_segment(q, used / 2, policy, keep);
+
+	if (freed == 0) {
+		freed = readings_thin_segment(q, used, policy, keep);
+	}
+
+	return freed;
+}
+
+/* Make room in a full coldchain_msgq; returns the number of slots freed */
+static uint32_t readings_overflow(void)
+{
+	static ATOMIC_DEFINE(keep, MAX_QUEUED_DATA);
+
+	if (OVERFLOW_POLICY == APP_DECIMATE_NONE) {
+		return 0;
+	}
+
+	/* An upload slice or checkpoint is using the queue; the new reading is dropped rather
+	 * than stall the parser for up to CONFIG_APP_WORKQ_UPLOAD_SLICE_MS
+	 */
+	if (k_mutex_lock(&upload_mutex, K_NO_WAIT)) {
+		app_metrics_inc(APP_METRICS_READINGS_BUSY);
+		return 0;
+	}
+
+	uint32_t freed = readings_thin(&coldchain_msgq, OVERFLOW_POLICY, keep);
+
+	k_mutex_unlock(&upload_mutex);
+
+	if (freed > 0) {
+		app_metrics_add(APP_METRICS_READINGS_THINNED, freed);
+		LOG_WRN("Reading queue full; thinned %u of the oldest readings", freed);
+	}
+
+	return freed;
+}
+
+/* Move queued readings to flash. Must be called with upload_mutex held. */
+static int backlog_checkpoint(void)
+{
+	uint32_t msg_cnt = k_msgq_num_used_get(&coldchain_msgq);
+	struct cold_chain_data data;
+	struct app_backlog_record rec;
+
+	if (msg_cnt == 0) {
+		return 0;
+	}
+
+	int err = app_backlog_begin();
+
+	if (err) {
+		return err;
+	}
+
+	for (uint32_t i = 0; i < msg_cnt; i++) {
+		if (k_msgq_peek_at(&coldchain_msgq, &data, i)) {
+			break;
+		}
+
+		record_from_data(&data, &rec);
+
+		err = app_backlog_append(&rec);
+		if (err == -ENOSPC) {
+			LOG_WRN("Backlog partition full; %u readings not saved", msg_cnt - i);
+			break;
+		} else if (err) {
+			return err;
+		}
+	}
+
+	int saved = app_backlog_commit();
+
+	/* Saved readings are replayed after boot; do not upload them twice */
+	for (int i = 0; i < saved; i++) {
+		k_msgq_get(&coldchain_msgq, &data, K_NO_WAIT);
+	}
+
+	return saved;
+}
+
+int app_sensors_shutdown(uint32_t flush_timeout_ms, uint32_t *sent, uint32_t *saved)
+{
+	int64_t deadline_ms = k_uptime_get() + flush_timeout_ms;
+	int ret;
+
+	*sent = 0;
+	*saved = 0;
+
+	atomic_set(&sampling_stopped, 1);
+
+	k_mutex_lock(&upload_mutex, K_FOREVER);
+
+	if (flush_timeout_ms > 0 && golioth_client_is_connected(client)) {
+		*sent = batch_upload_to_golioth(deadline_ms);
+	}
+
+	ret = backlog_checkpoint();
+	if (ret > 0) {
+		*saved = ret;
+	}
+
+	uint32_t lost = k_msgq_num_used_get(&coldchain_msgq);
+
+	k_mutex_unlock(&upload_mutex);
+
+	LOG_INF("Shutdown: %u readings sent, %u saved, %u lost", *sent, *saved, lost);
+
+	return (ret < 0) ? ret : 0;
+}
+
+static struct {
+	uint32_t flush_timeout_ms;
+	app_sensors_shutdown_cb done;
+} shutdown_req;
+
+static void shutdown_work_handler(struct k_work *work)
+{
+	uint32_t sent, saved;
+
+	app_metrics_inc(APP_METRICS_WORKQ_RUNS);
+
+	int err = app_sensors_shutdown(shutdown_req.flush_timeout_ms, &sent, &saved);
+
+	if (shutdown_req.done) {
+		shutdown_req.done(err, sent, saved);
+	}
+}
+static K_WORK_DEFINE(shutdown_work, shutdown_work_handler);
+
+int app_sensors_shutdown_async(uint32_t flush_timeout_ms, app_sensors_shutdown_cb done)
+{
+	if (k_work_busy_get(&shutdown_work)) {
+		return -EBUSY;
+	}
+
+	atomic_set(&sampling_stopped, 1);
+
+	shutdown_req.flush_timeout_ms = flush_timeout_ms;
+	shutdown_req.done = done;
+	k_work_submit_to_queue(&app_upload_work_q, &shutdown_work);
+
+	return k_msgq_num_used_get(&coldchain_msgq);
+}
+
+void app_sensors_resume(void)
+{
+	/* A shutdown which has not started yet would stop sampling again */
+	k_work_cancel(&shutdown_work);
+
+	if (!atomic_cas(&sampling_stopped, 1, 0)) {
+		return;
+	}
+
+	/* Waits for a checkpoint in progress, then puts it back in the queue */
+	k_mutex_lock(&upload_mutex, K_FOREVER);
+	app_backlog_replay(backlog_restore_cb);
+	k_mutex_unlock(&upload_mutex);
+
+	LOG_INF("Sampling resumed; %u readings queued", k_msgq_num_used_get(&coldchain_msgq));
+
+	app_sensors_wake();
+}
+
+/* Uptime (ms, 32-bit) when the oldest queued reading was queued, or earlier; 0 after boot,
+ * so restored readings are not held back. Set by the parser, read by the uploads.
+ */
+static atomic_t queue_start_ms;
+
+static uint32_t queue_age_s(void)
+{
+	return (k_uptime_get_32() - (uint32_t)atomic_get(&queue_start_ms)) / MSEC_PER_SEC;
+}
+
+static k_timeout_t loop_delay(void)
+{
+	return K_SECONDS(app_power_loop_delay_s(get_loop_delay_s()));
+}
+
+static void flush_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_handler);
+
+static void flush_work_handler(struct k_work *work)
+{
+	app_metrics_inc(APP_METRICS_WORKQ_RUNS);
+
+	if (atomic_get(&sampling_stopped)) {
+		/* Shutting down; queued readings are handled by app_sensors_shutdown() */
+		return;
+	}
+
+	uint32_t queued = k_msgq_num_used_get(&coldchain_msgq);
+
+	/* Offline, or not enough readings yet: the next reading, the age limit or the connection
+	 * reschedules
+	 */
+	if (!golioth_client_is_connected(client) ||
+	    !app_power_flush_due(queued, MAX_QUEUED_DATA, queue_age_s())) {
+		return;
+	}
+
+	/* Free the reading queue between slices of a long backlog upload, so it can be thinned */
+	int64_t deadline_ms = k_uptime_get() + CONFIG_APP_WORKQ_UPLOAD_SLICE_MS;
+
+	k_mutex_lock(&upload_mutex, K_FOREVER);
+	batch_upload_to_golioth(deadline_ms);
+	queued = k_msgq_num_used_get(&coldchain_msgq);
+	k_mutex_unlock(&upload_mutex);
+
+	if (queued == 0) {
+		return;
+	}
+
+	if (k_uptime_get() >= deadline_ms) {
+		/* Continue after anything waiting for the queue has had it */
+		k_work_reschedule_for_queue(&app_upload_work_q, &flush_work, K_NO_WAIT);
+	} else {
+		/* The upload failed; retry at the loop delay */
+		k_work_reschedule_for_queue(&app_upload_work_q, &flush_work, loop_delay());
+	}
+}
+
+/*
+ * A reading was queued: upload it with the others at the loop delay, or right
+ * away if the queue is filling up. Nothing is scheduled while offline; the
+ * upload starts when the connection comes up (app_sensors_wake()).
+ */
+static void flush_schedule(uint32_t queued)
+{
+	/* The first reading of a batch starts the age limit of the power profile */
+	if (queued == 1) {
+		atomic_set(&queue_start_ms, k_uptime_get_32());
+	}
+
+	if (!client || !golioth_client_is_connected(client)) {
+		return;
+	}
+
+	uint32_t age_s = queue_age_s();
+	uint32_t max_age_s = app_power_flush_max_age_s();
+
+	if (queued >= FLUSH_WATERMARK) {
+		k_work_reschedule_for_queue(&app_upload_work_q, &flush_work, K_NO_WAIT);
+	} else if (app_power_flush_due(queued, MAX_QUEUED_DATA, age_s)) {
+		/* Does nothing if an upload is already scheduled, so readings are batched */
+		k_work_schedule_for_queue(&app_upload_work_q, &flush_work, loop_delay());
+	} else if (max_age_s > 0) {
+		/* Not due before max_age_s, so age_s is below it */
+		k_work_schedule_for_queue(&app_upload_work_q, &flush_work,
+					  K_SECONDS(max_age_s - age_s));
+	}
+}
+
+#ifdef CONFIG_APP_LIVE_TRACK
+/* Readings streamed during live tracking and not yet acknowledged */
+#define LIVE_SLOTS 4
+/* One reading between brackets, NUL terminated */
+#define LIVE_PAYLOAD_SIZE (READING_JSON_MAX + 3)
+
+enum live_slot_state {
+	LIVE_SLOT_FREE,
+	LIVE_SLOT_IN_FLIGHT,
+	LIVE_SLOT_FAILED,
+};
+
+static struct {
+	atomic_t state;
+	/* Uptime (ms) when the sentence was received */
+	uint32_t rx_ms;
+	struct cold_chain_data data;
+	char payload[LIVE_PAYLOAD_SIZE];
+} live_slots[LIVE_SLOTS];
+
+static void live_requeue_work_handler(struct k_work *work);
+static K_WORK_DEFINE(live_requeue_work, live_requeue_work_handler);
+
+/* Queue readings which could not be streamed, to go out with the next batch */
+static void live_requeue_work_handler(struct k_work *work)
+{
+	app_metrics_inc(APP_METRICS_WORKQ_RUNS);
+
+	for (int i = 0; i < LIVE_SLOTS; i++) {
+		if (atomic_get(&live_slots[i].state) != LIVE_SLOT_FAILED) {
+			continue;
+		}
+
+		int err = k_msgq_put(&coldchain_msgq, &live_slots[i].data, K_NO_WAIT);
+
+		if (err == -ENOMSG && readings_overflow() > 0) {
+			err = k_msgq_put(&coldchain_msgq, &live_slots[i].data, K_NO_WAIT);
+		}
+
+		if (err) {
+			LOG_ERR("Unable to queue unsent live reading: %d", err);
+			app_metrics_inc(APP_METRICS_READINGS_DROPPED);
+		} else {
+			app_metrics_inc(APP_METRICS_READINGS_QUEUED);
+			flush_schedule(k_msgq_num_used_get(&coldchain_msgq));
+		}
+
+		atomic_set(&live_slots[i].state, LIVE_SLOT_FREE);
+	}
+}
+
+/* Runs in the Golioth client thread; the upload queue is left to the work queue */
+static void live_sent(struct golioth_client *client, enum golioth_status status,
+		      const struct golioth_coap_rsp_code *coap_rsp_code, const char *path,
+		      void *arg)
+{
+	int i = (intptr_t)arg;
+
+	app_live_track_fix_sent(live_slots[i].rx_ms, status == GOLIOTH_OK);
+
+	if (status == GOLIOTH_OK) {
+		app_metrics_inc(APP_METRICS_UPLOAD_BATCHES);
+		app_metrics_inc(APP_METRICS_READINGS_STREAMED);
+		atomic_set(&live_slots[i].state, LIVE_SLOT_FREE);
+		return;
+	}
+
+	LOG_WRN("Failed to stream live reading: %d", status);
+	app_metrics_inc(APP_METRICS_UPLOAD_FAILED);
+	atomic_set(&live_slots[i].state, LIVE_SLOT_FAILED);
+	k_work_submit_to_queue(&app_work_q, &live_requeue_work);
+}
+
+/*
+ * Stream one reading without waiting for the acknowledgement. Returns 0 if it
+ * was sent; otherwise the caller queues it for the next batch.
+ */
+static int live_send(const struct cold_chain_data *data, uint32_t rx_ms)
+{
+	if (!client || !golioth_client_is_connected(client)) {
+		return -ENOTCONN;
+	}
+
+	for (int i = 0; i < LIVE_SLOTS; i++) {
+		if (!atomic_cas(&live_slots[i].state, LIVE_SLOT_FREE, LIVE_SLOT_IN_FLIGHT)) {
+			continue;
+		}
+
+		char *buf = live_slots[i].payload;
+		int len = reading_format(buf + 1, LIVE_PAYLOAD_SIZE - 2, data);
+
+		if (len < 0) {
+			atomic_set(&live_slots[i].state, LIVE_SLOT_FREE);
+			return len;
+		}
+
+		buf[0] = '[';
+		buf[++len] = ']';
+		buf[++len] = '\0';
+
+		live_slots[i].data = *data;
+		live_slots[i].rx_ms = rx_ms;
+
+		int err = golioth_stream_set_async(client, GPS_ENDP, GOLIOTH_CONTENT_TYPE_JSON,
+						   buf, len, live_sent, (void *)(intptr_t)i);
+
+		if (err) {
+			atomic_set(&live_slots[i].state, LIVE_SLOT_FREE);
+			return err;
+		}
+
+		app_metrics_add(APP_METRICS_UPLOAD_BYTES, len);
+
+		return 0;
+	}
+
+	/* Acknowledgements are falling behind; batch the reading instead */
+	return -EBUSY;
+}
+#else
+static int live_send(const struct cold_chain_data *data, uint32_t rx_ms)
+{
+	return -ENOTSUP;
+}
+#endif /* CONFIG_APP_LIVE_TRACK */
+
+#ifdef CONFIG_ALUDEL_BATTERY_MONITOR
+/* Golioth custom hardware for demos */
+static void battery_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(battery_work, battery_work_handler);
+
+static void battery_work_handler(struct k_work *work)
+{
+	app_metrics_inc(APP_METRICS_WORKQ_RUNS);
+
+	read_and_report_battery(client);
+	IF_ENABLED(CONFIG_LIB_OSTENTUS, (
+		app_display_slide_set(BATTERY_V, get_batt_v_str());
+		app_display_slide_set(BATTERY_LVL, get_batt_lvl_str());
+	));
+
+	/* Adapt cadence to the battery level */
+	app_power_update();
+	IF_ENABLED(CONFIG_APP_RECORDER, (recorder_resume();));
+
+	k_work_reschedule_for_queue(&app_work_q, &battery_work, loop_delay());
+}
+#endif
+
+void app_sensors_wake(void)
+{
+	IF_ENABLED(CONFIG_ALUDEL_BATTERY_MONITOR, (
+		k_work_reschedule_for_queue(&app_work_q, &battery_work, K_NO_WAIT);
+	));
+	k_work_reschedule_for_queue(&app_upload_work_q, &flush_work, K_NO_WAIT);
+}
+
+size_t app_sensors_ram_usage(struct app_ram_usage *usage, size_t max)
+{
+	const struct app_ram_usage regions[] = {
+		{
+			.name = "readings",
+			.size = sizeof(struct cold_chain_data) * MAX_QUEUED_DATA,
+			.used = sizeof(struct cold_chain_data) *
+				k_msgq_num_used_get(&coldchain_msgq),
+			.peak = sizeof(struct cold_chain_data) *
+				app_metrics_hwm_get(APP_METRICS_HWM_COLDCHAIN_MSGQ),
+		},
+		{
+			.name = "nmea",
+			.size = sizeof(struct nmea_msg) * CONFIG_APP_NMEA_QUEUE_DEPTH,
+			.used = sizeof(struct nmea_msg) * k_msgq_num_used_get(&reading_msgq),
+			.peak = sizeof(struct nmea_msg) *
+				app_metrics_hwm_get(APP_METRICS_HWM_READING_MSGQ),
+		},
+		{
+			/* Only holds data while an upload is running */
+			.name = "upload",
+			.size = sizeof(upload_buf),
+			.peak = upload_buf_peak,
+		},
+#ifdef CONFIG_APP_LIVE_TRACK
+		{
+			/* Readings streamed during live tracking until acknowledged */
+			.name = "live",
+			.size = sizeof(live_slots),
+		},
+#endif
+	};
+	size_t count = MIN(max, ARRAY_SIZE(regions));
+
+	memcpy(usage, regions, count * sizeof(regions[0]));
+
+	return count;
+}
+
+void app_sensors_set_client(struct golioth_client *sensors_client)
+{
+	client = sensors_client;
+}
+
+void app_sensors_init(void)
+{
+	LOG_INF("Initializing UART");
+
+	app_gnss_init();
+	app_gnss_aid_inject();
+	app_history_init();
+
+	/* Readings checkpointed before the last reboot go out before new ones */
+	app_backlog_replay(backlog_restore_cb);
+
+	/* configure interrupt and callback to receive data */
+	uart_irq_callback_user_data_set(uart_dev, serial_cb, NULL);
+	uart_irq_rx_enable(uart_dev);
+
+	weather_dev = get_bme280_device();
+	if (weather_dev) {
+		weather_sensor_data_fetch();
+
+		IF_ENABLED(CONFIG_APP_RECORDER, (
+			recorder_next_ms = k_uptime_get();
+			k_work_schedule_for_queue(&app_work_q, &recorder_work, K_NO_WAIT);
+		));
+	}
+
+	IF_ENABLED(CONFIG_ALUDEL_BATTERY_MONITOR, (
+		k_work_schedule_for_queue(&app_work_q, &battery_work, K_NO_WAIT);
+	));
+}
+
+#ifdef CONFIG_APP_BENCH
+/* Valid RMC sentences kept from the trace for the per-stage benchmarks */
+#define BENCH_RECORDS 32
+
+/* Separate from coldchain_msgq so live readings are not disturbed */
+K_MSGQ_DEFINE(bench_msgq, sizeof(struct cold_chain_data), BENCH_RECORDS, 4);
+
+static void bench_pipeline(const uint8_t *trace, size_t len, struct app_bench_result *res,
+			   char rmc_text[][NMEA_SIZE], struct cold_chain_data *records,
+			   size_t *n_records)
+{
+	static struct nmea_rx rx;
+	uint64_t start = app_bench_ticks();
+
+	/* Same steps as serial_cb() and nmea_parse() for each sentence */
+	for (size_t i = 0; i < len; i++) {
+		if (!nmea_rx_byte(&rx, trace[i])) {
+			continue;
+		}
+
+		res->ops++;
+
+		if (minmea_sentence_id(rx.msg.text, false) != MINMEA_SENTENCE_RMC) {
+			continue;
+		}
+
+		struct minmea_sentence_rmc frame;
+
+		if (!minmea_parse_rmc(&frame, rx.msg.text) || !frame.valid) {
+			continue;
+		}
+
+		if (*n_records < BENCH_RECORDS) {
+			records[*n_records].frame = frame;
+			strcpy(rmc_text[*n_records], rx.msg.text);
+			(*n_records)++;
+		}
+	}
+
+	res->ticks += app_bench_elapsed(start);
+	res->bytes += len;
+}
+
+int app_sensors_bench(const uint8_t *trace, size_t len, uint32_t repeat,
+		      struct app_bench_result results[APP_BENCH_STAGE_COUNT])
+{
+	static char rmc_text[BENCH_RECORDS][NMEA_SIZE];
+	static struct cold_chain_data records[BENCH_RECORDS];
+	static char buf[MAX_BATCH_STREAM_SIZE];
+	struct cold_chain_data data;
+	size_t n = 0;
+	uint64_t start;
+
+	memset(results, 0, sizeof(struct app_bench_result) * APP_BENCH_STAGE_COUNT);
+
+	for (uint32_t r = 0; r < repeat; r++) {
+		bench_pipeline(trace, len, &results[APP_BENCH_NMEA_PIPELINE], rmc_text, records,
+			       &n);
+	}
+
+	if (n == 0) {
+		return -ENODATA;
+	}
+
+	/* Fixed weather values keep the serialized size independent of the sensor */
+	for (size_t i = 0; i < n; i++) {
+		records[i].weather.tem = (struct sensor_value){.val1 = 4, .val2 = 250000};
+		records[i].weather.pre = (struct sensor_value){.val1 = 101, .val2 = 325000};
+		records[i].weather.hum = (struct sensor_value){.val1 = 60, .val2 = 0};
+	}
+
+	start = app_bench_ticks();
+	for (uint32_t r = 0; r < repeat; r++) {
+		for (size_t i = 0; i < n; i++) {
+			minmea_parse_rmc(&data.frame, rmc_text[i]);
+		}
+	}
+	results[APP_BENCH_RMC_PARSE].ticks = app_bench_elapsed(start);
+	results[APP_BENCH_RMC_PARSE].ops = repeat * n;
+
+	start = app_bench_ticks();
+	for (uint32_t r = 0; r < repeat; r++) {
+		for (size_t i = 0; i < n; i++) {
+			k_msgq_put(&bench_msgq, &records[i], K_NO_WAIT);
+		}
+		while (k_msgq_get(&bench_msgq, &data, K_NO_WAIT) == 0) {
+		}
+	}
+	results[APP_BENCH_MSGQ].ticks = app_bench_elapsed(start);
+	results[APP_BENCH_MSGQ].ops = repeat * n;
+	results[APP_BENCH_MSGQ].bytes = repeat * n * sizeof(struct cold_chain_data);
+
+	/* Batches are closed like batch_upload_to_golioth() closes them */
+	start = app_bench_ticks();
+	for (uint32_t r = 0; r < repeat; r++) {
+		size_t used = 1;
+		size_t batched = 0;
+
+		buf[0] = '[';
+
+		for (size_t i = 0; i < n; i++) {
+			size_t sep = (batched > 0) ? 1 : 0;
+			int len = reading_format(buf + used + sep, sizeof(buf) - used - sep - 1,
+						 &records[i]);
+			bool full = (len == -ENOMEM && batched > 0);
+
+			if (len >= 0) {
+				if (sep) {
+					buf[used] = ',';
+				}
+				used += sep + len;
+				batched++;
+			}
+
+			if (i == n - 1 || full) {
+				buf[used++] = ']';
+				results[APP_BENCH_SERIALIZE].bytes += used;
+				used = 1;
+				batched = 0;
+			}
+
+			if (full) {
+				/* The reading which did not fit starts the next batch */
+				i--;
+			}
+		}
+	}
+	results[APP_BENCH_SERIALIZE].ticks = app_bench_elapsed(start);
+	results[APP_BENCH_SERIALIZE].ops = repeat * n;
+
+	return 0;
+}
+
+/* 2000-01-01T00:00:00Z, so injected readings are easy to tell from live ones */
+#define BENCH_BACKLOG_EPOCH_MS 946684800000LL
+
+int app_sensors_bench_backlog(uint32_t count)
+{
+	struct cold_chain_data data = {0};
+	uint32_t queued;
+
+	data.frame.valid = true;
+	data.frame.latitude = app_gnss_udeg_to_coord(42347000);
+	data.frame.longitude = app_gnss_udeg_to_coord(-83060000);
+	data.weather.tem = (struct sensor_value){.val1 = 4, .val2 = 250000};
+	data.weather.pre = (struct sensor_value){.val1 = 101, .val2 = 325000};
+	data.weather.hum = (struct sensor_value){.val1 = 60, .val2 = 0};
+
+	/* The upload may be emptying or thinning coldchain_msgq at the same time */
+	k_mutex_lock(&upload_mutex, K_FOREVER);
+
+	for (queued = 0; queued < count; queued++) {
+		app_gnss_rmc_time_set(&data.frame, BENCH_BACKLOG_EPOCH_MS + queued * MSEC_PER_SEC);
+
+		if (k_msgq_put(&coldchain_msgq, &data, K_NO_WAIT)) {
+			break;
+		}
+	}
+
+	k_mutex_unlock(&upload_mutex);
+
+	app_metrics_add(APP_METRICS_READINGS_QUEUED, queued);
+	flush_schedule(k_msgq_num_used_get(&coldchain_msgq));
+
+	return queued;
+}
+
+/* Two hours of readings at one a minute */
+#define BENCH_THIN_DEPTH     MIN(MAX_QUEUED_DATA, 120)
+#define BENCH_THIN_PERIOD_MS (60 * MSEC_PER_SEC)
+
+K_MSGQ_DEFINE(bench_thin_msgq, sizeof(struct cold_chain_data), BENCH_THIN_DEPTH, 4);
+
+/*
+ * 2.50 C to 5.50 C triangle wave with a four hour period, and a five minute
+ * excursion to 10.00 C every 1000 minutes.
+ */
+static int16_t bench_thin_tem_centi(uint32_t i)
+{
+	uint32_t phase = i % 240;
+
+	if (i % 1000 >= 500 && i % 1000 < 505) {
+		return 1000;
+	}
+
+	return 250 + ((phase < 120 ? phase : 240 - phase) * 300) / 120;
+}
+
+void app_sensors_bench_thin(uint32_t count, enum app_decimate_policy policy,
+			    struct app_bench_thin_result *res)
+{
+	static ATOMIC_DEFINE(keep, BENCH_THIN_DEPTH);
+	struct cold_chain_data data = {0};
+	uint64_t err_sum = 0;
+	uint32_t err_n = 0;
+	uint32_t first = 0, prev = 0;
+	int16_t prev_tem = 0;
+
+	memset(res, 0, sizeof(*res));
+	k_msgq_purge(&bench_thin_msgq);
+
+	data.frame.valid = true;
+	data.frame.latitude = app_gnss_udeg_to_coord(42347000);
+	data.frame.longitude = app_gnss_udeg_to_coord(-83060000);
+
+	for (uint32_t i = 0; i < count; i++) {
+		int16_t tem = bench_thin_tem_centi(i);
+
+		data.weather.tem = centi_to_sensor_value(tem);
+		app_gnss_rmc_time_set(&data.frame,
+				      BENCH_BACKLOG_EPOCH_MS + (int64_t)i * BENCH_THIN_PERIOD_MS);
+
+		if (tem_is_excursion(tem)) {
+			res->excursions++;
+		}
+
+		if (k_msgq_put(&bench_thin_msgq, &data, K_NO_WAIT) == -ENOMSG) {
+			res->thinned += readings_thin(&bench_thin_msgq, policy, keep);
+			/* Dropped if nothing could be thinned */
+			k_msgq_put(&bench_thin_msgq, &data, K_NO_WAIT);
+		}
+	}
+
+	res->readings = count;
+	res->outage_s = (count > 0) ? (count - 1) * (BENCH_THIN_PERIOD_MS / MSEC_PER_SEC) : 0;
+
+	while (k_msgq_get(&bench_thin_msgq, &data, K_NO_WAIT) == 0) {
+		uint32_t i = (app_gnss_rmc_unix_ms(&data.frame) - BENCH_BACKLOG_EPOCH_MS) /
+			     BENCH_THIN_PERIOD_MS;
+		int16_t tem = reading_tem_centi(&data);
+
+		if (tem_is_excursion(tem)) {
+			res->excursions_kept++;
+		}
+
+		if (res->kept++ == 0) {
+			first = i;
+		} else {
+			/* Error of the readings thinned out between prev and i, and of i */
+			for (uint32_t j = prev + 1; j <= i; j++) {
+				int32_t est = prev_tem + ((tem - prev_tem) * (int32_t)(j - prev)) /
+							 (int32_t)(i - prev);
+				uint32_t err = abs(est - bench_thin_tem_centi(j));
+
+				res->max_err_centi = MAX(res->max_err_centi, err);
+				err_sum += err;
+				err_n++;
+			}
+		}
+
+		prev = i;
+		prev_tem = tem;
+	}
+
+	res->span_s = (prev - first) * (BENCH_THIN_PERIOD_MS / MSEC_PER_SEC);
+	res->mean_err_centi = err_n ? err_sum / err_n : 0;
 }
+#endif /* CONFIG_APP_BENCH */
@@ -10,9 +10,89 @@
 #include <golioth/client.h>
 
 void app_sensors_set_client(struct golioth_client *sensors_client);
-void app_sensors_read_and_stream(void);
 void app_sensors_init(void);
 
+struct app_ram_usage;
+
+/**
+ * Report the RAM of the reading queue, the NMEA sentence queue and the upload
+ * buffer.
+ *
+ * @return number of entries filled, at most max
+ */
+size_t app_sensors_ram_usage(struct app_ram_usage *usage, size_t max);
+
+/**
+ * Report the battery and upload queued readings now rather than at the next
+ * loop delay, e.g. when the button is pressed, the Golioth connection comes up
+ * or LOOP_DELAY_S changes. Safe to call from an ISR.
+ */
+void app_sensors_wake(void);
+
+/**
+ * Prepare for a reboot: stop queueing new readings, upload queued readings
+ * for up to flush_timeout_ms, then checkpoint the rest to flash so they are
+ * uploaded after boot. Pass 0 to skip the upload. Blocks for as long as that
+ * takes, so it must not be called from a Golioth client callback; use
+ * app_sensors_shutdown_async() there.
+ *
+ * @return 0 on success, negative errno if the checkpoint failed
+ */
+int app_sensors_shutdown(uint32_t flush_timeout_ms, uint32_t *sent, uint32_t *saved);
+
+/** Called from the upload work queue once app_sensors_shutdown_async() is done */
+typedef void (*app_sensors_shutdown_cb)(int err, uint32_t sent, uint32_t saved);
+
+/**
+ * Stop queueing new readings now and run app_sensors_shutdown() on the upload
+ * work queue, then call done.
+ *
+ * @return number of readings queued for the upload or checkpoint, or -EBUSY if
+ *	   a shutdown is already running
+ */
+int app_sensors_shutdown_async(uint32_t flush_timeout_ms, app_sensors_shutdown_cb done);
+
+/**
+ * Undo a shutdown which was not followed by a reboot, e.g. a failed firmware
+ * update: readings checkpointed to flash are queued again and new readings are
+ * queued and uploaded as before. Does nothing if no shutdown was started.
+ */
+void app_sensors_resume(void);
+
+#ifdef CONFIG_APP_BENCH
+#include "app_bench.h"
+#include "app_decimate.h"
+
+/**
+ * Run a recorded NMEA trace repeat times through the same framing, parsing,
+ * queueing and serialization code as live readings, without touching the live
+ * queues. Fills one result per enum app_bench_stage.
+ *
+ * @return 0 on success, -ENODATA if the trace holds no valid RMC sentence
+ */
+int app_sensors_bench(const uint8_t *trace, size_t len, uint32_t repeat,
+		      struct app_bench_result results[APP_BENCH_STAGE_COUNT]);
+
+/**
+ * Queue count synthetic readings for upload, timestamped one second apart
+ * from 2000-01-01T00:00:00Z, to measure how fast a backlog drains.
+ *
+ * @return number of readings queued, fewer than count if the queue filled up
+ */
+int app_sensors_bench_backlog(uint32_t count);
+
+/**
+ * Feed count synthetic readings, one a minute with a temperature excursion
+ * every 1000 minutes, into a small queue which is never uploaded, as during
+ * a network outage. When it is full the queue is thinned with the given
+ * policy, as coldchain_msgq is. Reports how much of the outage and how many
+ * excursions the readings left cover, and how far the temperature linearly
+ * interpolated between them is from the readings generated.
+ */
+void app_sensors_bench_thin(uint32_t count, enum app_decimate_policy policy,
+			    struct app_bench_thin_result *res);
+#endif
+
 #define LABEL_LAT	"Latitude"
 #define LABEL_LON	"Longitude"
 #define LABEL_TEM	"Temperature"
@@ -32,7 +112,8 @@ typedef enum {
 	BATTERY_V,
 	BATTERY_LVL,
 #endif
-	FIRMWARE
+	FIRMWARE,
+	SLIDE_KEY_COUNT /* must be last */
 } slide_key;
 
 #endif /* __APP_SENSORS_H__ */
@@ -9,7 +9,11 @@ LOG_MODULE_REGISTER(app_settings, LOG_LEVEL_DBG);
 
 #include <golioth/client.h>
 #include <golioth/settings.h>
-#include "main.h"
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/crc.h>
+#include "app_sensors.h"
 #include "app_settings.h"
 
 /* How long to wait between uploading to Golioth */
@@ -22,6 +26,117 @@ static int32_t _gps_delay_s = 3;
 #define GPS_DELAY_S_MAX 43200
 #define GPS_DELAY_S_MIN 0
 
+#ifdef CONFIG_APP_SETTINGS_CACHE
+/*
+ * Settings accepted from Golioth are cached in flash and restored at boot by
+ * settings_load(), before sensing starts, so the device does not run at the
+ * defaults until the settings service syncs.
+ */
+#define CACHE_SETTINGS_KEY   "app_settings/cache"
+#define CACHE_RECORD_VERSION 1
+
+/* Coalesce the settings received in one sync into a single flash write */
+#define CACHE_SAVE_DELAY K_SECONDS(2)
+
+struct cache_record {
+	uint8_t version;
+	uint8_t reserved[3];
+	int32_t loop_delay_s;
+	int32_t gps_delay_s;
+	/* CRC-32 of the fields above */
+	uint32_t crc;
+};
+
+/* Last record loaded or saved */
+static struct cache_record cached;
+
+static uint32_t cache_crc(const struct cache_record *rec)
+{
+	return crc32_ieee((const uint8_t *)rec, offsetof(struct cache_record, crc));
+}
+
+static int cache_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+			      void *cb_arg)
+{
+	const char *next;
+	struct cache_record rec;
+
+	if (!settings_name_steq(name, "cache", &next) || next) {
+		return -ENOENT;
+	}
+
+	if (len != sizeof(rec)) {
+		return -EINVAL;
+	}
+
+	ssize_t rc = read_cb(cb_arg, &rec, sizeof(rec));
+
+	if (rc < 0) {
+		return rc;
+	}
+
+	if (rec.version != CACHE_RECORD_VERSION || rec.crc != cache_crc(&rec)) {
+		LOG_WRN("Ignoring invalid settings cache");
+		return 0;
+	}
+
+	if (!IN_RANGE(rec.loop_delay_s, LOOP_DELAY_S_MIN, LOOP_DELAY_S_MAX) ||
+	    !IN_RANGE(rec.gps_delay_s, GPS_DELAY_S_MIN, GPS_DELAY_S_MAX)) {
+		LOG_WRN("Ignoring out of range settings cache");
+		return 0;
+	}
+
+	cached = rec;
+	_loop_delay_s = rec.loop_delay_s;
+	_gps_delay_s = rec.gps_delay_s;
+
+	LOG_INF("Restored cached settings: loop delay %d s, gps delay %d s", _loop_delay_s,
+		_gps_delay_s);
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(app_settings, "app_settings", NULL, cache_settings_set, NULL,
+			       NULL);
+
+static void cache_save_work_handler(struct k_work *work)
+{
+	struct cache_record rec = {
+		.version = CACHE_RECORD_VERSION,
+		.loop_delay_s = _loop_delay_s,
+		.gps_delay_s = _gps_delay_s,
+	};
+
+	rec.crc = cache_crc(&rec);
+
+	/* Only write flash when a value differs from what is stored */
+	if (memcmp(&rec, &cached, sizeof(rec)) == 0) {
+		return;
+	}
+
+	int err = settings_save_one(CACHE_SETTINGS_KEY, &rec, sizeof(rec));
+
+	if (err) {
+		LOG_ERR("Unable to save settings cache: %d", err);
+		return;
+	}
+
+	cached = rec;
+	LOG_DBG("Saved settings cache");
+}
+
+static K_WORK_DELAYABLE_DEFINE(cache_save_work, cache_save_work_handler);
+
+static void cache_save(void)
+{
+	k_work_reschedule(&cache_save_work, CACHE_SAVE_DELAY);
+}
+#else
+static void cache_save(void)
+{
+}
+#endif /* CONFIG_APP_SETTINGS_CACHE */
+
 int32_t get_loop_delay_s(void)
 {
 	return _loop_delay_s;
@@ -41,7 +156,8 @@ static enum golioth_settings_status on_loop_delay_setting(int32_t new_value, voi
 
 	_loop_delay_s = new_value;
 	LOG_INF("Set loop delay to %i seconds", new_value);
-	wake_system_thread();
+	cache_save();
+	app_sensors_wake();
 	return GOLIOTH_SETTINGS_SUCCESS;
 }
 
@@ -55,7 +171,8 @@ static enum golioth_settings_status on_gps_delay_setting(int32_t new_value, void
 
 	_gps_delay_s = new_value;
 	LOG_INF("Set gps delay to %i seconds", new_value);
-	wake_system_thread();
+	cache_save();
+	app_sensors_wake();
 	return GOLIOTH_SETTINGS_SUCCESS;
 }
 
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * I2C emulator for the Bosch BME280, so the stock Zephyr driver can run on
+ * native_sim. The calibration is chosen so the raw temperature is a linear
+ * function of the simulated temperature (dig_T3 = 0); pressure and humidity
+ * raw values are fixed and read as about 101 kPa and 60 %RH at 4 C.
+ */
+
+#define DT_DRV_COMPAT bosch_bme280
+
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#define REG_CALIB_T1   0x88
+#define REG_CALIB_H1   0xA1
+#define REG_ID	       0xD0
+#define REG_CALIB_H2   0xE1
+#define REG_CTRL_HUM   0xF2
+#define REG_PRESS_MSB  0xF7
+#define BME280_CHIP_ID 0x60
+
+/* Datasheet example calibration, except dig_T3 */
+#define DIG_T1 27504
+#define DIG_T2 26435
+
+static const int16_t calib_p[] = {
+	(int16_t)36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+};
+
+#define DIG_H1 75
+#define DIG_H2 362
+#define DIG_H3 0
+#define DIG_H4 313
+#define DIG_H5 50
+#define DIG_H6 30
+
+#define ADC_PRESS 391779
+#define ADC_HUM	  31100
+
+struct bme280_emul_data {
+	uint8_t regs[256];
+	uint8_t cur_reg;
+};
+
+/* Raw 20-bit temperature reading for a temperature in hundredths of a degree */
+static uint32_t adc_temp(int32_t centi)
+{
+	int32_t t_fine = (centi * 256) / 5;
+
+	return ((((int64_t)t_fine << 11) / DIG_T2) + 2 * DIG_T1) << 3;
+}
+
+/* Triangle wave around the configured temperature */
+static int32_t sim_temp_centi(void)
+{
+	int32_t period_ms = CONFIG_APP_SIM_BME280_TEMP_PERIOD_S * MSEC_PER_SEC;
+	int32_t swing = CONFIG_APP_SIM_BME280_TEMP_SWING_CENTI;
+
+	if (period_ms <= 0 || swing == 0) {
+		return CONFIG_APP_SIM_BME280_TEMP_CENTI;
+	}
+
+	int32_t phase = k_uptime_get() % period_ms;
+	int32_t ramp = (int32_t)(((int64_t)phase * 4 * swing) / period_ms);
+
+	/* 0 -> +swing -> -swing -> 0 over one period */
+	if (ramp > swing && ramp <= 3 * swing) {
+		ramp = 2 * swing - ramp;
+	} else if (ramp > 3 * swing) {
+		ramp -= 4 * swing;
+	}
+
+	return CONFIG_APP_SIM_BME280_TEMP_CENTI + ramp;
+}
+
+static void put_adc20(uint8_t *reg, uint32_t adc)
+{
+	reg[0] = (adc >> 12) & 0xff;
+	reg[1] = (adc >> 4) & 0xff;
+	reg[2] = (adc << 4) & 0xf0;
+}
+
+static void sample_update(struct bme280_emul_data *data)
+{
+	uint8_t *r = &data->regs[REG_PRESS_MSB];
+
+	put_adc20(&r[0], ADC_PRESS);
+	put_adc20(&r[3], adc_temp(sim_temp_centi()));
+	sys_put_be16(ADC_HUM, &r[6]);
+}
+
+static int bme280_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+				int addr)
+{
+	struct bme280_emul_data *data = target->data;
+
+	for (int i = 0; i < num_msgs; i++) {
+		struct i2c_msg *msg = &msgs[i];
+
+		if (msg->flags & I2C_MSG_READ) {
+			if (data->cur_reg == REG_PRESS_MSB) {
+				sample_update(data);
+			}
+
+			for (uint32_t j = 0; j < msg->len; j++) {
+				msg->buf[j] = data->regs[(uint8_t)(data->cur_reg + j)];
+			}
+			continue;
+		}
+
+		if (msg->len == 0) {
+			continue;
+		}
+
+		/* First byte selects the register, the rest are written from there */
+		data->cur_reg = msg->buf[0];
+
+		for (uint32_t j = 1; j < msg->len; j++) {
+			uint8_t reg = data->cur_reg + j - 1;
+
+			/* Only the control and config registers are writable */
+			if (reg >= REG_CTRL_HUM && reg < REG_PRESS_MSB) {
+				data->regs[reg] = msg->buf[j];
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int bme280_emul_init(const struct emul *target, const struct device *parent)
+{
+	struct bme280_emul_data *data = target->data;
+	uint8_t *r = data->regs;
+
+	memset(r, 0, sizeof(data->regs));
+
+	sys_put_le16(DIG_T1, &r[REG_CALIB_T1]);
+	sys_put_le16(DIG_T2, &r[REG_CALIB_T1 + 2]);
+	sys_put_le16(0, &r[REG_CALIB_T1 + 4]);
+
+	for (size_t i = 0; i < ARRAY_SIZE(calib_p); i++) {
+		sys_put_le16(calib_p[i], &r[REG_CALIB_T1 + 6 + 2 * i]);
+	}
+
+	r[REG_CALIB_H1] = DIG_H1;
+	sys_put_le16(DIG_H2, &r[REG_CALIB_H2]);
+	r[REG_CALIB_H2 + 2] = DIG_H3;
+	r[REG_CALIB_H2 + 3] = DIG_H4 >> 4;
+	r[REG_CALIB_H2 + 4] = (DIG_H4 & 0x0f) | ((DIG_H5 & 0x0f) << 4);
+	r[REG_CALIB_H2 + 5] = DIG_H5 >> 4;
+	r[REG_CALIB_H2 + 6] = DIG_H6;
+
+	r[REG_ID] = BME280_CHIP_ID;
+
+	sample_update(data);
+
+	return 0;
+}
+
+static const struct i2c_emul_api bme280_emul_api = {
+	.transfer = bme280_emul_transfer,
+};
+
+#define BME280_EMUL(n)                                                                             \
+	static struct bme280_emul_data bme280_emul_data_##n;                                       \
+	EMUL_DT_INST_DEFINE(n, bme280_emul_init, &bme280_emul_data_##n, NULL, &bme280_emul_api,    \
+			    NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(BME280_EMUL)
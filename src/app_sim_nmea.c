@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Replay a recorded GNSS log into the emulated click UART on native_sim.
+ *
+ * The log is embedded at build time (CONFIG_APP_SIM_NMEA_FILE). Bytes are
+ * paced at the UART baud rate, and each new NMEA epoch (a change of the
+ * hhmmss field) waits for the recorded time difference, both divided by
+ * CONFIG_APP_SIM_NMEA_SPEEDUP. UBX frames in the log are passed through as
+ * they are. Commands written by the app to the receiver are discarded.
+ *
+ * The `--nmea_skip=<epochs>` command line option starts the first pass that
+ * many epochs into the log, so simulated devices sharing one log are at
+ * different points of the track.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_sim_nmea, LOG_LEVEL_DBG);
+
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/serial/uart_emul.h>
+#include <zephyr/kernel.h>
+
+#include "cmdline.h"
+#include "posix_native_task.h"
+
+#include "app_boot.h"
+
+#define UART_DEVICE_NODE DT_ALIAS(click_uart)
+static const struct device *const uart_dev = DEVICE_DT_GET(UART_DEVICE_NODE);
+
+/* 8N1: ten bit times per byte */
+#define UART_BYTE_US (10 * USEC_PER_SEC / DT_PROP(UART_DEVICE_NODE, current_speed))
+
+#define SECONDS_PER_DAY 86400
+
+#define SIM_NMEA_STACK 1024
+
+static const uint8_t track[] = {
+#include "sim_track.inc"
+};
+
+static uint32_t skip_epochs;
+
+static void sim_nmea_options(void)
+{
+	static struct args_struct_t options[] = {
+		{
+			.option = "nmea_skip",
+			.name = "epochs",
+			.type = 'u',
+			.dest = (void *)&skip_epochs,
+			.descript = "Start the GNSS replay this many epochs into the log",
+		},
+		ARG_TABLE_ENDMARKER,
+	};
+
+	native_add_command_line_opts(options);
+}
+
+NATIVE_TASK(sim_nmea_options, PRE_BOOT_1, 1);
+
+/* Seconds of the day from the hhmmss field following the talker, or -1 */
+static int32_t epoch_s(const uint8_t *line, size_t len)
+{
+	const uint8_t *p = memchr(line, ',', len);
+	int32_t digits[6];
+
+	if (line[0] != '$' || !p || (line + len) - p < 7) {
+		return -1;
+	}
+
+	for (int i = 0; i < 6; i++) {
+		if (p[1 + i] < '0' || p[1 + i] > '9') {
+			return -1;
+		}
+		digits[i] = p[1 + i] - '0';
+	}
+
+	return (digits[0] * 10 + digits[1]) * 3600 + (digits[2] * 10 + digits[3]) * 60 +
+	       digits[4] * 10 + digits[5];
+}
+
+static void uart_put(const uint8_t *data, size_t len)
+{
+	while (len) {
+		uint32_t put = uart_emul_put_rx_data(uart_dev, data, len);
+
+		data += put;
+		len -= put;
+
+		if (len) {
+			/* RX FIFO full; let the app drain it */
+			k_msleep(1);
+		}
+	}
+}
+
+static void replay(uint32_t skip)
+{
+	int32_t last_epoch = -1;
+	uint32_t epochs = 0;
+	size_t pos = 0;
+
+	while (pos < sizeof(track)) {
+		const uint8_t *line = &track[pos];
+		const uint8_t *eol = memchr(line, '\n', sizeof(track) - pos);
+		size_t len = eol ? (size_t)(eol - line) + 1 : sizeof(track) - pos;
+		int32_t epoch = epoch_s(line, len);
+
+		if (epoch >= 0 && epoch != last_epoch) {
+			epochs++;
+		}
+
+		if (skip && epochs <= skip) {
+			last_epoch = (epoch >= 0) ? epoch : last_epoch;
+			pos += len;
+			continue;
+		}
+
+		if (epoch >= 0 && last_epoch >= 0 && epoch != last_epoch) {
+			int32_t delta_s = epoch - last_epoch;
+
+			if (delta_s < 0) {
+				delta_s += SECONDS_PER_DAY;
+			}
+
+			k_msleep((delta_s * MSEC_PER_SEC) / CONFIG_APP_SIM_NMEA_SPEEDUP);
+		}
+
+		if (epoch >= 0) {
+			last_epoch = epoch;
+		}
+
+		uart_put(line, len);
+		k_usleep((len * UART_BYTE_US) / CONFIG_APP_SIM_NMEA_SPEEDUP);
+
+		uart_emul_flush_tx_data(uart_dev);
+		pos += len;
+	}
+}
+
+static void sim_nmea_thread(void *arg1, void *arg2, void *arg3)
+{
+	/* The UART callback is installed by the sensors init task */
+	app_boot_wait(K_FOREVER);
+
+	LOG_INF("Replaying %zu bytes of GNSS data at %ux speed from epoch %u", sizeof(track),
+		CONFIG_APP_SIM_NMEA_SPEEDUP, skip_epochs);
+
+	uint32_t skip = skip_epochs;
+
+	do {
+		replay(skip);
+		skip = 0;
+	} while (IS_ENABLED(CONFIG_APP_SIM_NMEA_LOOP));
+
+	LOG_INF("GNSS replay finished");
+}
+
+K_THREAD_DEFINE(sim_nmea_tid, SIM_NMEA_STACK, sim_nmea_thread, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
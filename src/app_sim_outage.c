@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(app_sim_outage, LOG_LEVEL_DBG);
+
+#include <stdlib.h>
+#include <zephyr/arch/posix/posix_trace.h>
+#include <zephyr/kernel.h>
+
+#include "cmdline.h"
+#include "posix_native_task.h"
+
+#include "app_sim_outage.h"
+
+#define MAX_OUTAGES 16
+
+struct outage {
+	uint32_t start_s;
+	uint32_t duration_s;
+};
+
+static char *outage_arg;
+static struct outage outages[MAX_OUTAGES];
+static size_t outage_count;
+static size_t outage_next;
+static bool link_down;
+
+static struct golioth_client *outage_client;
+
+static void outage_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(outage_work, outage_work_handler);
+
+static void outage_options(void)
+{
+	static struct args_struct_t options[] = {
+		{
+			.option = "outage",
+			.name = "start_s:duration_s[,...]",
+			.type = 's',
+			.dest = (void *)&outage_arg,
+			.descript = "Stop the Golioth client at each start_s seconds of uptime "
+				    "for duration_s seconds",
+		},
+		ARG_TABLE_ENDMARKER,
+	};
+
+	native_add_command_line_opts(options);
+}
+
+NATIVE_TASK(outage_options, PRE_BOOT_1, 1);
+
+static int outage_parse(const char *arg)
+{
+	const char *p = arg;
+
+	while (*p) {
+		char *end;
+		struct outage o;
+
+		if (outage_count == MAX_OUTAGES) {
+			return -ENOMEM;
+		}
+
+		o.start_s = strtoul(p, &end, 10);
+		if (*end != ':') {
+			return -EINVAL;
+		}
+
+		o.duration_s = strtoul(end + 1, &end, 10);
+		if ((*end != ',' && *end != '\0') || o.duration_s == 0) {
+			return -EINVAL;
+		}
+
+		if (outage_count && o.start_s < outages[outage_count - 1].start_s +
+						   outages[outage_count - 1].duration_s) {
+			/* Must be in order and must not overlap */
+			return -EINVAL;
+		}
+
+		outages[outage_count++] = o;
+		p = (*end == ',') ? end + 1 : end;
+	}
+
+	return 0;
+}
+
+/* Runs once the command line is parsed; a bad schedule ends the run */
+static void outage_check(void)
+{
+	if (!outage_arg) {
+		return;
+	}
+
+	int err = outage_parse(outage_arg);
+
+	if (err) {
+		posix_print_error_and_exit("Invalid --outage schedule \"%s\": %d\n", outage_arg,
+					   err);
+	}
+}
+
+NATIVE_TASK(outage_check, PRE_BOOT_2, 1);
+
+static void outage_schedule(void)
+{
+	int64_t now_ms = k_uptime_get();
+	int64_t at_ms;
+
+	if (outage_next == outage_count) {
+		return;
+	}
+
+	at_ms = (int64_t)outages[outage_next].start_s * MSEC_PER_SEC;
+	if (link_down) {
+		at_ms += (int64_t)outages[outage_next].duration_s * MSEC_PER_SEC;
+	}
+
+	k_work_schedule(&outage_work, K_MSEC(MAX(at_ms - now_ms, 0)));
+}
+
+static void outage_work_handler(struct k_work *work)
+{
+	if (!link_down) {
+		LOG_WRN("Link outage: stopping Golioth client for %u s",
+			outages[outage_next].duration_s);
+		golioth_client_stop(outage_client);
+		link_down = true;
+	} else {
+		LOG_WRN("Link restored: starting Golioth client");
+		golioth_client_start(outage_client);
+		link_down = false;
+		outage_next++;
+	}
+
+	outage_schedule();
+}
+
+void app_sim_outage_start(struct golioth_client *client)
+{
+	if (!outage_count) {
+		return;
+	}
+
+	outage_client = client;
+
+	LOG_INF("%zu scheduled outages", outage_count);
+
+	outage_schedule();
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Scheduled network outages on native_sim.
+ *
+ * The `--outage=<start_s>:<duration_s>[,...]` command line option stops the
+ * Golioth client at start_s seconds of uptime and starts it again
+ * duration_s later, so a fleet of simulated devices can lose and regain the
+ * network on a schedule. Readings keep being queued while the client is
+ * stopped, as they are when LTE drops on hardware.
+ */
+
+#ifndef __APP_SIM_OUTAGE_H__
+#define __APP_SIM_OUTAGE_H__
+
+#include <golioth/client.h>
+
+#ifdef CONFIG_APP_SIM_OUTAGE
+
+/** Schedule the outages given on the command line for this client */
+void app_sim_outage_start(struct golioth_client *client);
+
+#else
+
+static inline void app_sim_outage_start(struct golioth_client *client)
+{
+}
+
+#endif /* CONFIG_APP_SIM_OUTAGE */
+
+#endif /* __APP_SIM_OUTAGE_H__ */
@@ -7,22 +7,86 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(app_state, LOG_LEVEL_DBG);
 
+#include <string.h>
 #include <golioth/client.h>
 #include <golioth/lightdb_state.h>
-#include <zephyr/data/json.h>
 #include <zephyr/kernel.h>
-#include "json_helper.h"
 
+#include "app_payloads.h"
 #include "app_state.h"
 #include "app_sensors.h"
 
-#define DEVICE_STATE_FMT "{\"example_int0\":%d,\"example_int1\":%d}"
-
-uint32_t _example_int0;
-uint32_t _example_int1 = 1;
+/* Retry a failed state write after this long */
+#define STATE_RETRY_DELAY K_SECONDS(30)
+
+/* Both dirty masks are passed to the write callback in one pointer */
+BUILD_ASSERT(APP_STATE_FIELD_COUNT <= 16, "Too many state fields");
+#define DIRTY_ARG(actual, desired) ((void *)(uintptr_t)((actual) | ((desired) << 16)))
+#define DIRTY_ACTUAL(arg)	   ((uint32_t)(uintptr_t)(arg) & 0xffff)
+#define DIRTY_DESIRED(arg)	   ((uint32_t)(uintptr_t)(arg) >> 16)
+
+struct state_field {
+	const char *name;
+	size_t offset;
+	int32_t min;
+	int32_t max;
+	void (*on_change)(int32_t value);
+};
+
+#define APP_STATE_FIELD(T, _name, _kind, _flags, _min, _max, _default, _on_change)                 \
+	[APP_STATE_##_name] = {                                                                    \
+		.name = #_name,                                                                    \
+		.offset = offsetof(struct app_state, _name),                                       \
+		.min = _min,                                                                       \
+		.max = _max,                                                                       \
+		.on_change = _on_change,                                                           \
+	},
+
+static const struct state_field fields[APP_STATE_FIELD_COUNT] = {
+	APP_STATE_FIELDS(APP_STATE_FIELD, _)
+};
+
+BUILD_ASSERT(sizeof(struct app_state) == APP_STATE_FIELD_COUNT * sizeof(int32_t),
+	     "State fields must be INT");
+
+#define APP_STATE_DEFAULT(T, name, kind, flags, min, max, default, ...) .name = default,
+#define APP_STATE_RESET(T, name, ...) .name = APP_STATE_NO_CHANGE,
+
+static struct app_state values = {
+	APP_STATE_FIELDS(APP_STATE_DEFAULT, _)
+};
+
+/* Written to the desired fields once they are processed */
+static const struct app_state no_change = {
+	APP_STATE_FIELDS(APP_STATE_RESET, _)
+};
+
+/* Longest write: every field in both objects */
+#ifdef CONFIG_APP_STATE_CBOR
+#define STATE_CONTENT_TYPE GOLIOTH_CONTENT_TYPE_CBOR
+#define STATE_BUF_SIZE                                                                             \
+	(APP_CODEC_CBOR_MAP_OVERHEAD + sizeof(APP_STATE_DESIRED_ENDP) +                            \
+	 sizeof(APP_STATE_ACTUAL_ENDP) + 2 * APP_CODEC_CBOR_MAX(APP_STATE_FIELDS))
+#else
+#define STATE_CONTENT_TYPE GOLIOTH_CONTENT_TYPE_JSON
+#define STATE_JSON_WRAPPER "{\"" APP_STATE_DESIRED_ENDP "\":,\"" APP_STATE_ACTUAL_ENDP "\":}"
+#define STATE_BUF_SIZE	   (sizeof(STATE_JSON_WRAPPER) + 2 * APP_CODEC_JSON_MAX(APP_STATE_FIELDS))
+#endif
+
+/* Fields to write to the actual state, and desired fields to reset */
+static atomic_t actual_dirty;
+static atomic_t desired_dirty;
 
 static struct golioth_client *client;
 
+static void flush_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_handler);
+
+static void flush_schedule(void)
+{
+	k_work_reschedule(&flush_work, K_MSEC(CONFIG_APP_STATE_FLUSH_DELAY_MS));
+}
+
 static void async_handler(struct golioth_client *client,
 			  enum golioth_status status,
 			  const struct golioth_coap_rsp_code *coap_rsp_code,
@@ -31,55 +95,178 @@ static void async_handler(struct golioth_client *client,
 {
 	if (status != GOLIOTH_OK) {
 		LOG_WRN("Failed to set state: %d", status);
+
+		/* Fields changed since are already dirty; merge these back for a retry */
+		atomic_or(&actual_dirty, DIRTY_ACTUAL(arg));
+		atomic_or(&desired_dirty, DIRTY_DESIRED(arg));
+		k_work_schedule(&flush_work, STATE_RETRY_DELAY);
 		return;
 	}
 
 	LOG_DBG("State successfully set");
 }
 
-int app_state_reset_desired(void)
+static int32_t *field_value(struct app_state *state, int i)
 {
-	LOG_INF("Resetting \"%s\" LightDB State endpoint to defaults.", APP_STATE_DESIRED_ENDP);
+	return (int32_t *)((uint8_t *)state + fields[i].offset);
+}
 
-	char sbuf[sizeof(DEVICE_STATE_FMT) + 4]; /* space for two "-1" values */
+#ifdef CONFIG_APP_STATE_CBOR
+/* Desired fields to reset and actual fields to write, as one CBOR map */
+static int state_encode(uint8_t *buf, size_t size, uint32_t actual, uint32_t desired)
+{
+	ZCBOR_STATE_E(zse, 2, buf, size, 1);
+	bool ok = zcbor_map_start_encode(zse, 2);
+
+	if (ok && desired) {
+		ok = zcbor_tstr_put_lit(zse, APP_STATE_DESIRED_ENDP) &&
+		     zcbor_map_start_encode(zse, APP_STATE_FIELD_COUNT) &&
+		     !app_codec_cbor_map_put(&app_state_schema, &no_change, desired, zse) &&
+		     zcbor_map_end_encode(zse, APP_STATE_FIELD_COUNT);
+	}
 
-	snprintk(sbuf, sizeof(sbuf), DEVICE_STATE_FMT, -1, -1);
+	if (ok && actual) {
+		ok = zcbor_tstr_put_lit(zse, APP_STATE_ACTUAL_ENDP) &&
+		     zcbor_map_start_encode(zse, APP_STATE_FIELD_COUNT) &&
+		     !app_codec_cbor_map_put(&app_state_schema, &values, actual, zse) &&
+		     zcbor_map_end_encode(zse, APP_STATE_FIELD_COUNT);
+	}
+
+	ok = ok && zcbor_map_end_encode(zse, 2);
+
+	return ok ? zse->payload - buf : -ENOMEM;
+}
+
+static int state_decode(const uint8_t *payload, size_t len, struct app_state *state)
+{
+	return app_codec_cbor_decode(&app_state_schema, payload, len, state);
+}
+#else
+/* Append "key":{...} with the fields in mask */
+static int json_object_append(uint8_t *buf, size_t size, size_t *len, const char *key,
+			      const struct app_state *state, uint32_t mask)
+{
+	size_t key_len = strlen(key);
+
+	/* The buffer is sized for the longest state, so only the objects are checked */
+	if (*len > 1) {
+		buf[(*len)++] = ',';
+	}
+	buf[(*len)++] = '"';
+	memcpy(&buf[*len], key, key_len);
+	*len += key_len;
+	buf[(*len)++] = '"';
+	buf[(*len)++] = ':';
+
+	int ret = app_codec_json_encode(&app_state_schema, state, mask, (char *)&buf[*len],
+					size - *len);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	*len += ret;
+
+	return 0;
+}
+
+/* Desired fields to reset and actual fields to write, as one JSON object */
+static int state_encode(uint8_t *buf, size_t size, uint32_t actual, uint32_t desired)
+{
+	size_t len = 0;
+	int err = 0;
+
+	buf[len++] = '{';
+
+	if (desired) {
+		err = json_object_append(buf, size, &len, APP_STATE_DESIRED_ENDP, &no_change,
+					 desired);
+	}
+
+	if (actual && !err) {
+		err = json_object_append(buf, size, &len, APP_STATE_ACTUAL_ENDP, &values, actual);
+	}
 
-	int err;
-	err = golioth_lightdb_set_async(client,
-					APP_STATE_DESIRED_ENDP,
-					GOLIOTH_CONTENT_TYPE_JSON,
-					sbuf,
-					strlen(sbuf),
-					async_handler,
-					NULL);
 	if (err) {
-		LOG_ERR("Unable to write to LightDB State: %d", err);
+		return err;
 	}
-	return err;
+
+	buf[len++] = '}';
+
+	return len;
 }
 
-int app_state_update_actual(void)
+static int state_decode(const uint8_t *payload, size_t len, struct app_state *state)
 {
+	return app_codec_json_decode(&app_state_schema, (const char *)payload, len, state);
+}
+#endif /* CONFIG_APP_STATE_CBOR */
 
-	char sbuf[sizeof(DEVICE_STATE_FMT) + 10]; /* space for uint16 values */
+static void flush_work_handler(struct k_work *work)
+{
+	uint8_t buf[STATE_BUF_SIZE];
 
-	snprintk(sbuf, sizeof(sbuf), DEVICE_STATE_FMT, _example_int0, _example_int1);
+	uint32_t actual = atomic_clear(&actual_dirty);
+	uint32_t desired = atomic_clear(&desired_dirty);
 
-	int err;
+	if (!actual && !desired) {
+		return;
+	}
+
+	if (desired) {
+		LOG_INF("Resetting %d \"%s\" field(s) to %d", POPCOUNT(desired),
+			APP_STATE_DESIRED_ENDP, APP_STATE_NO_CHANGE);
+	}
 
-	err = golioth_lightdb_set_async(client,
-					APP_STATE_ACTUAL_ENDP,
-					GOLIOTH_CONTENT_TYPE_JSON,
-					sbuf,
-					strlen(sbuf),
-					async_handler,
-					NULL);
+	int len = state_encode(buf, sizeof(buf), actual, desired);
 
+	if (len < 0) {
+		LOG_ERR("State does not fit in %zu bytes", sizeof(buf));
+		return;
+	}
+
+	/* LightDB State merges objects, so other paths under the root are kept */
+	int err = golioth_lightdb_set_async(client,
+					    "",
+					    STATE_CONTENT_TYPE,
+					    buf,
+					    len,
+					    async_handler,
+					    DIRTY_ARG(actual, desired));
 	if (err) {
 		LOG_ERR("Unable to write to LightDB State: %d", err);
+		atomic_or(&actual_dirty, actual);
+		atomic_or(&desired_dirty, desired);
+		k_work_schedule(&flush_work, STATE_RETRY_DELAY);
+	}
+}
+
+int32_t app_state_get(enum app_state_field field)
+{
+	return *field_value(&values, field);
+}
+
+int app_state_set(enum app_state_field field, int32_t value)
+{
+	if (!IN_RANGE(value, fields[field].min, fields[field].max)) {
+		return -EINVAL;
+	}
+
+	if (*field_value(&values, field) != value) {
+		*field_value(&values, field) = value;
+		atomic_or(&actual_dirty, BIT(field));
+		flush_schedule();
 	}
-	return err;
+
+	return 0;
+}
+
+int app_state_update_actual(void)
+{
+	atomic_or(&actual_dirty, BIT_MASK(APP_STATE_FIELD_COUNT));
+	flush_schedule();
+
+	return 0;
 }
 
 static void app_state_desired_handler(struct golioth_client *client, enum golioth_status status,
@@ -87,7 +274,6 @@ static void app_state_desired_handler(struct golioth_client *client, enum goliot
 				      const char *path, const uint8_t *payload, size_t payload_size,
 				      void *arg)
 {
-	int err = 0;
 	int ret;
 
 	if (status != GOLIOTH_OK) {
@@ -99,68 +285,50 @@ static void app_state_desired_handler(struct golioth_client *client, enum goliot
 
 	struct app_state parsed_state;
 
-	ret = json_obj_parse((char *)payload, payload_size, app_state_descr,
-			     ARRAY_SIZE(app_state_descr), &parsed_state);
+	ret = state_decode(payload, payload_size, &parsed_state);
 
 	if (ret < 0) {
 		LOG_ERR("Error parsing desired values: %d", ret);
-		app_state_reset_desired();
+		atomic_or(&desired_dirty, BIT_MASK(APP_STATE_FIELD_COUNT));
+		flush_schedule();
 		return;
 	}
 
-	uint8_t desired_processed_count = 0;
-	uint8_t state_change_count = 0;
+	for (int i = 0; i < APP_STATE_FIELD_COUNT; i++) {
+		const struct state_field *f = &fields[i];
+		int32_t value = *field_value(&parsed_state, i);
 
-	if (ret & 1 << 0) {
-		/* Process example_int0 */
-		if ((parsed_state.example_int0 >= 0) && (parsed_state.example_int0 < 65536)) {
-			LOG_DBG("Validated desired example_int0 value: %d",
-				parsed_state.example_int0);
-			if (_example_int0 != parsed_state.example_int0) {
-				_example_int0 = parsed_state.example_int0;
-				++state_change_count;
-			}
-			++desired_processed_count;
-		} else if (parsed_state.example_int0 == -1) {
-			LOG_DBG("No change requested for example_int0");
-		} else {
-			LOG_ERR("Invalid desired example_int0 value: %d",
-				parsed_state.example_int0);
-			++desired_processed_count;
+		if (!(ret & BIT(i))) {
+			continue;
 		}
-	}
-	if (ret & 1 << 1) {
-		/* Process example_int1 */
-		if ((parsed_state.example_int1 >= 0) && (parsed_state.example_int1 < 65536)) {
-			LOG_DBG("Validated desired example_int1 value: %d",
-				parsed_state.example_int1);
-			if (_example_int1 != parsed_state.example_int1) {
-				_example_int1 = parsed_state.example_int1;
-				++state_change_count;
-			}
-			++desired_processed_count;
-		} else if (parsed_state.example_int1 == -1) {
-			LOG_DBG("No change requested for example_int1");
-		} else {
-			LOG_ERR("Invalid desired example_int1 value: %d",
-				parsed_state.example_int1);
-			++desired_processed_count;
+
+		if (value == APP_STATE_NO_CHANGE) {
+			LOG_DBG("No change requested for %s", f->name);
+			continue;
 		}
-	}
 
-	if (state_change_count) {
-		/* The state was changed, so update the state on the Golioth servers */
-		err = app_state_update_actual();
-	}
-	if (desired_processed_count) {
-		/* We processed some desired changes to return these to -1 on the server
-		 * to indicate the desired values were received.
-		 */
-		err = app_state_reset_desired();
+		/* Processed: reset the desired value whether it was valid or not */
+		atomic_or(&desired_dirty, BIT(i));
+
+		if (!IN_RANGE(value, f->min, f->max)) {
+			LOG_ERR("Invalid desired %s value: %d", f->name, value);
+			continue;
+		}
+
+		LOG_DBG("Validated desired %s value: %d", f->name, value);
+
+		if (*field_value(&values, i) != value) {
+			*field_value(&values, i) = value;
+			atomic_or(&actual_dirty, BIT(i));
+
+			if (f->on_change) {
+				f->on_change(value);
+			}
+		}
 	}
 
-	if (err) {
-		LOG_ERR("Failed to update cloud state: %d", err);
+	if (atomic_get(&actual_dirty) || atomic_get(&desired_dirty)) {
+		flush_schedule();
 	}
 }
 
@@ -172,7 +340,7 @@ int app_state_observe(struct golioth_client *state_client)
 
 	err = golioth_lightdb_observe_async(client,
 					    APP_STATE_DESIRED_ENDP,
-					    GOLIOTH_CONTENT_TYPE_JSON,
+					    STATE_CONTENT_TYPE,
 					    app_state_desired_handler,
 					    NULL);
 	if (err) {
@@ -184,7 +352,5 @@ int app_state_observe(struct golioth_client *state_client)
 	 * with the Golioth servers. Future updates will be sent whenever
 	 * changes occur.
 	 */
-	err = app_state_update_actual();
-
-	return err;
+	return app_state_update_actual();
 }
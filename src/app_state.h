@@ -20,18 +20,50 @@
  * The device should write to the _actual state_ endpoint, the cloud should not.
  * By convention the cloud should consider the _actual state_ values read-only.
  *
+ * Fields are described once in APP_STATE_FIELDS (app_payloads.h), from which
+ * the codecs, range checks and change callbacks are generated. Changed actual
+ * values and processed desired values are marked dirty and written together in
+ * a single request to the LightDB State root, after CONFIG_APP_STATE_FLUSH_DELAY_MS
+ * without further changes. State is exchanged as JSON, or as CBOR with
+ * CONFIG_APP_STATE_CBOR.
+ *
  * https://docs.golioth.io/firmware/zephyr-device-sdk/light-db/
  */
 
 #ifndef __APP_STATE_H__
 #define __APP_STATE_H__
 
+#include <stdint.h>
 #include <golioth/client.h>
 
+#include "app_payloads.h"
+
 #define APP_STATE_DESIRED_ENDP "desired"
 #define APP_STATE_ACTUAL_ENDP  "state"
 
+/* Desired value meaning "no change requested" */
+#define APP_STATE_NO_CHANGE -1
+
+/*
+ * The fields, enum app_state_field and struct app_state are generated from
+ * APP_STATE_FIELDS: X(T, name, INT, 0, min, max, default, on_change).
+ *
+ * on_change is a void (*)(int32_t value) called from the Golioth client
+ * thread when the cloud changes the field, or NULL.
+ */
+
 int app_state_observe(struct golioth_client *state_client);
+
+/** Report all actual values again */
 int app_state_update_actual(void);
 
+int32_t app_state_get(enum app_state_field field);
+
+/**
+ * Change a field from the device side and report it.
+ *
+ * @return 0 on success, -EINVAL if value is out of the field's range
+ */
+int app_state_set(enum app_state_field field, int32_t value);
+
 #endif /* __APP_STATE_H__ */
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include "app_ram.h"
+#include "app_workq.h"
+
+struct k_work_q app_work_q;
+K_THREAD_STACK_DEFINE(app_work_stack, CONFIG_APP_WORKQ_STACK_SIZE);
+
+struct k_work_q app_upload_work_q;
+K_THREAD_STACK_DEFINE(app_upload_work_stack, CONFIG_APP_UPLOAD_WORKQ_STACK_SIZE);
+
+void app_workq_init(void)
+{
+	k_work_queue_init(&app_work_q);
+	k_work_queue_start(&app_work_q, app_work_stack, K_THREAD_STACK_SIZEOF(app_work_stack),
+			   CONFIG_APP_WORKQ_PRIORITY, &(struct k_work_queue_config){.name = "app"});
+
+	k_work_queue_init(&app_upload_work_q);
+	k_work_queue_start(&app_upload_work_q, app_upload_work_stack,
+			   K_THREAD_STACK_SIZEOF(app_upload_work_stack), CONFIG_APP_WORKQ_PRIORITY,
+			   &(struct k_work_queue_config){.name = "upload"});
+}
+
+static void stack_usage(struct app_ram_usage *usage, const char *name, struct k_work_q *queue,
+			size_t size)
+{
+	*usage = (struct app_ram_usage){
+		.name = name,
+		.size = size,
+	};
+
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
+	size_t unused;
+
+	if (k_thread_stack_space_get(k_work_queue_thread_get(queue), &unused) == 0) {
+		/* The stack never shrinks; what was touched once stays used */
+		usage->used = usage->size - unused;
+		usage->peak = usage->used;
+	}
+#endif
+}
+
+size_t app_workq_ram_usage(struct app_ram_usage *usage, size_t max)
+{
+	size_t n = 0;
+
+	if (n < max) {
+		stack_usage(&usage[n++], "app_workq_stack", &app_work_q,
+			    K_THREAD_STACK_SIZEOF(app_work_stack));
+	}
+
+	if (n < max) {
+		stack_usage(&usage[n++], "upload_workq_stack", &app_upload_work_q,
+			    K_THREAD_STACK_SIZEOF(app_upload_work_stack));
+	}
+
+	return n;
+}
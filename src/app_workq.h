@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Application work queues.
+ *
+ * NMEA parsing, weather sampling, flight recorder samples and battery reports
+ * run as work items on app_work_q. Work which blocks runs on
+ * app_upload_work_q, so sentences keep being parsed meanwhile: batch uploads,
+ * which wait until Golioth acknowledges each batch, the shutdown drain, and
+ * the Ostentus faceplate (its reset and init tasks, slide refreshes and LED
+ * writes over I2C). Nothing polls: items are submitted
+ * when a sentence is received, a timer is due, the reading queue fills up or
+ * the Golioth connection comes up, so the threads only wake when there is
+ * work to do.
+ */
+
+#ifndef __APP_WORKQ_H__
+#define __APP_WORKQ_H__
+
+#include <zephyr/kernel.h>
+
+extern struct k_work_q app_work_q;
+extern struct k_work_q app_upload_work_q;
+
+/** Start the work queues; must be called before anything is submitted to them */
+void app_workq_init(void);
+
+struct app_ram_usage;
+
+/**
+ * Report the RAM of the work queue stacks; the use is only known with
+ * CONFIG_INIT_STACKS.
+ *
+ * @return number of entries filled, at most max
+ */
+size_t app_workq_ram_usage(struct app_ram_usage *usage, size_t max);
+
+#endif /* __APP_WORKQ_H__ */
@@ -8,10 +8,23 @@
 LOG_MODULE_REGISTER(golioth_cold_chain, LOG_LEVEL_DBG);
 
 #include <app_version.h>
+#include "app_boot.h"
+#include "app_display.h"
+#include "app_energy.h"
+#include "app_geofence.h"
+#include "app_gnss_aid.h"
+#include "app_history.h"
+#include "app_live_track.h"
+#include "app_log_dict.h"
+#include "app_metrics.h"
+#include "app_ota_delta.h"
+#include "app_recorder.h"
 #include "app_rpc.h"
 #include "app_settings.h"
+#include "app_sim_outage.h"
 #include "app_state.h"
 #include "app_sensors.h"
+#include "app_workq.h"
 #include <golioth/client.h>
 #include <golioth/fw_update.h>
 #include <samples/common/net_connect.h>
@@ -43,8 +56,6 @@ static const char *_current_version =
 static struct golioth_client *client;
 K_SEM_DEFINE(connected, 0, 1);
 
-static k_tid_t _system_thread = 0;
-
 #if DT_NODE_EXISTS(DT_ALIAS(golioth_led))
 static const struct gpio_dt_spec golioth_led = GPIO_DT_SPEC_GET(DT_ALIAS(golioth_led), gpios);
 #endif /* DT_NODE_EXISTS(DT_ALIAS(golioth_led)) */
@@ -54,23 +65,69 @@ static struct gpio_callback button_cb_data;
 /* forward declarations */
 void golioth_connection_led_set(uint8_t state);
 
-void wake_system_thread(void)
-{
-	k_wakeup(_system_thread);
-}
-
 static void on_client_event(struct golioth_client *client, enum golioth_client_event event,
 			    void *arg)
 {
 	bool is_connected = (event == GOLIOTH_CLIENT_EVENT_CONNECTED);
 
 	if (is_connected) {
+		app_boot_mark(APP_BOOT_GOLIOTH_CONNECTED);
 		k_sem_give(&connected);
 		golioth_connection_led_set(1);
+
+		/* Upload what was queued while offline */
+		app_sensors_wake();
+		IF_ENABLED(CONFIG_APP_GEOFENCE, (app_geofence_flush();));
 	}
 	LOG_INF("Golioth client %s", is_connected ? "connected" : "disconnected");
 }
 
+#ifdef CONFIG_GOLIOTH_FW_UPDATE
+/* Longest checkpoint to flash after the upload deadline of a shutdown */
+#define SHUTDOWN_CHECKPOINT_MS 5000
+
+static K_SEM_DEFINE(fw_update_shutdown_sem, 0, 1);
+
+static void fw_update_shutdown_done(int err, uint32_t sent, uint32_t saved)
+{
+	app_gnss_aid_save();
+	k_sem_give(&fw_update_shutdown_sem);
+}
+
+static void on_fw_update_state(enum golioth_ota_state state, enum golioth_ota_reason reason,
+			       void *user_arg)
+{
+	if (state == GOLIOTH_OTA_STATE_DOWNLOADING) {
+		/* Wait out a delta update writing the secondary slot; it reboots if it succeeds */
+		app_ota_slot_claim(APP_OTA_SLOT_FULL, K_FOREVER);
+		return;
+	}
+
+	if (state == GOLIOTH_OTA_STATE_IDLE) {
+		/* The update failed or was aborted after sampling was stopped */
+		app_ota_slot_release(APP_OTA_SLOT_FULL);
+		app_sensors_resume();
+		return;
+	}
+
+	if (state != GOLIOTH_OTA_STATE_UPDATING) {
+		return;
+	}
+
+	/* The new image is about to boot; preserve queued readings first. The drain runs on the
+	 * upload work queue. States are reported from the fw_update thread, which reboots once this
+	 * returns, so wait for it here; the client thread stays free to carry the uploads.
+	 */
+	k_sem_reset(&fw_update_shutdown_sem);
+
+	if (app_sensors_shutdown_async(CONFIG_APP_SHUTDOWN_FLUSH_TIMEOUT_MS,
+				       fw_update_shutdown_done) >= 0) {
+		k_sem_take(&fw_update_shutdown_sem,
+			   K_MSEC(CONFIG_APP_SHUTDOWN_FLUSH_TIMEOUT_MS + SHUTDOWN_CHECKPOINT_MS));
+	}
+}
+#endif /* CONFIG_GOLIOTH_FW_UPDATE */
+
 static void start_golioth_client(void)
 {
 	/* Get the client configuration from auto-loaded settings */
@@ -82,8 +139,14 @@ static void start_golioth_client(void)
 	/* Register Golioth on_connect callback */
 	golioth_client_register_event_callback(client, on_client_event, NULL);
 
+#ifdef CONFIG_GOLIOTH_FW_UPDATE
 	/* Initialize DFU components */
 	golioth_fw_update_init(client, _current_version);
+	golioth_fw_update_register_state_change_callback(on_fw_update_state, NULL);
+
+	/* Patches against the running image, published as their own package */
+	app_ota_delta_observe(client, _current_version);
+#endif
 
 	/*** Call Golioth APIs for other services in dedicated app files ***/
 
@@ -93,24 +156,42 @@ static void start_golioth_client(void)
 	/* Set Golioth Client for streaming sensor data */
 	app_sensors_set_client(client);
 
+	app_metrics_stream_start(client);
+	app_energy_stream_start(client);
+	app_log_dict_set_client(client);
+	app_history_set_client(client);
+	app_recorder_set_client(client);
+	app_live_track_set_client(client);
+
 	/* Register Settings service */
 	app_settings_register(client);
 
 	/* Register RPC service */
 	app_rpc_register(client);
+
+	/* Simulated network outages (native_sim) */
+	app_sim_outage_start(client);
+
+	/* Observe the geofence set */
+	IF_ENABLED(CONFIG_APP_GEOFENCE, (app_geofence_observe(client);));
 }
 
 #ifdef CONFIG_SOC_SERIES_NRF91X
 
 static void lte_handler(const struct lte_lc_evt *const evt)
 {
+	app_energy_lte_evt(evt);
+
 	if (evt->type == LTE_LC_EVT_NW_REG_STATUS) {
 
 		if ((evt->nw_reg_status == LTE_LC_NW_REG_REGISTERED_HOME) ||
 		    (evt->nw_reg_status == LTE_LC_NW_REG_REGISTERED_ROAMING)) {
 
+			app_boot_mark(APP_BOOT_NET_CONNECTED);
+
 			/* Change the state of the Internet LED on Ostentus */
-			IF_ENABLED(CONFIG_LIB_OSTENTUS, (ostentus_led_internet_set(o_dev, 1);));
+			IF_ENABLED(CONFIG_LIB_OSTENTUS,
+				   (app_display_led_set(APP_DISPLAY_LED_INTERNET, true);));
 
 			if (!client) {
 				/* Create and start a Golioth Client */
@@ -146,7 +227,12 @@ void button_pressed(const struct device *dev, struct gpio_callback *cb, uint32_t
 	/* This function is an Interrupt Service Routine. Do not call functions that
 	 * use other threads, or perform long-running operations here
 	 */
-	k_wakeup(_system_thread);
+	app_sensors_wake();
+
+	/* Also marks the moment in the flight recorder; ignored while a burst is pending or
+	 * the recorder is paused
+	 */
+	app_recorder_trigger(APP_RECORDER_BUTTON);
 }
 
 /* Set (unset) LED indicators for active Golioth connection */
@@ -159,67 +245,193 @@ void golioth_connection_led_set(uint8_t state)
 	IF_ENABLED(DT_NODE_EXISTS(DT_ALIAS(golioth_led)),
 		(gpio_pin_set_dt(&golioth_led, pin_state);));
 
-	/* Change the state of the Golioth LED on Ostentus */
-	IF_ENABLED(CONFIG_LIB_OSTENTUS, (ostentus_led_golioth_set(o_dev, pin_state);));
+	/* Change the state of the Golioth LED on Ostentus, once it has been reset */
+	IF_ENABLED(CONFIG_LIB_OSTENTUS, (app_display_led_set(APP_DISPLAY_LED_GOLIOTH, pin_state);));
 }
 
-int main(void)
+static void init_sensors(void)
 {
-	int err;
+	app_sensors_init();
+	app_boot_mark(APP_BOOT_SENSORS_READY);
+}
 
-	LOG_DBG("Start Golioth Cold Chain Asset Tracker");
+static void init_button(void)
+{
+	int err = gpio_pin_configure_dt(&user_btn, GPIO_INPUT);
 
-	LOG_INF("Firmware version: %s", _current_version);
-	IF_ENABLED(CONFIG_MODEM_INFO, (log_modem_firmware_version();));
+	if (err) {
+		LOG_ERR("Error %d: failed to configure %s pin %d", err, user_btn.port->name,
+			user_btn.pin);
+		return;
+	}
 
-	app_sensors_init();
+	err = gpio_pin_interrupt_configure_dt(&user_btn, GPIO_INT_EDGE_TO_ACTIVE);
+	if (err) {
+		LOG_ERR("Error %d: failed to configure interrupt on %s pin %d", err,
+			user_btn.port->name, user_btn.pin);
+		return;
+	}
+
+	gpio_init_callback(&button_cb_data, button_pressed, BIT(user_btn.pin));
+	gpio_add_callback(user_btn.port, &button_cb_data);
+}
+
+#ifdef CONFIG_LIB_OSTENTUS
+static void init_display(void)
+{
+	/* Reset Ostentus and pause for reboot */
+	ostentus_reset(o_dev);
+	k_msleep(300);
 
-	/* Update Ostentus LEDS using bitmask (Power On and Battery)*/
-	IF_ENABLED(CONFIG_LIB_OSTENTUS, (
-		/* Reset Ostentus and pause for reboot */
-		ostentus_reset(o_dev);
-		k_msleep(300);
+	/* Read firmware version from faceplate */
+	char o_version[32] = {0};
 
-		/* Read firmware version from faceplate */
-		char *o_version = (char *)calloc(32, sizeof(char));
+	ostentus_version_get(o_dev, o_version, sizeof(o_version));
+	LOG_INF("Ostentus reports firmware version: %s", o_version);
 
-		ostentus_version_get(o_dev, o_version, 32);
-		LOG_INF("Ostentus reports firmware version: %s", o_version);
-		free(o_version);
+	/* Update Ostentus LEDS using bitmask (Power On and Battery) */
+	ostentus_led_bitmask(o_dev, LED_POW | LED_BAT);
 
-		/* Update Ostentus LEDS using bitmask (Power On and Battery) */
-		ostentus_led_bitmask(o_dev, LED_POW | LED_BAT);
+	/* The connection may have come up during the reset; LEDs set since are applied now */
+	app_display_leds_start();
 
-		/* Show Golioth Logo on Ostentus ePaper screen */
-		ostentus_show_splash(o_dev);
+	/* Show Golioth Logo on Ostentus ePaper screen */
+	ostentus_show_splash(o_dev);
+}
+
+static void init_slides(void)
+{
+	/* Set up a slideshow on Ostentus
+	 *  - add up to 256 slides
+	 *  - use the enum in app_sensors.h to add new keys
+	 *  - values are updated using these keys (see app_sensors.c)
+	 */
+	ostentus_slide_add(o_dev, SLIDE_LAT, LABEL_LAT, strlen(LABEL_LAT));
+	ostentus_slide_add(o_dev, SLIDE_LON, LABEL_LON, strlen(LABEL_LON));
+	ostentus_slide_add(o_dev, SLIDE_TEM, LABEL_TEM, strlen(LABEL_TEM));
+	IF_ENABLED(CONFIG_ALUDEL_BATTERY_MONITOR, (
+		ostentus_slide_add(o_dev,
+				   BATTERY_V,
+				   LABEL_BATTERY,
+				   strlen(LABEL_BATTERY));
+		ostentus_slide_add(o_dev,
+				   BATTERY_LVL,
+				   LABEL_BATTERY,
+				   strlen(LABEL_BATTERY));
 	));
+	ostentus_slide_add(o_dev, FIRMWARE, LABEL_FIRMWARE, strlen(LABEL_FIRMWARE));
+
+	/* Set the title of the Ostentus summary slide (optional) */
+	ostentus_summary_title(o_dev, SUMMARY_TITLE, strlen(SUMMARY_TITLE));
+
+	/* Update the Firmware slide with the firmware version */
+	ostentus_slide_set(o_dev, FIRMWARE, (char *)_current_version,
+			   strlen(_current_version));
+
+	/* Start Ostentus slideshow with 30 second delay between slides */
+	ostentus_slideshow(o_dev, 30000);
+
+	/* Slides exist now; start writing values published by the app */
+	app_display_init();
+	app_boot_mark(APP_BOOT_DISPLAY_READY);
+}
+#endif /* CONFIG_LIB_OSTENTUS */
+
+/* Startup work which runs concurrently with the LTE attach started by main() */
+enum init_task_id {
+#ifdef CONFIG_MODEM_INFO
+	INIT_MODEM_INFO,
+#endif
+	INIT_SENSORS,
+	INIT_BUTTON,
+#ifdef CONFIG_LIB_OSTENTUS
+	INIT_DISPLAY,
+	INIT_SLIDES,
+#endif
+	INIT_TASK_COUNT
+};
+
+static struct app_boot_task init_tasks[INIT_TASK_COUNT] = {
+#ifdef CONFIG_MODEM_INFO
+	[INIT_MODEM_INFO] = {
+		.name = "modem_info",
+		.fn = log_modem_firmware_version,
+		.queue = &k_sys_work_q,
+	},
+#endif
+	[INIT_SENSORS] = {
+		.name = "sensors",
+		.fn = init_sensors,
+		.queue = &k_sys_work_q,
+	},
+	[INIT_BUTTON] = {
+		.name = "button",
+		.fn = init_button,
+		.queue = &k_sys_work_q,
+	},
+#ifdef CONFIG_LIB_OSTENTUS
+	/* The e-paper faceplate is slow to bring up; keep it off the system work queue and away
+	 * from the NMEA parser
+	 */
+	[INIT_DISPLAY] = {
+		.name = "display",
+		.fn = init_display,
+		.queue = &app_upload_work_q,
+	},
+	[INIT_SLIDES] = {
+		.name = "slides",
+		.fn = init_slides,
+		.deps = BIT(INIT_DISPLAY),
+		.queue = &app_upload_work_q,
+	},
+#endif
+};
+
+int main(void)
+{
+	app_boot_mark(APP_BOOT_MAIN);
+
+	LOG_DBG("Start Golioth Cold Chain Asset Tracker");
+
+	LOG_INF("Firmware version: %s", _current_version);
+
+	/* Parsing and sensing run on app_work_q; uploads, the display and the display and
+	 * slides init tasks below run on app_upload_work_q (the other init tasks use the system
+	 * work queue)
+	 */
+	app_workq_init();
+
+#ifdef CONFIG_SOC_SERIES_NRF91X
+	/* Start LTE asynchronously if the nRF9160 is used. This is done first
+	 * because attaching takes the longest. Golioth Client will start
+	 * automatically when LTE connects
+	 */
 
-	/* Get system thread id so loop delay change event can wake main */
-	_system_thread = k_current_get();
+	LOG_INF("Connecting to LTE, this may take some time...");
+	app_boot_mark(APP_BOOT_LTE_START);
+	lte_lc_connect_async(lte_handler);
+#endif /* CONFIG_SOC_SERIES_NRF91X */
 
 #if DT_NODE_EXISTS(DT_ALIAS(golioth_led))
 	/* Initialize Golioth logo LED */
-	err = gpio_pin_configure_dt(&golioth_led, GPIO_OUTPUT_INACTIVE);
+	int err = gpio_pin_configure_dt(&golioth_led, GPIO_OUTPUT_INACTIVE);
+
 	if (err) {
 		LOG_ERR("Unable to configure LED for Golioth Logo");
 	}
 #endif /* #if DT_NODE_EXISTS(DT_ALIAS(golioth_led)) */
 
-#ifdef CONFIG_SOC_SERIES_NRF91X
-	/* Start LTE asynchronously if the nRF9160 is used.
-	 * Golioth Client will start automatically when LTE connects
-	 */
-
-	LOG_INF("Connecting to LTE, this may take some time...");
-	lte_lc_connect_async(lte_handler);
+	/* Bring up modem info, sensors, button and display in the background */
+	app_boot_run(init_tasks, ARRAY_SIZE(init_tasks));
 
-#else
+#ifndef CONFIG_SOC_SERIES_NRF91X
 	/* If nRF9160 is not used, start the Golioth Client and block until connected */
 
 	/* Run WiFi/DHCP if necessary */
 	if (IS_ENABLED(CONFIG_GOLIOTH_SAMPLE_COMMON)) {
 		net_connect();
 	}
+	app_boot_mark(APP_BOOT_NET_CONNECTED);
 
 	/* Start Golioth client */
 	start_golioth_client();
@@ -228,59 +440,6 @@ int main(void)
 	k_sem_take(&connected, K_FOREVER);
 #endif /* CONFIG_SOC_SERIES_NRF91X */
 
-	/* Set up user button */
-	err = gpio_pin_configure_dt(&user_btn, GPIO_INPUT);
-	if (err) {
-		LOG_ERR("Error %d: failed to configure %s pin %d", err, user_btn.port->name,
-			user_btn.pin);
-		return err;
-	}
-
-	err = gpio_pin_interrupt_configure_dt(&user_btn, GPIO_INT_EDGE_TO_ACTIVE);
-	if (err) {
-		LOG_ERR("Error %d: failed to configure interrupt on %s pin %d", err,
-			user_btn.port->name, user_btn.pin);
-		return err;
-	}
-
-	gpio_init_callback(&button_cb_data, button_pressed, BIT(user_btn.pin));
-	gpio_add_callback(user_btn.port, &button_cb_data);
-
-	IF_ENABLED(CONFIG_LIB_OSTENTUS,(
-		/* Set up a slideshow on Ostentus
-		 *  - add up to 256 slides
-		 *  - use the enum in app_sensors.h to add new keys
-		 *  - values are updated using these keys (see app_sensors.c)
-		 */
-		ostentus_slide_add(o_dev, SLIDE_LAT, LABEL_LAT, strlen(LABEL_LAT));
-		ostentus_slide_add(o_dev, SLIDE_LON, LABEL_LON, strlen(LABEL_LON));
-		ostentus_slide_add(o_dev, SLIDE_TEM, LABEL_TEM, strlen(LABEL_TEM));
-		IF_ENABLED(CONFIG_ALUDEL_BATTERY_MONITOR, (
-			ostentus_slide_add(o_dev,
-					   BATTERY_V,
-					   LABEL_BATTERY,
-					   strlen(LABEL_BATTERY));
-			ostentus_slide_add(o_dev,
-					   BATTERY_LVL,
-					   LABEL_BATTERY,
-					   strlen(LABEL_BATTERY));
-		));
-		ostentus_slide_add(o_dev, FIRMWARE, LABEL_FIRMWARE, strlen(LABEL_FIRMWARE));
-
-		/* Set the title of the Ostentus summary slide (optional) */
-		ostentus_summary_title(o_dev, SUMMARY_TITLE, strlen(SUMMARY_TITLE));
-
-		/* Update the Firmware slide with the firmware version */
-		ostentus_slide_set(o_dev, FIRMWARE, (char *)_current_version,
-			  strlen(_current_version));
-
-		/* Start Ostentus slideshow with 30 second delay between slides */
-		ostentus_slideshow(o_dev, 30000);
-	));
-
-	while (true) {
-		app_sensors_read_and_stream();
-
-		k_sleep(K_SECONDS(get_loop_delay_s()));
-	}
+	/* Everything else is driven by events on the app and upload work queues */
+	return 0;
 }
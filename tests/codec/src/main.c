@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "app_payloads.h"
+
+#define BUF_SIZE 512
+
+/* 2024-02-29T23:59:59.999Z, the last millisecond of a leap day */
+#define LEAP_DAY_2024_MS 1709251199999LL
+/* 2000-02-29T00:00:00.000Z, a leap day in a century divisible by 400 */
+#define LEAP_DAY_2000_MS 951782400000LL
+/* 2100-03-01T00:00:00.000Z, 2100 is not a leap year */
+#define MARCH_2100_MS	 4107542400000LL
+/* 10000-01-01T00:00:00.000Z, the first time past the years 0 to 9999 */
+#define YEAR_10000_MS	 253402300800000LL
+
+static char json[BUF_SIZE];
+static uint8_t cbor[BUF_SIZE];
+
+/* Encode obj in both formats and check every field decodes back unchanged */
+static void round_trip(const struct app_codec_schema *schema, const void *obj, void *out,
+		       size_t size, size_t json_max, size_t cbor_max)
+{
+	int len;
+
+	len = app_codec_json_encode(schema, obj, APP_CODEC_ALL, json, sizeof(json));
+	zassert_true(len > 0 && len <= json_max, "JSON length %d", len);
+	zassert_equal(strlen(json), len);
+
+	memset(out, 0, size);
+	zassert_equal(app_codec_json_decode(schema, json, len, out), BIT_MASK(schema->count),
+		      "%s", json);
+	zassert_equal(memcmp(out, obj, size), 0, "%s", json);
+
+	len = app_codec_cbor_encode(schema, obj, APP_CODEC_ALL, cbor, sizeof(cbor));
+	zassert_true(len > 0 && len <= cbor_max, "CBOR length %d", len);
+
+	memset(out, 0, size);
+	zassert_equal(app_codec_cbor_decode(schema, cbor, len, out), BIT_MASK(schema->count));
+	zassert_equal(memcmp(out, obj, size), 0);
+}
+
+#define ROUND_TRIP(type, list, obj)                                                                \
+	do {                                                                                       \
+		struct type out;                                                                   \
+                                                                                                   \
+		round_trip(&type##_schema, obj, &out, sizeof(out), APP_CODEC_JSON_MAX(list),       \
+			   APP_CODEC_CBOR_MAX(list));                                              \
+	} while (0)
+
+static int64_t json_time_decode(const char *payload)
+{
+	struct app_reading reading = {0};
+
+	zassert_equal(app_codec_json_decode(&app_reading_schema, payload, strlen(payload),
+					    &reading),
+		      BIT(APP_READING_time), "%s", payload);
+
+	return reading.time;
+}
+
+static void json_time_check(int64_t unix_ms, const char *expected)
+{
+	struct app_reading reading = {.time = unix_ms};
+	int len;
+
+	len = app_codec_json_encode(&app_reading_schema, &reading, BIT(APP_READING_time), json,
+				    sizeof(json));
+	zassert_true(len > 0);
+	zassert_equal(strcmp(json, expected), 0, "%s", json);
+	zassert_equal(json_time_decode(json), unix_ms, "%s", json);
+
+	len = app_codec_cbor_encode(&app_reading_schema, &reading, BIT(APP_READING_time), cbor,
+				    sizeof(cbor));
+	zassert_true(len > 0);
+
+	reading.time = 0;
+	zassert_equal(app_codec_cbor_decode(&app_reading_schema, cbor, len, &reading),
+		      BIT(APP_READING_time));
+	zassert_equal(reading.time, unix_ms);
+}
+
+ZTEST(codec, test_reading_round_trip)
+{
+	struct app_reading reading = {
+		.lat = 59334591,
+		.lon = -18063240,
+		.time = LEAP_DAY_2024_MS,
+		.tem = -4250000,
+		.pre = 101325000,
+		.hum = 45500000,
+	};
+
+	ROUND_TRIP(app_reading, APP_READING_FIELDS, &reading);
+}
+
+ZTEST(codec, test_state_round_trip)
+{
+	struct app_state state = {.example_int0 = INT32_MIN, .example_int1 = INT32_MAX};
+
+	ROUND_TRIP(app_state, APP_STATE_FIELDS, &state);
+}
+
+ZTEST(codec, test_live_track_status_round_trip)
+{
+	struct app_live_track_status status = {
+		.interval_s = 5,
+		.remaining_s = 595,
+		.fixes = 12,
+		.acked = 11,
+		.failed = 1,
+		.latency_min_ms = 0,
+		.latency_avg_ms = 850,
+		.latency_max_ms = UINT32_MAX,
+	};
+
+	ROUND_TRIP(app_live_track_status, APP_LIVE_TRACK_STATUS_FIELDS, &status);
+}
+
+ZTEST(codec, test_params_round_trip)
+{
+	struct app_live_track_params live = {.duration_s = 600, .interval_s = 5};
+	struct app_fetch_readings_params fetch;
+	struct app_set_log_level_params level = {.level = -1};
+
+	/* Padding is compared too */
+	memset(&fetch, 0, sizeof(fetch));
+	fetch.start_s = INT64_MIN;
+	fetch.end_s = INT64_MAX;
+	fetch.max_points = 100;
+
+	ROUND_TRIP(app_live_track_params, APP_LIVE_TRACK_PARAMS_FIELDS, &live);
+	ROUND_TRIP(app_fetch_readings_params, APP_FETCH_READINGS_PARAMS_FIELDS, &fetch);
+	ROUND_TRIP(app_set_log_level_params, APP_SET_LOG_LEVEL_PARAMS_FIELDS, &level);
+}
+
+/* RPC parameters arrive as a positional list, with integers sent as floats by the console */
+ZTEST(codec, test_params_list_decode)
+{
+	ZCBOR_STATE_E(zse, 1, cbor, sizeof(cbor), 1);
+	struct app_fetch_readings_params fetch = {0};
+	struct app_live_track_params live = {0};
+	size_t len;
+
+	zassert_true(zcbor_list_start_encode(zse, 3) && zcbor_int64_put(zse, -3600) &&
+		     zcbor_float64_put(zse, 1700000000.0) && zcbor_uint32_put(zse, 50) &&
+		     zcbor_list_end_encode(zse, 3));
+	len = zse->payload - cbor;
+
+	ZCBOR_STATE_D(zsd, 2, cbor, len, 1, 0);
+
+	zassert_true(zcbor_list_start_decode(zsd));
+	zassert_equal(app_codec_cbor_list_decode(&app_fetch_readings_params_schema, zsd, &fetch),
+		      BIT_MASK(APP_FETCH_READINGS_PARAMS_FIELD_COUNT));
+	zassert_equal(fetch.start_s, -3600);
+	zassert_equal(fetch.end_s, 1700000000);
+	zassert_equal(fetch.max_points, 50);
+
+	/* Optional interval_s left out */
+	zcbor_new_encode_state(zse, ARRAY_SIZE(zse), cbor, sizeof(cbor), 1);
+	zassert_true(zcbor_list_start_encode(zse, 1) && zcbor_uint32_put(zse, 600) &&
+		     zcbor_list_end_encode(zse, 1));
+	len = zse->payload - cbor;
+
+	zcbor_new_decode_state(zsd, ARRAY_SIZE(zsd), cbor, len, 1, NULL, 0);
+	zassert_true(zcbor_list_start_decode(zsd));
+	zassert_equal(app_codec_cbor_list_decode(&app_live_track_params_schema, zsd, &live),
+		      BIT(APP_LIVE_TRACK_PARAMS_duration_s));
+	zassert_equal(live.duration_s, 600);
+
+	/* Required end_s left out */
+	zcbor_new_encode_state(zse, ARRAY_SIZE(zse), cbor, sizeof(cbor), 1);
+	zassert_true(zcbor_list_start_encode(zse, 1) && zcbor_int64_put(zse, 0) &&
+		     zcbor_list_end_encode(zse, 1));
+	len = zse->payload - cbor;
+
+	zcbor_new_decode_state(zsd, ARRAY_SIZE(zsd), cbor, len, 1, NULL, 0);
+	zassert_true(zcbor_list_start_decode(zsd));
+	zassert_equal(app_codec_cbor_list_decode(&app_fetch_readings_params_schema, zsd, &fetch),
+		      -EINVAL);
+
+	/* Negative value for a UINT field */
+	zcbor_new_encode_state(zse, ARRAY_SIZE(zse), cbor, sizeof(cbor), 1);
+	zassert_true(zcbor_list_start_encode(zse, 1) && zcbor_int32_put(zse, -1) &&
+		     zcbor_list_end_encode(zse, 1));
+	len = zse->payload - cbor;
+
+	zcbor_new_decode_state(zsd, ARRAY_SIZE(zsd), cbor, len, 1, NULL, 0);
+	zassert_true(zcbor_list_start_decode(zsd));
+	zassert_equal(app_codec_cbor_list_decode(&app_live_track_params_schema, zsd, &live),
+		      -EINVAL);
+}
+
+/* The sign of values between -1 and 0 has no whole part to carry it */
+ZTEST(codec, test_micro_negative_sub_unit)
+{
+	struct app_reading reading = {.lat = -500000, .lon = -1, .tem = -999999};
+	uint32_t mask = BIT(APP_READING_lat) | BIT(APP_READING_lon) | BIT(APP_READING_tem);
+	struct app_reading out = {0};
+	int len;
+
+	len = app_codec_json_encode(&app_reading_schema, &reading, mask, json, sizeof(json));
+	zassert_true(len > 0);
+	zassert_equal(strcmp(json, "{\"lat\":-0.500000,\"lon\":-0.000001,\"tem\":-0.999999}"), 0,
+		      "%s", json);
+
+	zassert_equal(app_codec_json_decode(&app_reading_schema, json, len, &out), mask);
+	zassert_equal(out.lat, -500000);
+	zassert_equal(out.lon, -1);
+	zassert_equal(out.tem, -999999);
+
+	/* Short forms as sent by the cloud */
+	static const char short_form[] = "{\"lat\":-0.5,\"lon\":-0,\"tem\":-0.25}";
+
+	zassert_equal(app_codec_json_decode(&app_reading_schema, short_form, strlen(short_form),
+					    &out),
+		      mask);
+	zassert_equal(out.lat, -500000);
+	zassert_equal(out.lon, 0);
+	zassert_equal(out.tem, -250000);
+
+	len = app_codec_cbor_encode(&app_reading_schema, &reading, mask, cbor, sizeof(cbor));
+	zassert_true(len > 0);
+
+	memset(&out, 0, sizeof(out));
+	zassert_equal(app_codec_cbor_decode(&app_reading_schema, cbor, len, &out), mask);
+	zassert_equal(out.lat, -500000);
+	zassert_equal(out.lon, -1);
+	zassert_equal(out.tem, -999999);
+}
+
+ZTEST(codec, test_time_epoch)
+{
+	json_time_check(0, "{\"time\":\"1970-01-01T00:00:00.000Z\"}");
+	json_time_check(-1, "{\"time\":\"1969-12-31T23:59:59.999Z\"}");
+}
+
+ZTEST(codec, test_time_leap_days)
+{
+	json_time_check(LEAP_DAY_2024_MS, "{\"time\":\"2024-02-29T23:59:59.999Z\"}");
+	json_time_check(LEAP_DAY_2024_MS + 1, "{\"time\":\"2024-03-01T00:00:00.000Z\"}");
+	json_time_check(LEAP_DAY_2000_MS, "{\"time\":\"2000-02-29T00:00:00.000Z\"}");
+	json_time_check(MARCH_2100_MS - 1, "{\"time\":\"2100-02-28T23:59:59.999Z\"}");
+	json_time_check(MARCH_2100_MS, "{\"time\":\"2100-03-01T00:00:00.000Z\"}");
+}
+
+ZTEST(codec, test_time_with_and_without_ms)
+{
+	zassert_equal(json_time_decode("{\"time\":\"2024-02-29T12:00:00Z\"}"), 1709208000000LL);
+	zassert_equal(json_time_decode("{\"time\":\"2024-02-29T12:00:00.250Z\"}"),
+		      1709208000250LL);
+	zassert_equal(json_time_decode("{\"time\":\"1970-01-01T00:00:00Z\"}"), 0);
+}
+
+ZTEST(codec, test_time_invalid)
+{
+	static const char *const invalid[] = {
+		"{\"time\":\"2024-13-01T00:00:00Z\"}",
+		"{\"time\":\"2024-02-29T24:00:00Z\"}",
+		"{\"time\":\"2024-02-29T12:00:00.5Z\"}",
+		"{\"time\":\"2024-02-29 12:00:00Z\"}",
+		"{\"time\":\"2024-02-29T12:00:00\"}",
+		"{\"time\":1709208000000}",
+	};
+	struct app_reading reading = {.time = YEAR_10000_MS};
+
+	for (size_t i = 0; i < ARRAY_SIZE(invalid); i++) {
+		zassert_equal(app_codec_json_decode(&app_reading_schema, invalid[i],
+						    strlen(invalid[i]), &reading),
+			      -EBADMSG, "%s", invalid[i]);
+	}
+
+	reading.time = YEAR_10000_MS;
+	zassert_equal(app_codec_json_encode(&app_reading_schema, &reading, BIT(APP_READING_time),
+					    json, sizeof(json)),
+		      -EINVAL);
+	zassert_equal(app_codec_cbor_encode(&app_reading_schema, &reading, BIT(APP_READING_time),
+					    cbor, sizeof(cbor)),
+		      -ENOMEM);
+
+	reading.time = YEAR_10000_MS - 1;
+	json_time_check(reading.time, "{\"time\":\"9999-12-31T23:59:59.999Z\"}");
+}
+
+/* The longest values fill APP_CODEC_JSON_MAX exactly, leaving one byte for the NUL */
+ZTEST(codec, test_json_max_exact)
+{
+	struct app_reading reading = {
+		.lat = INT64_MIN,
+		.lon = INT64_MIN,
+		.time = LEAP_DAY_2024_MS,
+		.tem = INT64_MIN,
+		.pre = INT64_MIN,
+		.hum = INT64_MIN,
+	};
+	struct app_live_track_status status;
+	const size_t reading_max = APP_CODEC_JSON_MAX(APP_READING_FIELDS);
+	const size_t status_max = APP_CODEC_JSON_MAX(APP_LIVE_TRACK_STATUS_FIELDS);
+	int len;
+
+	zassert_equal(app_codec_json_encode(&app_reading_schema, &reading, APP_CODEC_ALL, json,
+					    reading_max + 1),
+		      reading_max, "%s", json);
+	zassert_equal(app_codec_json_encode(&app_reading_schema, &reading, APP_CODEC_ALL, json,
+					    reading_max),
+		      -ENOMEM);
+
+	memset(&status, 0xff, sizeof(status));
+	zassert_equal(app_codec_json_encode(&app_live_track_status_schema, &status,
+					    APP_CODEC_ALL, json, status_max + 1),
+		      status_max, "%s", json);
+	zassert_equal(app_codec_json_encode(&app_live_track_status_schema, &status,
+					    APP_CODEC_ALL, json, status_max),
+		      -ENOMEM);
+
+	len = app_codec_cbor_encode(&app_reading_schema, &reading, APP_CODEC_ALL, cbor,
+				    sizeof(cbor));
+	zassert_true(len > 0 && len <= APP_CODEC_CBOR_MAX(APP_READING_FIELDS), "%d", len);
+	zassert_equal(app_codec_cbor_encode(&app_reading_schema, &reading, APP_CODEC_ALL, cbor,
+					    len - 1),
+		      -ENOMEM);
+}
+
+ZTEST(codec, test_json_unknown_keys_skipped)
+{
+	static const char payload[] = "{\"extra\":{\"a\":[1,{\"b\":\"}\"}],\"s\":\"x]\"},"
+				      "\"lat\":1.5,\"note\":\"a\\\"},b\",\"arr\":[],"
+				      "\"flag\":true,\"hum\":-2}";
+	struct app_reading reading = {0};
+
+	zassert_equal(app_codec_json_decode(&app_reading_schema, payload, strlen(payload),
+					    &reading),
+		      BIT(APP_READING_lat) | BIT(APP_READING_hum));
+	zassert_equal(reading.lat, 1500000);
+	zassert_equal(reading.hum, -2000000);
+}
+
+/*
+ * A backslash as the last byte of the payload escapes nothing. The bytes after len, which
+ * would close the string if read, must not be.
+ */
+ZTEST(codec, test_json_trailing_backslash)
+{
+	static const char value[] = "{\"note\":\"ab\\\\\"}";
+	static const char key[] = "{\"no\\\\\":1}";
+	size_t value_cut = strchr(value, '\\') - value + 1;
+	size_t key_cut = strchr(key, '\\') - key + 1;
+	struct app_reading reading = {0};
+
+	/* Whole, the escaped backslash is skipped with the unknown key */
+	zassert_equal(app_codec_json_decode(&app_reading_schema, value, strlen(value), &reading),
+		      0);
+	zassert_equal(app_codec_json_decode(&app_reading_schema, key, strlen(key), &reading), 0);
+
+	/* Cut after the first backslash */
+	zassert_equal(app_codec_json_decode(&app_reading_schema, value, value_cut, &reading),
+		      -EBADMSG);
+	zassert_equal(app_codec_json_decode(&app_reading_schema, key, key_cut, &reading), -EBADMSG);
+}
+
+ZTEST(codec, test_cbor_unknown_keys_skipped)
+{
+	ZCBOR_STATE_E(zse, 2, cbor, sizeof(cbor), 1);
+	struct app_reading reading = {0};
+	size_t len;
+
+	zassert_true(zcbor_map_start_encode(zse, 4) && zcbor_tstr_put_lit(zse, "extra") &&
+		     zcbor_map_start_encode(zse, 1) && zcbor_tstr_put_lit(zse, "a") &&
+		     zcbor_list_start_encode(zse, 2) && zcbor_uint32_put(zse, 1) &&
+		     zcbor_tstr_put_lit(zse, "b") && zcbor_list_end_encode(zse, 2) &&
+		     zcbor_map_end_encode(zse, 1) && zcbor_tstr_put_lit(zse, "lat") &&
+		     zcbor_float64_put(zse, -0.5) && zcbor_tstr_put_lit(zse, "note") &&
+		     zcbor_tstr_put_lit(zse, "lat") && zcbor_tstr_put_lit(zse, "hum") &&
+		     zcbor_int32_put(zse, 40) && zcbor_map_end_encode(zse, 4));
+	len = zse->payload - cbor;
+
+	zassert_equal(app_codec_cbor_decode(&app_reading_schema, cbor, len, &reading),
+		      BIT(APP_READING_lat) | BIT(APP_READING_hum));
+	zassert_equal(reading.lat, -500000);
+	zassert_equal(reading.hum, 40000000);
+}
+
+ZTEST_SUITE(codec, NULL, NULL, NULL, NULL, NULL);
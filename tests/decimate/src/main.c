@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2026 Golioth, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "app_decimate.h"
+
+#define SERIES_MAX  256
+#define QUEUE_DEPTH 64
+
+static struct app_decimate_point series[SERIES_MAX];
+static ATOMIC_DEFINE(keep, SERIES_MAX);
+
+K_MSGQ_DEFINE(thin_msgq, sizeof(struct app_decimate_point), QUEUE_DEPTH, 8);
+
+static int series_get(size_t i, struct app_decimate_point *pt, void *user_data)
+{
+	*pt = series[i];
+
+	return 0;
+}
+
+static int failing_get(size_t i, struct app_decimate_point *pt, void *user_data)
+{
+	return -EIO;
+}
+
+static int msgq_get(size_t i, struct app_decimate_point *pt, void *user_data)
+{
+	return k_msgq_peek_at(user_data, pt, i);
+}
+
+/* One point a minute, in a sawtooth between 4.00 and 4.60 C */
+static struct app_decimate_point point(size_t i)
+{
+	return (struct app_decimate_point){
+		.t_ms = (int64_t)i * 60 * MSEC_PER_SEC,
+		.value = 400 + (i % 7) * 10,
+	};
+}
+
+static void series_fill(size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		series[i] = point(i);
+	}
+}
+
+static size_t kept_count(size_t start, size_t end)
+{
+	size_t count = 0;
+
+	for (size_t i = start; i < end; i++) {
+		count += atomic_test_bit(keep, i) ? 1 : 0;
+	}
+
+	return count;
+}
+
+static void decimate_before(void *fixture)
+{
+	memset(series, 0, sizeof(series));
+	k_msgq_purge(&thin_msgq);
+}
+
+ZTEST(decimate, test_lttb_keeps_endpoints)
+{
+	series_fill(100);
+
+	int kept = app_decimate(APP_DECIMATE_LTTB, 100, 10, series_get, NULL, keep);
+
+	zassert_true(kept > 0);
+	zassert_true(atomic_test_bit(keep, 0), "first point dropped");
+	zassert_true(atomic_test_bit(keep, 99), "last point dropped");
+}
+
+ZTEST(decimate, test_lttb_one_point_per_bucket)
+{
+	const size_t n = 100;
+	const size_t target = 12;
+	const size_t buckets = target - 2;
+
+	series_fill(n);
+
+	int kept = app_decimate(APP_DECIMATE_LTTB, n, target, series_get, NULL, keep);
+
+	zassert_equal(kept, target);
+	zassert_equal(kept_count(0, n), target);
+
+	/* The same bucket bounds as the implementation: points 1 to n - 2 split evenly */
+	for (size_t b = 0; b < buckets; b++) {
+		size_t start = 1 + (b * (n - 2)) / buckets;
+		size_t end = 1 + ((b + 1) * (n - 2)) / buckets;
+
+		zassert_equal(kept_count(start, end), 1, "bucket %zu kept %zu points", b,
+			      kept_count(start, end));
+	}
+}
+
+ZTEST(decimate, test_lttb_n_not_above_target)
+{
+	series_fill(10);
+
+	zassert_equal(app_decimate(APP_DECIMATE_LTTB, 10, 10, series_get, NULL, keep), 10);
+	zassert_equal(kept_count(0, 10), 10);
+
+	zassert_equal(app_decimate(APP_DECIMATE_LTTB, 10, 50, series_get, NULL, keep), 10);
+	zassert_equal(kept_count(0, 10), 10);
+
+	zassert_equal(app_decimate(APP_DECIMATE_LTTB, 2, 1, series_get, NULL, keep), 2);
+	zassert_equal(app_decimate(APP_DECIMATE_LTTB, 1, 1, series_get, NULL, keep), 1);
+}
+
+ZTEST(decimate, test_lttb_keeps_spike)
+{
+	for (size_t i = 0; i < 100; i++) {
+		series[i] = point(i);
+		series[i].value = 400;
+	}
+	series[53].value = 1000;
+
+	app_decimate(APP_DECIMATE_LTTB, 100, 10, series_get, NULL, keep);
+
+	zassert_true(atomic_test_bit(keep, 53), "spike dropped");
+}
+
+ZTEST(decimate, test_pinned_points_and_neighbours_kept)
+{
+	series_fill(100);
+	series[37].pinned = true;
+	series[99].pinned = true;
+
+	int kept = app_decimate(APP_DECIMATE_LTTB, 100, 10, series_get, NULL, keep);
+
+	zassert_true(atomic_test_bit(keep, 36));
+	zassert_true(atomic_test_bit(keep, 37));
+	zassert_true(atomic_test_bit(keep, 38));
+	zassert_true(atomic_test_bit(keep, 98));
+	zassert_true(atomic_test_bit(keep, 99));
+	zassert_equal(kept, kept_count(0, 100), "return value does not match the bitmap");
+}
+
+ZTEST(decimate, test_every_other)
+{
+	series_fill(11);
+
+	zassert_equal(app_decimate(APP_DECIMATE_EVERY_OTHER, 11, 0, series_get, NULL, keep), 6);
+	for (size_t i = 0; i < 11; i++) {
+		zassert_equal(atomic_test_bit(keep, i), i % 2 == 0, "point %zu", i);
+	}
+
+	/* An even count keeps the last point as well */
+	zassert_equal(app_decimate(APP_DECIMATE_EVERY_OTHER, 10, 0, series_get, NULL, keep), 6);
+	zassert_true(atomic_test_bit(keep, 9));
+}
+
+ZTEST(decimate, test_callback_error)
+{
+	zassert_equal(app_decimate(APP_DECIMATE_LTTB, 100, 10, failing_get, NULL, keep), -EIO);
+}
+
+static void queue_fill(void)
+{
+	for (size_t i = 0; i < QUEUE_DEPTH; i++) {
+		struct app_decimate_point pt = point(i);
+
+		zassert_ok(k_msgq_put(&thin_msgq, &pt, K_NO_WAIT));
+	}
+}
+
+ZTEST(decimate, test_thin_full_queue)
+{
+	struct app_decimate_point pt = point(QUEUE_DEPTH);
+	struct app_decimate_point buf;
+	int64_t prev_ms = -1;
+
+	queue_fill();
+	zassert_equal(k_msgq_put(&thin_msgq, &pt, K_NO_WAIT), -ENOMSG);
+
+	int freed = app_decimate_msgq(&thin_msgq, QUEUE_DEPTH / 2, APP_DECIMATE_LTTB, msgq_get,
+				      keep, &buf);
+
+	zassert_equal(freed, QUEUE_DEPTH / 4);
+	zassert_equal(k_msgq_num_used_get(&thin_msgq), QUEUE_DEPTH - QUEUE_DEPTH / 4);
+	zassert_ok(k_msgq_put(&thin_msgq, &pt, K_NO_WAIT), "no room after thinning");
+
+	/* The oldest and newest survive, in order, and the newer half is untouched */
+	for (size_t i = 0; k_msgq_get(&thin_msgq, &buf, K_NO_WAIT) == 0; i++) {
+		size_t kept_old = QUEUE_DEPTH / 4;
+
+		zassert_true(buf.t_ms > prev_ms, "out of order at %zu", i);
+		if (i == 0) {
+			zassert_equal(buf.t_ms, point(0).t_ms);
+		}
+		if (i >= kept_old) {
+			zassert_equal(buf.t_ms, point(i + kept_old).t_ms, "newer reading %zu lost",
+				      i);
+		}
+		prev_ms = buf.t_ms;
+	}
+}
+
+ZTEST(decimate, test_thin_full_queue_all_pinned)
+{
+	struct app_decimate_point buf;
+
+	for (size_t i = 0; i < QUEUE_DEPTH; i++) {
+		struct app_decimate_point pt = point(i);
+
+		pt.pinned = true;
+		zassert_ok(k_msgq_put(&thin_msgq, &pt, K_NO_WAIT));
+	}
+
+	zassert_equal(app_decimate_msgq(&thin_msgq, QUEUE_DEPTH / 2, APP_DECIMATE_LTTB, msgq_get,
+					keep, &buf),
+		      0);
+	zassert_equal(k_msgq_num_used_get(&thin_msgq), QUEUE_DEPTH);
+}
+
+/* An outage 20 times the queue depth, at one reading a minute */
+#define OUTAGE_LEN (QUEUE_DEPTH * 20)
+
+/* Temperature excursions, pinned like those of the app */
+static const size_t outage_excursions[] = {50, 333, 700, 1001, 1270};
+
+/*
+ * Bounds of the error of the kept readings, linearly interpolated, against
+ * every reading of the outage, in hundredths of a degree. 63 of the 1280
+ * readings are kept, 15 of them for the excursions, to follow a 2.00 C
+ * swing: the error was 1.41 C at most and 0.48 C on average when these
+ * bounds were set. The computation is all integer, so it is the same on
+ * every host.
+ */
+#define OUTAGE_MAX_ERROR  150
+#define OUTAGE_MEAN_ERROR 50
+
+/* A 2.00 C triangle wave with a 5 hour period, and the excursions */
+static struct app_decimate_point outage_point(size_t i)
+{
+	int32_t phase = i % 300;
+	struct app_decimate_point pt = {
+		.t_ms = (int64_t)i * 60 * MSEC_PER_SEC,
+		.value = 400 + ((phase < 150) ? phase : 300 - phase) * 200 / 150,
+	};
+
+	for (size_t e = 0; e < ARRAY_SIZE(outage_excursions); e++) {
+		if (outage_excursions[e] == i) {
+			pt.value = 1200;
+			pt.pinned = true;
+		}
+	}
+
+	return pt;
+}
+
+/* Queue a reading the way the app does: thin the oldest half, or the whole queue, when full */
+static void queue_put_thinning(const struct app_decimate_point *pt)
+{
+	struct app_decimate_point buf;
+
+	if (k_msgq_put(&thin_msgq, pt, K_NO_WAIT) == 0) {
+		return;
+	}
+
+	uint32_t used = k_msgq_num_used_get(&thin_msgq);
+	int freed = app_decimate_msgq(&thin_msgq, used / 2, APP_DECIMATE_LTTB, msgq_get, keep,
+				      &buf);
+
+	if (freed <= 0) {
+		freed = app_decimate_msgq(&thin_msgq, used, APP_DECIMATE_LTTB, msgq_get, keep,
+					  &buf);
+	}
+
+	zassert_true(freed > 0, "full queue not thinned");
+	zassert_ok(k_msgq_put(&thin_msgq, pt, K_NO_WAIT));
+}
+
+ZTEST(decimate, test_thin_long_outage)
+{
+	static struct app_decimate_point kept[QUEUE_DEPTH];
+	size_t kept_n = 0;
+	int64_t error_sum = 0;
+	int32_t error_max = 0;
+
+	for (size_t i = 0; i < OUTAGE_LEN; i++) {
+		struct app_decimate_point pt = outage_point(i);
+
+		queue_put_thinning(&pt);
+	}
+
+	while (kept_n < QUEUE_DEPTH && k_msgq_get(&thin_msgq, &kept[kept_n], K_NO_WAIT) == 0) {
+		kept_n++;
+	}
+
+	/* The whole outage is covered */
+	zassert_true(kept_n >= 2);
+	zassert_equal(kept[0].t_ms, outage_point(0).t_ms, "first reading lost");
+	zassert_equal(kept[kept_n - 1].t_ms, outage_point(OUTAGE_LEN - 1).t_ms,
+		      "last reading lost");
+
+	/* Every excursion survives */
+	for (size_t e = 0; e < ARRAY_SIZE(outage_excursions); e++) {
+		struct app_decimate_point pt = outage_point(outage_excursions[e]);
+		bool found = false;
+
+		for (size_t k = 0; k < kept_n; k++) {
+			found |= kept[k].t_ms == pt.t_ms && kept[k].value == pt.value;
+		}
+		zassert_true(found, "excursion at %zu lost", outage_excursions[e]);
+	}
+
+	/* Fidelity: interpolate between the kept readings at every original one */
+	for (size_t i = 0, k = 0; i < OUTAGE_LEN; i++) {
+		struct app_decimate_point pt = outage_point(i);
+
+		while (k + 2 < kept_n && kept[k + 1].t_ms <= pt.t_ms) {
+			k++;
+		}
+
+		const struct app_decimate_point *a = &kept[k];
+		const struct app_decimate_point *b = &kept[k + 1];
+		int32_t estimate =
+			a->value + (int32_t)(((int64_t)(b->value - a->value) * (pt.t_ms - a->t_ms)) /
+					     (b->t_ms - a->t_ms));
+		int32_t error = abs(estimate - pt.value);
+
+		error_max = MAX(error_max, error);
+		error_sum += error;
+	}
+
+	int32_t error_mean = error_sum / OUTAGE_LEN;
+
+	TC_PRINT("kept %zu of %d, max error %d, mean error %d\n", kept_n, OUTAGE_LEN, error_max,
+		 error_mean);
+
+	zassert_true(error_max <= OUTAGE_MAX_ERROR, "max error %d", error_max);
+	zassert_true(error_mean <= OUTAGE_MEAN_ERROR, "mean error %d", error_mean);
+}
+
+ZTEST_SUITE(decimate, NULL, NULL, decimate_before, NULL, NULL);
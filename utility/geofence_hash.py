@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Compute the hash of a geofence set for the LightDB State `geofence` path.
+
+The device only downloads `geofence/set` when `geofence/hash` changes, and
+rejects a set which does not match the hash. The hash is the CRC-32 (IEEE) of
+every value of every fence, in order, as little-endian 32-bit integers, the
+same as src/app_geofence.c computes while decoding the set.
+
+Takes a JSON file holding either the `set` array or the whole `geofence`
+object, and prints the `geofence` object with its hash filled in, ready to be
+written to LightDB State.
+
+Example:
+
+    ./geofence_hash.py fences.json
+"""
+
+import argparse
+import json
+import struct
+import sys
+import zlib
+
+
+def fence_set_hash(fences):
+    crc = 0
+    for fence in fences:
+        for value in fence:
+            # Floats are truncated as the device does
+            crc = zlib.crc32(struct.pack("<i", int(value)), crc)
+    return crc
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("file", help="JSON geofence set, '-' for stdin")
+    args = parser.parse_args()
+
+    with (sys.stdin if args.file == "-" else open(args.file)) as f:
+        doc = json.load(f)
+
+    fences = doc.get("geofence", doc)["set"] if isinstance(doc, dict) else doc
+
+    print(json.dumps({"geofence": {"hash": fence_set_hash(fences), "set": fences}}, indent=2))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Decode dictionary logs streamed to the "logs_dict" path.
+
+Takes the stream entries exported from Golioth as JSON (a list, or one object
+per line), where the "d" byte string of each batch is base64 encoded. Batches
+are decoded in sequence order with Zephyr's dictionary log parser and the
+log_dictionary.json database generated in the build directory of the same
+firmware. Suppressed repeats and missing batches are reported between them.
+
+Example:
+
+    ./log_dict_decode.py ../../build/app/zephyr/log_dictionary.json logs_dict.json
+"""
+
+import argparse
+import base64
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+
+def load_batches(path):
+    with open(path) as f:
+        text = f.read().strip()
+
+    entries = json.loads(text) if text.startswith("[") else \
+        [json.loads(line) for line in text.splitlines() if line.strip()]
+
+    batches = []
+    for entry in entries:
+        # Golioth exports wrap the streamed object in "data"
+        batch = entry.get("data", entry)
+        if "d" in batch:
+            batches.append(batch)
+
+    return sorted(batches, key=lambda b: b.get("seq", 0))
+
+
+def decode(parser, database, records):
+    with tempfile.NamedTemporaryFile(suffix=".bin", delete=False) as f:
+        f.write(records)
+        path = f.name
+
+    try:
+        subprocess.run([sys.executable, parser, database, path], check=False)
+    finally:
+        os.unlink(path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("database", help="log_dictionary.json from the firmware build")
+    parser.add_argument("logs", help="exported logs_dict stream entries (JSON)")
+    parser.add_argument("--zephyr-base", default=os.environ.get("ZEPHYR_BASE"),
+                        help="Zephyr tree holding the dictionary log parser")
+    args = parser.parse_args()
+
+    if not args.zephyr_base:
+        sys.exit("Set ZEPHYR_BASE or pass --zephyr-base")
+
+    log_parser = os.path.join(args.zephyr_base, "scripts", "logging", "dictionary",
+                              "log_parser.py")
+    last_seq = None
+
+    for batch in load_batches(args.logs):
+        seq = batch.get("seq", 0)
+
+        if last_seq is not None and seq > last_seq + 1:
+            print(f"--- {seq - last_seq - 1} batches missing", flush=True)
+        elif last_seq is not None and seq <= last_seq:
+            print(f"--- sequence restarted at {seq} (reboot)", flush=True)
+        last_seq = seq
+
+        decode(log_parser, args.database, base64.b64decode(batch["d"]))
+
+        for source, count in batch.get("rep", {}).items():
+            print(f"--- source {source}: previous message repeated {count} times",
+                  flush=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,342 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Generate and apply delta patches between two firmware images.
+
+A patch rebuilds the new signed image (zephyr.signed.bin) from the image running
+on the device, which is read back from the primary slot. It is applied as it
+is downloaded by src/app_ota_delta.c, so the format is a flat stream of
+operations with no lookback into the patch:
+
+    header   "CCDP", version, 3 reserved bytes, then little-endian u32
+             old_size, old_crc, new_size, new_crc, old_start and 4 reserved
+             bytes. Only old[old_start:old_size] is read and covered by
+             old_crc.
+    ADD      0x01 len offset pairs...
+             Copy len bytes of the old image from the old cursor moved by the
+             signed offset, adding the diff bytes to them. Each pair holds a
+             number of unchanged bytes and a count of diff bytes in the high
+             and low nibble of one byte (15: the value minus 15 follows), then
+             the diff bytes, until len bytes are covered.
+    INSERT   0x02 len bytes...
+    END      0x00
+
+Numbers are unsigned LEB128; offsets are zigzag encoded. CRCs are CRC-32
+(IEEE). Firmware changes mostly move code and change the addresses it refers
+to, so most of the new image is old code with a few changed bytes, which ADD
+encodes with the unchanged runs skipped.
+
+Examples:
+
+    ./ota_delta.py diff v1.4.0/zephyr.signed.bin v1.4.1/zephyr.signed.bin -o v1.4.1.delta
+    ./ota_delta.py apply v1.4.0/zephyr.signed.bin v1.4.1.delta -o check.bin
+"""
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+MAGIC = b"CCDP"
+VERSION = 1
+HEADER = struct.Struct("<4sB3xIIIII4x")
+
+OP_END = 0x00
+OP_ADD = 0x01
+OP_INSERT = 0x02
+
+# Seed length for finding matches, and the shortest match worth an ADD
+SEED = 8
+MIN_MATCH = 12
+MAX_CANDIDATES = 16
+
+# An ADD keeps extending through changed bytes until this many of the last
+# WINDOW bytes differ
+WINDOW = 16
+MAX_MISMATCH = 8
+
+# Unchanged gaps shorter than this are sent as zero diff bytes
+MIN_SKIP = 3
+
+
+def varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return out
+
+
+def zigzag(value):
+    return (value << 1) if value >= 0 else ((-value << 1) - 1)
+
+
+def unzigzag(value):
+    return (value >> 1) if not value & 1 else -((value + 1) >> 1)
+
+
+def pair(skip, count):
+    out = bytearray([(min(skip, 15) << 4) | min(count, 15)])
+    if skip >= 15:
+        out += varint(skip - 15)
+    if count >= 15:
+        out += varint(count - 15)
+    return out
+
+
+def build_index(old, start):
+    index = {}
+    for i in range(start, len(old) - SEED + 1):
+        positions = index.setdefault(old[i:i + SEED], [])
+        if len(positions) < MAX_CANDIDATES:
+            positions.append(i)
+    return index
+
+
+def match_length(old, o, new, n):
+    """Length of the exact match of old[o:] and new[n:]."""
+    length = 0
+    limit = min(len(old) - o, len(new) - n)
+
+    # Compare in blocks first; most matches are long
+    while length + 64 <= limit and old[o + length:o + length + 64] == new[n + length:n + length + 64]:
+        length += 64
+    while length < limit and old[o + length] == new[n + length]:
+        length += 1
+
+    return length
+
+
+def extend(old, o, new, n, length):
+    """Extend a match through changed bytes while most bytes still match."""
+    end = length
+    recent = []
+    k = length
+    limit = min(len(old) - o, len(new) - n)
+
+    while k < limit:
+        same = old[o + k] == new[n + k]
+        recent.append(same)
+        if len(recent) > WINDOW:
+            recent.pop(0)
+        if same:
+            end = k + 1
+        elif recent.count(False) > MAX_MISMATCH:
+            break
+        k += 1
+
+    return end
+
+
+def encode_add(old, o, new, n, length):
+    out = bytearray()
+    k = 0
+
+    while k < length:
+        skip = 0
+        while k + skip < length and old[o + k + skip] == new[n + k + skip]:
+            skip += 1
+
+        start = k + skip
+        end = start
+        while end < length:
+            if old[o + end] != new[n + end]:
+                end += 1
+                continue
+            # Keep short unchanged gaps inside the diff run
+            gap = 0
+            while end + gap < length and gap < MIN_SKIP and old[o + end + gap] == new[n + end + gap]:
+                gap += 1
+            if gap >= MIN_SKIP or end + gap == length:
+                break
+            end += gap
+
+        out += pair(skip, end - start)
+        out += bytes((new[n + i] - old[o + i]) & 0xFF for i in range(start, end))
+        k = end
+
+    return out
+
+
+def diff(old, new, old_start=0):
+    index = build_index(old, old_start)
+    ops = bytearray()
+    old_cursor = old_start
+    literal = 0
+    n = 0
+
+    def flush_literal(end):
+        if end > literal:
+            ops.extend(bytes([OP_INSERT]) + varint(end - literal) + new[literal:end])
+
+    while n <= len(new) - SEED:
+        # The old cursor continues the previous match; try it before the index
+        candidates = [old_cursor] if old_cursor < len(old) else []
+        candidates += index.get(new[n:n + SEED], [])
+
+        best_o, best_len = 0, 0
+        for o in candidates:
+            length = match_length(old, o, new, n)
+            if length > best_len:
+                best_o, best_len = o, length
+
+        if best_len < MIN_MATCH:
+            n += 1
+            continue
+
+        length = extend(old, best_o, new, n, best_len)
+
+        flush_literal(n)
+        ops.extend(bytes([OP_ADD]) + varint(length) + varint(zigzag(best_o - old_cursor)))
+        ops.extend(encode_add(old, best_o, new, n, length))
+
+        old_cursor = best_o + length
+        n += length
+        literal = n
+
+    flush_literal(len(new))
+    ops.append(OP_END)
+
+    header = HEADER.pack(MAGIC, VERSION, len(old), zlib.crc32(old[old_start:]), len(new),
+                         zlib.crc32(new), old_start)
+    return header + ops
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise ValueError("patch is truncated")
+        self.pos += 1
+        return self.data[self.pos - 1]
+
+    def varint(self):
+        value, shift = 0, 0
+        while True:
+            byte = self.byte()
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    def pair(self):
+        byte = self.byte()
+        skip, count = byte >> 4, byte & 0x0F
+        if skip == 15:
+            skip += self.varint()
+        if count == 15:
+            count += self.varint()
+        return skip, count
+
+    def bytes(self, count):
+        if self.pos + count > len(self.data):
+            raise ValueError("patch is truncated")
+        self.pos += count
+        return self.data[self.pos - count:self.pos]
+
+
+def apply(old, patch):
+    magic, version, old_size, old_crc, new_size, new_crc, old_start = HEADER.unpack_from(patch)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not a delta patch")
+    if old_size != len(old) or old_crc != zlib.crc32(old[old_start:]):
+        raise ValueError("patch was generated against a different image")
+
+    reader = Reader(patch)
+    reader.pos = HEADER.size
+    new = bytearray()
+    old_cursor = old_start
+
+    while (op := reader.byte()) != OP_END:
+        length = reader.varint()
+        if op == OP_INSERT:
+            new += reader.bytes(length)
+            continue
+        if op != OP_ADD:
+            raise ValueError(f"unknown operation {op:#x}")
+
+        old_cursor += unzigzag(reader.varint())
+        end = old_cursor + length
+        if old_cursor < old_start or end > len(old):
+            raise ValueError("ADD outside the old image")
+        while old_cursor < end:
+            skip, count = reader.pair()
+            if old_cursor + skip + count > end:
+                raise ValueError("pair outside the ADD")
+            new += old[old_cursor:old_cursor + skip]
+            old_cursor += skip
+            for d in reader.bytes(count):
+                new.append((old[old_cursor] + d) & 0xFF)
+                old_cursor += 1
+
+    if len(new) != new_size or zlib.crc32(new) != new_crc:
+        raise ValueError("patched image does not match the new image")
+
+    return bytes(new)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("diff", help="generate a patch from OLD to NEW")
+    p.add_argument("old")
+    p.add_argument("new")
+    p.add_argument("-o", "--output", required=True)
+    p.add_argument("--old-start", type=lambda x: int(x, 0), default=0,
+                   help="offset from which the device can read the running image; "
+                        "0x8000 for nRF9160 builds with TF-M")
+
+    p = sub.add_parser("apply", help="rebuild the new image from OLD and PATCH")
+    p.add_argument("old")
+    p.add_argument("patch")
+    p.add_argument("-o", "--output", required=True)
+
+    args = parser.parse_args()
+
+    with open(args.old, "rb") as f:
+        old = f.read()
+
+    if args.command == "diff":
+        with open(args.new, "rb") as f:
+            new = f.read()
+
+        start = time.monotonic()
+        patch = diff(old, new, args.old_start)
+        elapsed = time.monotonic() - start
+
+        # Never publish a patch which does not rebuild the image
+        apply(old, patch)
+
+        with open(args.output, "wb") as f:
+            f.write(patch)
+
+        print(f"{len(old)} -> {len(new)} bytes: patch {len(patch)} bytes "
+              f"({100 * len(patch) / len(new):.1f}% of the image), {elapsed:.1f} s")
+    else:
+        with open(args.patch, "rb") as f:
+            patch = f.read()
+
+        try:
+            new = apply(old, patch)
+        except ValueError as e:
+            sys.exit(f"Cannot apply patch: {e}")
+
+        with open(args.output, "wb") as f:
+            f.write(new)
+
+        print(f"Rebuilt {len(new)} bytes")
+
+
+if __name__ == "__main__":
+    main()
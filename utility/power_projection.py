@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Project battery life for each power profile of the cold chain tracker.
+
+The average current of each profile is built from per-activity energy costs
+(measure these on hardware and pass them with --costs) and the profile table,
+which is read from src/app_power.c so the projection always matches the
+firmware. The policy simulation discharges a battery from 100% and switches
+profiles at the same thresholds as the firmware.
+
+Example:
+
+    ./power_projection.py --gps-delay 3 --loop-delay 60 --capacity 2000
+    ./power_projection.py --costs measured.json --json
+"""
+
+import argparse
+import json
+import pathlib
+import re
+import sys
+
+REPO = pathlib.Path(__file__).resolve().parent.parent
+
+# Symbols used in the profile table, and the Kconfig option giving their value
+SYMBOLS = {"NORMAL_DISPLAY_REFRESH_MS": "APP_DISPLAY_MIN_REFRESH_MS"}
+
+
+def kconfig_default(option):
+    text = (REPO / "Kconfig").read_text(encoding="utf-8")
+    m = re.search(rf"^config {option}\n(?:\t.*\n)*?\tdefault (\d+)", text, re.M)
+    if not m:
+        sys.exit(f"No default for {option} in Kconfig")
+    return int(m.group(1))
+
+
+def load_profiles():
+    """The `profiles` table of src/app_power.c, keyed by profile name."""
+    text = (REPO / "src" / "app_power.c").read_text(encoding="utf-8")
+    table = re.search(r"struct power_profile profiles\[[^]]*\] = \{(.*?)\n\};", text, re.S)
+    if not table:
+        sys.exit("Profile table not found in src/app_power.c")
+
+    profiles = {}
+    for body in re.findall(r"\[APP_POWER_PROFILE_\w+\] = \{(.*?)\}", table.group(1), re.S):
+        fields = dict(re.findall(r"\.(\w+) = ([^,]+),", body))
+        name = fields.pop("name").strip('"')
+        profiles[name] = {k: int(v) if v.isdigit() else kconfig_default(SYMBOLS[v])
+                          for k, v in fields.items()}
+
+    return profiles
+
+# Currents in uA, per-event charge in uA*s. Placeholder values; replace them
+# with measurements from a power analyzer.
+DEFAULT_COSTS = {
+    "sleep_ua": 40,
+    "gnss_ua": 22000,
+    "sensor_read_uas": 1500,
+    "reading_uas": 300,
+    "upload_wake_uas": 450000,
+    "upload_per_reading_uas": 1200,
+    "display_refresh_uas": 25000,
+}
+
+
+def average_current_ua(profile, costs, gps_delay_s, loop_delay_s, recorder_period_ms):
+    """Average current (uA) of a profile at the given cloud settings."""
+    reading_interval = max(gps_delay_s * profile["gps_delay_pct"] / 100, 1)
+    loop_interval = max(loop_delay_s * profile["loop_delay_pct"] / 100, 1)
+    # Uploads happen on a loop wake only once enough readings are queued, or the oldest has
+    # waited flush_max_age_s
+    batch_interval = profile["flush_min_queued"] * reading_interval
+    if profile["flush_max_age_s"]:
+        batch_interval = min(batch_interval, profile["flush_max_age_s"])
+    upload_interval = max(loop_interval, batch_interval)
+    # The display only refreshes when a new reading changes the slides
+    display_interval = max(profile["display_refresh_ms"] / 1000, reading_interval)
+
+    # Readings reuse the flight recorder samples, so the faster of the two sets the sensor reads
+    sensor_reads_per_s = 1 / profile["sensor_period_s"]
+    recorder_period_s = recorder_period_ms * profile["recorder_period_pct"] / 100 / 1000
+    if recorder_period_s:
+        sensor_reads_per_s = max(sensor_reads_per_s, 1 / recorder_period_s)
+
+    readings_per_s = 1 / reading_interval
+    current = costs["sleep_ua"] + costs["gnss_ua"]
+    current += costs["sensor_read_uas"] * sensor_reads_per_s
+    current += readings_per_s * (costs["reading_uas"] + costs["upload_per_reading_uas"])
+    current += costs["upload_wake_uas"] / upload_interval
+    current += costs["display_refresh_uas"] / display_interval
+
+    return current
+
+
+def simulate_policy(currents, capacity_mah, saver_pct, critical_pct):
+    """Hours to drain a full battery while switching profiles at the thresholds."""
+    hours = 0.0
+    spans = [("normal", 100, saver_pct), ("saver", saver_pct, critical_pct),
+             ("critical", critical_pct, 0)]
+
+    for name, high, low in spans:
+        charge_mah = capacity_mah * max(high - low, 0) / 100
+        hours += charge_mah * 1000 / currents[name]
+
+    return hours
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--costs", help="JSON file with measured per-activity costs")
+    parser.add_argument("--gps-delay", type=float, default=3, help="GPS_DELAY_S setting")
+    parser.add_argument("--loop-delay", type=float, default=5, help="LOOP_DELAY_S setting")
+    parser.add_argument("--capacity", type=float, default=2000, help="battery capacity (mAh)")
+    parser.add_argument("--saver-level", type=float, default=30,
+                        help="CONFIG_APP_POWER_SAVER_LEVEL_PCT")
+    parser.add_argument("--critical-level", type=float, default=10,
+                        help="CONFIG_APP_POWER_CRITICAL_LEVEL_PCT")
+    parser.add_argument("--recorder-period", type=float,
+                        default=kconfig_default("APP_RECORDER_PERIOD_MS"),
+                        help="CONFIG_APP_RECORDER_PERIOD_MS, 0 without the flight recorder")
+    parser.add_argument("--json", action="store_true", help="machine-readable output")
+    args = parser.parse_args()
+
+    costs = dict(DEFAULT_COSTS)
+    if args.costs:
+        with open(args.costs, encoding="utf-8") as f:
+            costs.update(json.load(f))
+
+    currents = {name: average_current_ua(p, costs, args.gps_delay, args.loop_delay,
+                                         args.recorder_period)
+                for name, p in load_profiles().items()}
+    results = {
+        "profiles": {name: {"avg_current_ua": round(ua, 1),
+                            "battery_life_h": round(args.capacity * 1000 / ua, 1)}
+                     for name, ua in currents.items()},
+        "policy_battery_life_h": round(simulate_policy(currents, args.capacity,
+                                                       args.saver_level,
+                                                       args.critical_level), 1),
+    }
+
+    if args.json:
+        json.dump(results, sys.stdout, indent=2)
+        print()
+        return
+
+    print(f"{'profile':<10} {'avg current (uA)':>18} {'battery life (h)':>18}")
+    for name, r in results["profiles"].items():
+        print(f"{name:<10} {r['avg_current_ua']:>18} {r['battery_life_h']:>18}")
+    print(f"\nWith the power policy: {results['policy_battery_life_h']} h")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Break down the RAM of a Zephyr build per subsystem.
+
+Reads the GNU ld map file (build/zephyr/zephyr.map) and adds up the input
+sections placed in RAM (.data, .bss, .noinit and the kernel object sections)
+by the file which defines them. Application files are reported one by one;
+libraries and Zephyr subsystems are grouped (kernel, net, mbedtls, golioth,
+modem, ...). Thread stacks count for the file which defines them.
+
+The build runs this after each link when CONFIG_APP_RAM_BUDGET is enabled.
+Use it to see what a change of queue depth or stack size costs on a board,
+and how much RAM is left:
+
+    ./ram_budget.py ../build/zephyr/zephyr.map
+    ./ram_budget.py --json ../build/zephyr/zephyr.map
+"""
+
+import argparse
+import json
+import re
+import sys
+
+# (pattern matched against the object path, subsystem), first match wins
+GROUPS = [
+    (re.compile(r"libapp\.a\((\w+)\.c\.obj\)"), None),  # per file
+    (re.compile(r"golioth"), "golioth"),
+    (re.compile(r"mbedtls|oberon|cc3xx|psa"), "mbedtls"),
+    (re.compile(r"nrf_modem|modem|lte_link"), "modem"),
+    (re.compile(r"libkernel\.a"), "kernel"),
+    (re.compile(r"subsys__net|net__|/net/|zsock|socket"), "net"),
+    (re.compile(r"subsys__logging|logging"), "logging"),
+    (re.compile(r"subsys__shell|shell"), "shell"),
+    (re.compile(r"subsys__settings|subsys__fs|nvs|settings"), "settings"),
+    (re.compile(r"drivers__"), "drivers"),
+    (re.compile(r"arch__|/arch/|libarch"), "arch"),
+    (re.compile(r"libc|picolibc|newlib|libm\.a|libgcc"), "libc"),
+    (re.compile(r"libzephyr\.a"), "zephyr"),
+]
+
+RE_REGION = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S+))?\s*$")
+RE_INPUT = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.*\S)")
+RE_NAME_ONLY = re.compile(r"^ ?(\S+)\s*$")
+RE_CONT = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.*\S)")
+
+
+def subsystem(path):
+    for pattern, name in GROUPS:
+        match = pattern.search(path)
+        if match:
+            return name or match[1]
+
+    archive = re.search(r"lib(\w+)\.a", path)
+    return archive[1] if archive else "other"
+
+
+def kind(section):
+    for k in ("noinit", "bss", "data"):
+        if k in section:
+            return k
+    return "data"
+
+
+def parse(lines):
+    """Return ([(name, start, end) of RAM regions], [(section, addr, size, path)])."""
+    regions = []
+    inputs = []
+    state = None
+    pending = None
+
+    for line in lines:
+        line = line.rstrip("\n")
+
+        if line.startswith("Memory Configuration"):
+            state = "memory"
+            continue
+        if line.startswith("Linker script and memory map"):
+            state = "map"
+            continue
+
+        if state == "memory":
+            match = RE_REGION.match(line)
+            if match and match[1] != "Name":
+                name, origin, length = match[1], int(match[2], 16), int(match[3], 16)
+                attrs = match[4] or ""
+                # IDT_LIST only holds interrupt tables at build time
+                if "w" in attrs and name not in ("*default*", "IDT_LIST") and length:
+                    regions.append((name, origin, origin + length))
+            continue
+
+        if state != "map":
+            continue
+
+        if pending:
+            match = RE_CONT.match(line)
+            if match:
+                inputs.append((pending, int(match[1], 16), int(match[2], 16), match[3]))
+            pending = None
+            continue
+
+        match = RE_INPUT.match(line)
+        if match:
+            inputs.append((match[1], int(match[2], 16), int(match[3], 16), match[4]))
+            continue
+
+        match = RE_NAME_ONLY.match(line)
+        if match and line.startswith(" ") and not match[1].startswith("*"):
+            # Long section names put the address on the next line
+            pending = match[1]
+
+    return regions, inputs
+
+
+def budget(regions, inputs):
+    def in_ram(addr):
+        if not regions:
+            # No memory regions (e.g. native_sim): count by section name
+            return True
+        return any(start <= addr < end for _, start, end in regions)
+
+    totals = {}
+    for section, addr, size, path in inputs:
+        if size == 0 or addr == 0 or not in_ram(addr):
+            continue
+        if not regions and not re.search(r"\.(bss|data|noinit)|COMMON|_area|k_", section):
+            continue
+        name = subsystem(path)
+        entry = totals.setdefault(name, {"data": 0, "bss": 0, "noinit": 0})
+        entry[kind(section.lower()) if section != "COMMON" else "bss"] += size
+
+    return totals
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("map", help="zephyr.map from the build directory")
+    parser.add_argument("--json", action="store_true", help="print the report as JSON")
+    parser.add_argument("--top", type=int, default=0,
+                        help="only list the largest subsystems (0: all)")
+    args = parser.parse_args()
+
+    try:
+        with open(args.map) as f:
+            regions, inputs = parse(f)
+    except OSError as e:
+        sys.exit(f"Cannot read map file: {e}")
+
+    totals = budget(regions, inputs)
+    rows = sorted(totals.items(), key=lambda kv: -sum(kv[1].values()))
+    used = sum(sum(v.values()) for v in totals.values())
+    size = sum(end - start for _, start, end in regions)
+
+    if args.json:
+        print(json.dumps({"subsystems": totals, "used": used, "ram": size}))
+        return
+
+    if args.top:
+        rows = rows[:args.top]
+
+    print(f"{'subsystem':<20} {'data':>8} {'bss':>8} {'noinit':>8} {'total':>8}")
+    for name, entry in rows:
+        total = sum(entry.values())
+        print(f"{name:<20} {entry['data']:>8} {entry['bss']:>8} {entry['noinit']:>8} "
+              f"{total:>8}")
+
+    if size:
+        print(f"RAM used {used} of {size} bytes ({100 * used / size:.1f}%), "
+              f"{size - used} free")
+    else:
+        print(f"RAM used {used} bytes")
+
+
+if __name__ == "__main__":
+    main()
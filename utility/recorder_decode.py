@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Decode flight recorder bursts streamed to the "recorder" path.
+
+Takes the stream entries exported from Golioth as JSON (a list, or one object
+per line), where the "d" byte string of each burst is base64 encoded. Each
+burst holds its first sample, then the difference of each sample from the
+previous one (temperature, humidity, pressure) as zigzag LEB128 varints.
+Prints every sample as CSV, with its offset from the trigger in seconds and,
+when the device knew the network time, its Unix time.
+
+Example:
+
+    ./recorder_decode.py recorder.json > bursts.csv
+"""
+
+import argparse
+import base64
+import csv
+import json
+import sys
+
+# APP_BACKLOG_NO_VALUE, for values which were not available
+NO_VALUE = -32768
+
+
+def load_bursts(path):
+    with open(path) as f:
+        text = f.read().strip()
+
+    entries = json.loads(text) if text.startswith("[") else \
+        [json.loads(line) for line in text.splitlines() if line.strip()]
+
+    bursts = []
+    for entry in entries:
+        # Golioth exports wrap the streamed object in "data"
+        burst = entry.get("data", entry)
+        if "d" in burst and "first" in burst:
+            bursts.append(burst)
+
+    return sorted(bursts, key=lambda b: (b.get("time", 0), b.get("uptime_ms", 0)))
+
+
+def varints(data):
+    value = shift = 0
+    for byte in data:
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if not byte & 0x80:
+            yield (value >> 1) ^ -(value & 1)
+            value = shift = 0
+
+
+def samples(burst):
+    sample = list(burst["first"])
+    yield tuple(sample)
+
+    deltas = list(varints(base64.b64decode(burst["d"])))
+    for i in range(0, len(deltas) - 2, 3):
+        sample = [v + d for v, d in zip(sample, deltas[i:i + 3])]
+        yield tuple(sample)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("bursts", help="exported recorder stream entries (JSON)")
+    args = parser.parse_args()
+
+    out = csv.writer(sys.stdout)
+    out.writerow(["burst", "reason", "offset_s", "unix_ms", "tem_c", "hum_pct", "pre_kpa"])
+
+    for index, burst in enumerate(load_bursts(args.bursts)):
+        period_ms = burst["period_ms"]
+        pre = burst["pre"]
+        decoded = list(samples(burst))
+
+        if len(decoded) != burst["n"]:
+            print(f"Burst {index}: {len(decoded)} samples decoded, {burst['n']} expected",
+                  file=sys.stderr)
+
+        for i, (tem, hum, pre_pa) in enumerate(decoded):
+            offset_ms = (i - pre) * period_ms
+            unix_ms = burst["time"] + offset_ms if "time" in burst else ""
+            out.writerow([
+                index, burst["reason"], offset_ms / 1000, unix_ms,
+                "" if tem == NO_VALUE else tem / 100,
+                "" if hum == NO_VALUE else hum / 100,
+                "" if pre_pa == NO_VALUE else pre_pa / 1000,
+            ])
+
+
+if __name__ == "__main__":
+    main()
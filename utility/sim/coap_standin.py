@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Local CoAP/DTLS stand-in for the Golioth cloud.
+
+Accepts LightDB Stream POSTs (``.s/<path>``) from the native_sim build over
+DTLS with a pre-shared key and counts what arrives. Readings in JSON array
+payloads (the ``gps`` stream) are counted by their ``time`` key, so batches
+sent twice show up as duplicates. Every other service answers 4.04 Not Found,
+which the Golioth SDK logs and otherwise ignores. Requests, payload sizes and
+new DTLS sessions (one per connect, since the SDK opens a new socket each
+time) are also counted per second of the run.
+
+Example:
+
+    ./coap_standin.py --port 5684 --psk-id sim@cold-chain --psk secret
+
+Statistics are printed as JSON on exit (Ctrl-C).
+"""
+
+import argparse
+import asyncio
+import json
+import time
+
+import aiocoap
+import aiocoap.credentials
+import aiocoap.resource
+
+DEFAULT_PSK_ID = "sim@cold-chain"
+DEFAULT_PSK = "cold-chain-sim-psk"
+
+# Timestamps of readings queued by the `bench backlog` shell command
+BACKLOG_TIME_PREFIX = "2000-"
+
+CONTENT_FORMAT_JSON = 50
+
+
+class StreamStats:
+    """What has been received on each stream path."""
+
+    def __init__(self):
+        self.paths = {}
+        self.seen_times = set()
+        self.backlog_times = set()
+        self.first_reading = None
+        self.last_reading = None
+        self.start = time.monotonic()
+        self.sessions = set()
+        self.payload_sizes = []
+        # Confirmable messages received again after the ACK was lost; None if
+        # the aiocoap message layer could not be hooked to count them
+        self.duplicate_messages = None
+        # Per second of the run: requests, stream posts, stream bytes, new sessions
+        self.timeline = {}
+
+    def second(self):
+        second = int(time.monotonic() - self.start)
+        return self.timeline.setdefault(second, {"requests": 0, "posts": 0, "bytes": 0,
+                                                 "sessions": 0})
+
+    def request(self, remote):
+        slot = self.second()
+        slot["requests"] += 1
+
+        if remote not in self.sessions:
+            self.sessions.add(remote)
+            slot["sessions"] += 1
+
+    def add(self, path, payload, content_format):
+        entry = self.paths.setdefault(path, {"posts": 0, "bytes": 0, "readings": 0,
+                                             "duplicates": 0})
+        entry["posts"] += 1
+        entry["bytes"] += len(payload)
+        self.payload_sizes.append(len(payload))
+
+        slot = self.second()
+        slot["posts"] += 1
+        slot["bytes"] += len(payload)
+
+        if content_format is None or int(content_format) != CONTENT_FORMAT_JSON:
+            return
+
+        try:
+            readings = json.loads(payload)
+        except ValueError:
+            return
+
+        if not isinstance(readings, list):
+            readings = [readings]
+
+        now = time.monotonic()
+
+        for reading in readings:
+            stamp = reading.get("time") if isinstance(reading, dict) else None
+            entry["readings"] += 1
+
+            if stamp in self.seen_times:
+                entry["duplicates"] += 1
+                continue
+
+            self.seen_times.add(stamp)
+            if stamp and stamp.startswith(BACKLOG_TIME_PREFIX):
+                self.backlog_times.add(stamp)
+            self.first_reading = self.first_reading or now
+            self.last_reading = now
+
+    def as_dict(self):
+        return {"paths": self.paths, "unique_readings": len(self.seen_times),
+                "backlog_readings": len(self.backlog_times), "sessions": len(self.sessions),
+                "duplicate_messages": self.duplicate_messages}
+
+
+class GoliothStandIn(aiocoap.resource.Resource):
+    """Catch-all resource: accept stream data, refuse everything else."""
+
+    def __init__(self, stats):
+        super().__init__()
+        self.stats = stats
+
+    async def render(self, request):
+        path = request.opt.uri_path
+        self.stats.request(request.remote.hostinfo)
+
+        if request.code == aiocoap.POST and len(path) >= 2 and path[0] == ".s":
+            self.stats.add("/".join(path[1:]), request.payload, request.opt.content_format)
+            return aiocoap.Message(code=aiocoap.CHANGED)
+
+        return aiocoap.Message(code=aiocoap.NOT_FOUND)
+
+
+def count_duplicates(context, stats):
+    """Count retransmitted messages which reach the server twice.
+
+    aiocoap answers them from its message layer without calling a resource,
+    so wrap its deduplication (an aiocoap 0.4 internal) to see them.
+    """
+    for interface in context.request_interfaces:
+        manager = getattr(interface, "token_interface", None)
+        deduplicate = getattr(manager, "_deduplicate_message", None)
+        if deduplicate is None:
+            continue
+
+        def counting(message, deduplicate=deduplicate):
+            duplicate = deduplicate(message)
+            if duplicate:
+                stats.duplicate_messages += 1
+            return duplicate
+
+        stats.duplicate_messages = stats.duplicate_messages or 0
+        manager._deduplicate_message = counting
+
+
+async def start_server(host, port, psk_id, psk, stats):
+    """Start serving on host:port; returns the aiocoap context.
+
+    psk_id may be a list, to accept several devices sharing one PSK.
+    """
+    psk_ids = [psk_id] if isinstance(psk_id, str) else psk_id
+    credentials = aiocoap.credentials.CredentialsMap()
+    credentials.load_from_dict({
+        f":device{i}": {"dtls": {"psk": {"ascii": psk}, "client-identity": {"ascii": psk_id}}}
+        for i, psk_id in enumerate(psk_ids)
+    })
+
+    context = await aiocoap.Context.create_server_context(
+        GoliothStandIn(stats), bind=(host, port), transports=["tinydtls_server"],
+        server_credentials=credentials)
+    count_duplicates(context, stats)
+
+    return context
+
+
+async def serve_forever(args):
+    stats = StreamStats()
+    context = await start_server(args.host, args.port, args.psk_id, args.psk, stats)
+
+    try:
+        await asyncio.get_running_loop().create_future()
+    finally:
+        await context.shutdown()
+        print(json.dumps(stats.as_dict()))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=5684)
+    parser.add_argument("--psk-id", default=DEFAULT_PSK_ID)
+    parser.add_argument("--psk", default=DEFAULT_PSK)
+    args = parser.parse_args()
+
+    try:
+        asyncio.run(serve_forever(args))
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
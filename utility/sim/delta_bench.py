@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Measure delta firmware update patch size and apply time.
+
+Generates a patch from OLD to NEW with utility/ota_delta.py, then boots the
+native_sim build, which writes OLD to the primary slot of the flash simulator
+and applies the patch to the secondary slot in 1 KiB blocks, the way it
+arrives over CoAP (`bench delta`). The applier checks the rebuilt image
+against the CRC of NEW. Build the app with CONFIG_APP_BENCH=y (see README,
+"Running on native_sim"); the images must fit the native_sim image slots.
+
+The download time estimates only count the payload at the given link rates.
+
+Example:
+
+    ./delta_bench.py --exe ../../../build/zephyr/zephyr.exe \\
+        --old v1.4.0/zephyr.signed.bin --new v1.4.1/zephyr.signed.bin
+"""
+
+import argparse
+import asyncio
+import json
+import os
+import re
+import sys
+import tempfile
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+import ota_delta  # noqa: E402
+from upload_bench import Device  # noqa: E402
+
+RE_DELTA = re.compile(r'\{"delta":.*\}')
+
+# Effective application throughput of cellular links, kbit/s
+LINKS = {"nb-iot": 20, "lte-m": 300}
+
+
+async def apply_on_device(args, patch_path):
+    result = {}
+    done = asyncio.Event()
+
+    def on_line(text):
+        if match := RE_DELTA.search(text):
+            result.update(json.loads(match[0])["delta"])
+            done.set()
+        elif args.verbose:
+            print(text, end="")
+
+    device = Device(args.exe, args.flash, on_line=on_line)
+
+    try:
+        await device.start()
+        await asyncio.wait_for(device.booted.wait(), args.boot_timeout)
+        await device.shell(f"bench delta {os.path.abspath(args.old)} {patch_path}")
+        await asyncio.wait_for(done.wait(), args.timeout)
+    finally:
+        await device.stop()
+
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--exe", required=True, help="native_sim zephyr.exe")
+    parser.add_argument("--old", required=True, help="running image (zephyr.signed.bin)")
+    parser.add_argument("--new", required=True, help="new image (zephyr.signed.bin)")
+    parser.add_argument("--old-start", type=lambda x: int(x, 0), default=0,
+                        help="offset from which the running image can be read")
+    parser.add_argument("--flash", default="delta_bench_flash.bin")
+    parser.add_argument("--boot-timeout", type=float, default=30)
+    parser.add_argument("--timeout", type=float, default=120)
+    parser.add_argument("--json", action="store_true", help="print the report as JSON")
+    parser.add_argument("--verbose", action="store_true", help="print the device log")
+    args = parser.parse_args()
+
+    with open(args.old, "rb") as f:
+        old = f.read()
+    with open(args.new, "rb") as f:
+        new = f.read()
+
+    start = time.monotonic()
+    patch = ota_delta.diff(old, new, args.old_start)
+    generate_s = time.monotonic() - start
+
+    with tempfile.NamedTemporaryFile(suffix=".delta", delete=False) as f:
+        f.write(patch)
+        patch_path = f.name
+
+    try:
+        device = asyncio.run(apply_on_device(args, patch_path))
+    finally:
+        os.unlink(patch_path)
+
+    report = {
+        "image_bytes": len(new),
+        "patch_bytes": len(patch),
+        "patch_ratio": round(len(patch) / len(new), 4),
+        "generate_s": round(generate_s, 2),
+        "apply_result": device.get("result"),
+        "apply_ms": round(device.get("apply_ns", 0) / 1e6, 1),
+        "download_s": {
+            name: {"full": round(len(new) * 8 / kbps / 1000, 1),
+                   "patch": round(len(patch) * 8 / kbps / 1000, 1)}
+            for name, kbps in LINKS.items()
+        },
+    }
+
+    if args.json:
+        print(json.dumps(report))
+        return
+
+    print(f"image {report['image_bytes']} bytes, patch {report['patch_bytes']} bytes "
+          f"({100 * report['patch_ratio']:.1f}%), generated in {report['generate_s']} s")
+    print(f"applied on native_sim: result {report['apply_result']}, "
+          f"{report['apply_ms']} ms host time")
+    for name, times in report["download_s"].items():
+        print(f"{name:>8}: full image {times['full']} s, patch {times['patch']} s")
+
+    if report["apply_result"] != 0:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
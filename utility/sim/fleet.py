@@ -0,0 +1,302 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Run a fleet of simulated trackers against the CoAP stand-in.
+
+Every virtual device is an instance of the native_sim build, so readings are
+sampled, queued, batched and uploaded by the real firmware. Devices get their
+own credentials and flash file, start at a different point of the GNSS log
+(--nmea_skip), run with a drifting clock (native_sim --rt-drift) and lose the
+network on a schedule (--outage, see src/app_sim_outage.c). Outages given with
+--outage are fleet-wide, as when a cell goes down, optionally spread with
+--outage-jitter and limited to a fraction of the fleet. Outages which jitter
+makes overlap on one device are merged into one.
+
+The report covers the aggregate request and stream post rate, stream payload
+sizes, and for each outage the reconnect storm that follows it: new DTLS
+sessions per second, time until the devices are back, and the upload burst.
+
+Example, 50 devices for 15 minutes with a 5 minute outage after 5 minutes:
+
+    ./fleet.py --exe ../../../build/zephyr/zephyr.exe --devices 50 \\
+        --duration 900 --outage 300:300 --timeline fleet.csv
+"""
+
+import argparse
+import asyncio
+import csv
+import json
+import os
+import random
+import re
+import statistics
+import sys
+import time
+
+import coap_standin
+from upload_bench import Device, provision
+
+RE_CONNECTED = re.compile(r"Golioth client connected")
+RE_RESTORED = re.compile(r"Link restored")
+
+# Seconds after an outage ends that are counted in its storm
+STORM_WINDOW_S = 120
+
+# Devices provisioned at the same time
+PROVISION_CONCURRENCY = 8
+
+
+def merge_outages(outages):
+    """Sort one device's outages and merge those which overlap or touch.
+
+    Jitter can move an outage into the one before it, and the device only
+    accepts a schedule in order without overlaps. Returns the merged
+    (start, duration) windows and, for each outage, the index of the window
+    holding it (None where the device is not affected).
+    """
+    order = sorted((o[0], o[0] + o[1], i) for i, o in enumerate(outages) if o)
+    windows = []
+    window_of = [None] * len(outages)
+
+    for start, end, i in order:
+        if windows and start <= windows[-1][1]:
+            windows[-1][1] = max(windows[-1][1], end)
+        else:
+            windows.append([start, end])
+        window_of[i] = len(windows) - 1
+
+    return [(start, end - start) for start, end in windows], window_of
+
+
+class VirtualDevice:
+    """One simulated tracker and what it logged."""
+
+    def __init__(self, index, args, rng):
+        self.index = index
+        self.psk_id = f"fleet-{index:04d}@cold-chain"
+        self.flash = os.path.join(args.workdir, f"fleet-{index:04d}.bin")
+        self.launch_s = index * args.stagger
+        self.drift_ppm = rng.uniform(-args.skew_ppm, args.skew_ppm)
+        self.skip = rng.randrange(args.track_epochs) if args.track_epochs else 0
+        self.outages = []
+        self.connects = []
+        self.restores = []
+        self.device = None
+
+        for start_s, duration_s in args.outage:
+            if rng.random() >= args.outage_fraction:
+                self.outages.append(None)
+                continue
+
+            # Outage times are given in fleet time; the device counts from its launch
+            start = start_s - self.launch_s + rng.uniform(0, args.outage_jitter)
+            self.outages.append((max(int(start), 0), duration_s))
+
+        self.windows, self.window_of = merge_outages(self.outages)
+
+    def options(self):
+        options = [f"--rt-drift={self.drift_ppm * 1e-6:.9f}", f"--nmea_skip={self.skip}"]
+        outages = [f"{start}:{duration}" for start, duration in self.windows]
+
+        if outages:
+            options.append("--outage=" + ",".join(outages))
+
+        return options
+
+    def on_line(self, text, origin):
+        if RE_CONNECTED.search(text):
+            self.connects.append(time.monotonic() - origin)
+        elif RE_RESTORED.search(text):
+            self.restores.append(time.monotonic() - origin)
+
+    async def start(self, exe, origin):
+        self.device = Device(exe, self.flash, self.options(),
+                             lambda text: self.on_line(text, origin))
+        await self.device.start()
+
+    async def stop(self):
+        if self.device:
+            await self.device.stop()
+
+
+def percentile(values, pct):
+    if not values:
+        return None
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * pct / 100))]
+
+
+def storm_report(index, fleet, stats):
+    """Reconnect storm after outage number index."""
+    reconnect_s = []
+    restored_at = []
+
+    for vd in fleet:
+        if vd.outages[index] is None:
+            continue
+
+        # Restores are logged in order, one per merged window; only devices
+        # which got this far count
+        nth = vd.window_of[index]
+        if nth >= len(vd.restores):
+            continue
+
+        restore = vd.restores[nth]
+        restored_at.append(restore)
+
+        connect = next((t for t in vd.connects if t >= restore), None)
+        if connect is not None:
+            reconnect_s.append(connect - restore)
+
+    if not restored_at:
+        return {"outage": index, "affected": 0}
+
+    first = int(min(restored_at))
+    window = [stats.timeline.get(s, {}) for s in range(first, first + STORM_WINDOW_S)]
+    sessions = [slot.get("sessions", 0) for slot in window]
+
+    return {
+        "outage": index,
+        "affected": len(restored_at),
+        "reconnected": len(reconnect_s),
+        "restore_spread_s": round(max(restored_at) - min(restored_at), 2),
+        "reconnect_s_p50": round(percentile(reconnect_s, 50) or 0, 2),
+        "reconnect_s_p95": round(percentile(reconnect_s, 95) or 0, 2),
+        "reconnect_s_max": round(max(reconnect_s, default=0), 2),
+        "peak_sessions_per_s": max(sessions),
+        "peak_posts_per_s": max(slot.get("posts", 0) for slot in window),
+        "peak_bytes_per_s": max(slot.get("bytes", 0) for slot in window),
+        "burst_posts": sum(slot.get("posts", 0) for slot in window),
+        "burst_bytes": sum(slot.get("bytes", 0) for slot in window),
+        # Trailing quiet seconds are dropped to keep the profile short
+        "sessions_per_s": sessions[:max((i + 1 for i, n in enumerate(sessions) if n),
+                                        default=0)],
+    }
+
+
+def report(args, fleet, stats, elapsed_s):
+    seconds = max(int(elapsed_s), 1)
+    slots = [stats.timeline.get(s, {}) for s in range(seconds)]
+    posts = sum(slot.get("posts", 0) for slot in slots)
+    sizes = stats.payload_sizes
+    gps = stats.paths.get("gps", {})
+
+    return {
+        "devices": len(fleet),
+        "duration_s": round(elapsed_s, 1),
+        "requests": sum(slot.get("requests", 0) for slot in slots),
+        "stream_posts": posts,
+        "posts_per_s_mean": round(posts / seconds, 2),
+        "posts_per_s_peak": max(slot.get("posts", 0) for slot in slots),
+        "bytes_per_s_peak": max(slot.get("bytes", 0) for slot in slots),
+        "payload_bytes": {
+            "total": sum(sizes),
+            "mean": round(statistics.mean(sizes), 1) if sizes else None,
+            "p50": percentile(sizes, 50),
+            "p95": percentile(sizes, 95),
+            "max": max(sizes, default=None),
+        },
+        "readings": len(stats.seen_times),
+        "duplicate_readings": gps.get("duplicates", 0),
+        "sessions": len(stats.sessions),
+        "devices_connected": sum(1 for vd in fleet if vd.connects),
+        "storms": [storm_report(i, fleet, stats) for i in range(len(args.outage))],
+    }
+
+
+def write_timeline(path, stats, elapsed_s):
+    with open(path, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["second", "requests", "posts", "bytes", "sessions"])
+        for second in range(int(elapsed_s) + 1):
+            slot = stats.timeline.get(second, {})
+            writer.writerow([second, slot.get("requests", 0), slot.get("posts", 0),
+                             slot.get("bytes", 0), slot.get("sessions", 0)])
+
+
+async def provision_fleet(args, fleet):
+    limit = asyncio.Semaphore(PROVISION_CONCURRENCY)
+
+    async def one(vd):
+        async with limit:
+            await provision(args.exe, vd.flash, vd.psk_id, args.psk, args.boot_timeout)
+
+    await asyncio.gather(*(one(vd) for vd in fleet))
+
+
+async def run(args):
+    rng = random.Random(args.seed)
+    fleet = [VirtualDevice(i, args, rng) for i in range(args.devices)]
+
+    os.makedirs(args.workdir, exist_ok=True)
+    if not args.no_provision:
+        await provision_fleet(args, fleet)
+
+    stats = coap_standin.StreamStats()
+    server = await coap_standin.start_server(args.host, args.port,
+                                             [vd.psk_id for vd in fleet], args.psk, stats)
+
+    try:
+        for vd in fleet:
+            delay = stats.start + vd.launch_s - time.monotonic()
+            if delay > 0:
+                await asyncio.sleep(delay)
+            await vd.start(args.exe, stats.start)
+
+        await asyncio.sleep(stats.start + args.duration - time.monotonic())
+    finally:
+        elapsed_s = time.monotonic() - stats.start
+        await asyncio.gather(*(vd.stop() for vd in fleet))
+        await server.shutdown()
+
+    if args.timeline:
+        write_timeline(args.timeline, stats, elapsed_s)
+
+    result = report(args, fleet, stats, elapsed_s)
+    print(json.dumps(result, indent=None if args.json else 2))
+
+    return 0
+
+
+def outage(text):
+    start, _, duration = text.partition(":")
+    return int(start), int(duration)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--exe", required=True, help="native_sim zephyr.exe")
+    parser.add_argument("--devices", type=int, default=20)
+    parser.add_argument("--duration", type=float, default=600, help="run time (s)")
+    parser.add_argument("--stagger", type=float, default=0.5,
+                        help="seconds between device launches")
+    parser.add_argument("--skew-ppm", type=float, default=100,
+                        help="each device clock drifts by up to this much")
+    parser.add_argument("--track-epochs", type=int, default=300,
+                        help="epochs in the GNSS log; devices start at a random one")
+    parser.add_argument("--outage", type=outage, action="append", default=[],
+                        metavar="START_S:DURATION_S", help="fleet-wide outage, repeatable")
+    parser.add_argument("--outage-jitter", type=float, default=0,
+                        help="spread outage starts over this many seconds")
+    parser.add_argument("--outage-fraction", type=float, default=1.0,
+                        help="fraction of the fleet affected by each outage")
+    parser.add_argument("--workdir", default="fleet", help="directory for flash files")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=5684,
+                        help="port of CONFIG_GOLIOTH_COAP_HOST_URI")
+    parser.add_argument("--psk", default=coap_standin.DEFAULT_PSK)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--boot-timeout", type=float, default=30)
+    parser.add_argument("--no-provision", action="store_true",
+                        help="flash files already hold the fleet credentials")
+    parser.add_argument("--timeline", help="write per-second counts to this CSV file")
+    parser.add_argument("--json", action="store_true", help="print the report on one line")
+    args = parser.parse_args()
+
+    sys.exit(asyncio.run(run(args)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""UDP proxy which impairs the link like netem, without root or tc.
+
+Each direction has its own latency, jitter, random loss and bandwidth cap
+(datagrams are serialized at the link rate behind a bounded queue, and dropped
+when the queue is full). The proxy forwards between one client (the native_sim
+device) and the CoAP server, and counts datagrams and bytes on the wire.
+
+Example, in front of coap_standin.py listening on port 5685:
+
+    ./impair.py --listen 5684 --server 5685 --profile lte-m-edge
+"""
+
+import argparse
+import asyncio
+import json
+import random
+
+# One-way figures for each direction
+PROFILES = {
+    "ideal": {"latency_ms": 0, "jitter_ms": 0, "loss": 0.0, "rate_kbps": 0},
+    "lte-m": {"latency_ms": 60, "jitter_ms": 20, "loss": 0.005, "rate_kbps": 375},
+    "lte-m-edge": {"latency_ms": 200, "jitter_ms": 80, "loss": 0.03, "rate_kbps": 100},
+    "nb-iot": {"latency_ms": 800, "jitter_ms": 300, "loss": 0.01, "rate_kbps": 25},
+    "lossy": {"latency_ms": 100, "jitter_ms": 40, "loss": 0.10, "rate_kbps": 200},
+}
+
+# Longest a datagram may wait for the link before it is tail-dropped
+QUEUE_MS = 2000
+
+
+class Link:
+    """One direction of the impaired link."""
+
+    def __init__(self, profile, deliver, rng):
+        self.profile = profile
+        self.deliver = deliver
+        self.rng = rng
+        self.next_free = 0.0
+        self.up = True
+        self.stats = {"datagrams": 0, "bytes": 0, "lost": 0, "queue_drops": 0, "down_drops": 0}
+
+    def send(self, data):
+        loop = asyncio.get_running_loop()
+        now = loop.time()
+
+        if not self.up:
+            self.stats["down_drops"] += 1
+            return
+
+        if self.rng.random() < self.profile["loss"]:
+            self.stats["lost"] += 1
+            return
+
+        start = max(now, self.next_free)
+        if start - now > QUEUE_MS / 1000:
+            self.stats["queue_drops"] += 1
+            return
+
+        rate_bps = self.profile["rate_kbps"] * 1000
+        self.next_free = start + (len(data) * 8 / rate_bps if rate_bps else 0)
+
+        delay = self.profile["latency_ms"] + self.rng.uniform(-1, 1) * self.profile["jitter_ms"]
+        arrival = self.next_free + max(delay, 0) / 1000
+
+        self.stats["datagrams"] += 1
+        self.stats["bytes"] += len(data)
+        loop.call_at(arrival, self.deliver, data)
+
+
+class ImpairedProxy:
+    """Forward datagrams between the first client seen and the server."""
+
+    def __init__(self, profile, server_addr, seed=None):
+        rng = random.Random(seed)
+        self.server_addr = server_addr
+        self.client_addr = None
+        self.listen_transport = None
+        self.server_transport = None
+        self.up_link = Link(profile, self._to_server, rng)
+        self.down_link = Link(profile, self._to_client, rng)
+
+    def set_up(self, up):
+        """Bring the link up or down (all datagrams dropped)."""
+        self.up_link.up = up
+        self.down_link.up = up
+
+    def _to_server(self, data):
+        self.server_transport.sendto(data)
+
+    def _to_client(self, data):
+        if self.client_addr:
+            self.listen_transport.sendto(data, self.client_addr)
+
+    async def start(self, listen_addr):
+        loop = asyncio.get_running_loop()
+        proxy = self
+
+        class FromClient(asyncio.DatagramProtocol):
+            def datagram_received(self, data, addr):
+                proxy.client_addr = addr
+                proxy.up_link.send(data)
+
+        class FromServer(asyncio.DatagramProtocol):
+            def datagram_received(self, data, addr):
+                proxy.down_link.send(data)
+
+        self.listen_transport, _ = await loop.create_datagram_endpoint(
+            FromClient, local_addr=listen_addr)
+        self.server_transport, _ = await loop.create_datagram_endpoint(
+            FromServer, remote_addr=self.server_addr)
+
+    def close(self):
+        for transport in (self.listen_transport, self.server_transport):
+            if transport:
+                transport.close()
+
+    def as_dict(self):
+        return {"up": self.up_link.stats, "down": self.down_link.stats}
+
+
+async def run(args):
+    profile = dict(PROFILES[args.profile])
+    for key in ("latency_ms", "jitter_ms", "loss", "rate_kbps"):
+        if getattr(args, key) is not None:
+            profile[key] = getattr(args, key)
+
+    proxy = ImpairedProxy(profile, (args.host, args.server), args.seed)
+    await proxy.start((args.host, args.listen))
+
+    try:
+        await asyncio.get_running_loop().create_future()
+    finally:
+        proxy.close()
+        print(json.dumps(proxy.as_dict()))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--listen", type=int, default=5684, help="port the device connects to")
+    parser.add_argument("--server", type=int, default=5685, help="port of the CoAP server")
+    parser.add_argument("--profile", choices=sorted(PROFILES), default="lte-m")
+    parser.add_argument("--latency-ms", type=float, help="override the profile latency")
+    parser.add_argument("--jitter-ms", type=float, help="override the profile jitter")
+    parser.add_argument("--loss", type=float, help="override the profile loss (0..1)")
+    parser.add_argument("--rate-kbps", type=float, help="override the profile rate (0: no cap)")
+    parser.add_argument("--seed", type=int, help="random seed, for repeatable runs")
+    args = parser.parse_args()
+
+    try:
+        asyncio.run(run(args))
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Measure how fast a backlog of readings drains over impaired links.
+
+For each link profile the harness starts the CoAP stand-in (coap_standin.py)
+behind the impairment proxy (impair.py), boots the native_sim build with the
+link down, queues a synthetic backlog with the `bench backlog` shell command,
+then brings the link up and waits until every queued reading has reached the
+stand-in.
+
+CoAP retransmissions are counted from both ends of the link, since DTLS hides
+the CoAP message IDs from the proxy: a request whose ACK was lost reaches the
+stand-in twice, and a datagram the proxy drops on the way up is sent again.
+The second part also counts DTLS handshake retries. Build the app with CONFIG_APP_BENCH=y (see README, "Running on
+native_sim"). The stand-in credentials are written to the flash file first.
+
+Example:
+
+    ./upload_bench.py --exe ../../../build/zephyr/zephyr.exe --backlog 500 \\
+        --profiles ideal lte-m nb-iot --json
+"""
+
+import argparse
+import asyncio
+import json
+import re
+import sys
+import time
+
+import coap_standin
+import impair
+
+RE_BACKLOG = re.compile(r'\{"backlog_queued":(\d+)\}')
+RE_CONNECTED = re.compile(r"Golioth client connected")
+RE_PUSHED = re.compile(r"Pushed (\d+) cached readings \((\d+) bytes\) up to Golioth in (\d+) ms")
+RE_FAILED = re.compile(r"Failed to send sensor data to Golioth")
+RE_BOOTED = re.compile(r"Start Golioth Cold Chain")
+
+SERVER_PORT_OFFSET = 1
+
+
+class Device:
+    """The native_sim executable, with its log parsed as it runs."""
+
+    def __init__(self, exe, flash, options=(), on_line=None):
+        self.cmd = [exe, f"--flash={flash}", "--uart_stdinout", *options]
+        self.on_line = on_line
+        self.proc = None
+        self.events = {"connected": None, "failed_batches": 0, "pushed": 0,
+                       "pushed_bytes": 0, "upload_ms": 0, "backlog": None}
+        self.booted = asyncio.Event()
+        self.backlog_reply = asyncio.Event()
+
+    async def start(self):
+        self.proc = await asyncio.create_subprocess_exec(
+            *self.cmd, stdin=asyncio.subprocess.PIPE, stdout=asyncio.subprocess.PIPE,
+            stderr=asyncio.subprocess.STDOUT)
+        asyncio.create_task(self._read())
+
+    async def _read(self):
+        while line := await self.proc.stdout.readline():
+            text = line.decode(errors="replace")
+
+            if self.on_line:
+                self.on_line(text)
+
+            if RE_BOOTED.search(text):
+                self.booted.set()
+            elif RE_CONNECTED.search(text):
+                self.events["connected"] = self.events["connected"] or time.monotonic()
+            elif RE_FAILED.search(text):
+                self.events["failed_batches"] += 1
+            elif match := RE_PUSHED.search(text):
+                self.events["pushed"] += int(match[1])
+                self.events["pushed_bytes"] += int(match[2])
+                self.events["upload_ms"] += int(match[3])
+            elif match := RE_BACKLOG.search(text):
+                self.events["backlog"] = int(match[1])
+                self.backlog_reply.set()
+
+    async def shell(self, command):
+        self.proc.stdin.write(command.encode() + b"\n")
+        await self.proc.stdin.drain()
+
+    async def stop(self):
+        if self.proc and self.proc.returncode is None:
+            self.proc.terminate()
+            await self.proc.wait()
+
+
+async def provision(exe, flash, psk_id, psk, boot_timeout):
+    """Store the stand-in credentials in the flash file."""
+    device = Device(exe, flash)
+    await device.start()
+    await asyncio.wait_for(device.booted.wait(), boot_timeout)
+    await device.shell(f"settings set golioth/psk-id {psk_id}")
+    await device.shell(f"settings set golioth/psk {psk}")
+    await asyncio.sleep(1)
+    await device.stop()
+
+
+async def run_profile(args, name):
+    stats = coap_standin.StreamStats()
+    server_port = args.port + SERVER_PORT_OFFSET
+    server = await coap_standin.start_server(args.host, server_port, args.psk_id, args.psk,
+                                             stats)
+    proxy = impair.ImpairedProxy(impair.PROFILES[name], (args.host, server_port), args.seed)
+    await proxy.start((args.host, args.port))
+    proxy.set_up(False)
+
+    device = Device(args.exe, args.flash)
+    result = {"profile": name}
+
+    try:
+        await device.start()
+        await asyncio.wait_for(device.booted.wait(), args.boot_timeout)
+
+        await device.shell(f"bench backlog {args.backlog}")
+        await asyncio.wait_for(device.backlog_reply.wait(), args.boot_timeout)
+        queued = device.events["backlog"]
+
+        link_up = time.monotonic()
+        proxy.set_up(True)
+
+        deadline = link_up + args.timeout
+        while len(stats.backlog_times) < queued and time.monotonic() < deadline:
+            await asyncio.sleep(0.1)
+
+        done = time.monotonic()
+        received = len(stats.backlog_times)
+        gps = stats.paths.get("gps", {})
+        connected = device.events["connected"]
+        wire = proxy.as_dict()
+        duplicates = stats.duplicate_messages
+        up_drops = wire["up"]["lost"] + wire["up"]["queue_drops"]
+
+        result.update({
+            "backlog": queued,
+            "received": received,
+            "lost_readings": queued - received,
+            "drain_s": round((stats.last_reading or done) - link_up, 2),
+            "connect_s": round(connected - link_up, 2) if connected else None,
+            "upload_s": round(device.events["upload_ms"] / 1000, 2),
+            "timed_out": received < queued,
+            "failed_batches": device.events["failed_batches"],
+            "duplicate_readings": gps.get("duplicates", 0),
+            "stream_posts": gps.get("posts", 0),
+            "payload_bytes": gps.get("bytes", 0),
+            "duplicate_messages": duplicates,
+            "retransmissions": None if duplicates is None else duplicates + up_drops,
+            "wire": wire,
+        })
+    finally:
+        await device.stop()
+        proxy.close()
+        await server.shutdown()
+
+    return result
+
+
+def print_table(results):
+    print(f"{'profile':<12}{'drain s':>9}{'connect s':>11}{'lost':>6}{'failed':>8}"
+          f"{'dups':>6}{'retx':>6}{'wire up B':>11}{'wire down B':>13}")
+    for r in results:
+        print(f"{r['profile']:<12}{r['drain_s']:>9}{str(r['connect_s']):>11}"
+              f"{r['lost_readings']:>6}{r['failed_batches']:>8}{r['duplicate_readings']:>6}"
+              f"{str(r['retransmissions']):>6}"
+              f"{r['wire']['up']['bytes']:>11}{r['wire']['down']['bytes']:>13}")
+
+
+async def run(args):
+    if not args.no_provision:
+        await provision(args.exe, args.flash, args.psk_id, args.psk, args.boot_timeout)
+
+    results = []
+    for name in args.profiles:
+        result = await run_profile(args, name)
+        results.append(result)
+        if args.json:
+            print(json.dumps(result), flush=True)
+
+    if not args.json:
+        print_table(results)
+
+    return 0 if not any(r["timed_out"] for r in results) else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--exe", required=True, help="native_sim zephyr.exe built with the bench")
+    parser.add_argument("--flash", default="upload_bench_flash.bin", help="flash file to use")
+    parser.add_argument("--profiles", nargs="+", choices=sorted(impair.PROFILES),
+                        default=["ideal", "lte-m", "lte-m-edge", "nb-iot"])
+    parser.add_argument("--backlog", type=int, default=500, help="readings to queue")
+    parser.add_argument("--timeout", type=float, default=600, help="drain timeout (s)")
+    parser.add_argument("--boot-timeout", type=float, default=30)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=5684,
+                        help="port the device connects to (CONFIG_GOLIOTH_COAP_HOST_URI)")
+    parser.add_argument("--psk-id", default=coap_standin.DEFAULT_PSK_ID)
+    parser.add_argument("--psk", default=coap_standin.DEFAULT_PSK)
+    parser.add_argument("--seed", type=int, default=1, help="impairment random seed")
+    parser.add_argument("--no-provision", action="store_true",
+                        help="the flash file already holds the stand-in credentials")
+    parser.add_argument("--json", action="store_true", help="print one JSON line per profile")
+    args = parser.parse_args()
+
+    sys.exit(asyncio.run(run(args)))
+
+
+if __name__ == "__main__":
+    main()
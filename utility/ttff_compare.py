@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 Golioth, Inc.
+# SPDX-License-Identifier: Apache-2.0
+
+"""Compare the time to first fix of two firmware builds from their boot logs.
+
+Every boot logs "Boot phase <name> reached at <ms> ms" (src/app_boot.c). Capture
+the console of the tracker over a number of reboots for each build, e.g. with
+and without CONFIG_APP_GNSS_AIDING, and pass the logs of each build to one of
+--before and --after. A log may hold any number of boots; each "main" phase
+starts a new one. Prints the count, median, mean, min and max of the uptime at
+first_fix and first_record for each build, and the change of the median.
+
+Run this on hardware: on native_sim the GNSS log replay discards what the
+app writes to the receiver, aiding included, so the time to first fix only
+depends on the recorded log.
+
+Example:
+
+    ./ttff_compare.py --before cold/*.log --after aided/*.log
+"""
+
+import argparse
+import json
+import re
+import statistics
+import sys
+
+PHASE = re.compile(r"Boot phase (\w+) reached at (\d+) ms")
+PHASES = ("first_fix", "first_record")
+
+
+def boots(paths):
+    """Phase uptimes (ms) of every boot found in the logs."""
+    found = []
+    for path in paths:
+        with open(path, errors="replace") as f:
+            for line in f:
+                m = PHASE.search(line)
+                if not m:
+                    continue
+                name, ms = m.group(1), int(m.group(2))
+                if name == "main" or not found:
+                    found.append({})
+                found[-1].setdefault(name, ms)
+    return found
+
+
+def summary(found):
+    result = {}
+    for phase in PHASES:
+        values = [b[phase] for b in found if phase in b]
+        result[phase] = {
+            "boots": len(found),
+            "count": len(values),
+            "median_ms": round(statistics.median(values)) if values else None,
+            "mean_ms": round(statistics.mean(values)) if values else None,
+            "min_ms": min(values, default=None),
+            "max_ms": max(values, default=None),
+        }
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--before", nargs="+", required=True, help="logs of the first build")
+    parser.add_argument("--after", nargs="+", required=True, help="logs of the second build")
+    parser.add_argument("--json", action="store_true", help="machine-readable output")
+    args = parser.parse_args()
+
+    results = {"before": summary(boots(args.before)), "after": summary(boots(args.after))}
+
+    for phase in PHASES:
+        before = results["before"][phase]["median_ms"]
+        after = results["after"][phase]["median_ms"]
+        if before is not None and after is not None:
+            results[f"{phase}_median_change_ms"] = after - before
+
+    if args.json:
+        json.dump(results, sys.stdout, indent=2)
+        print()
+        return
+
+    print(f"{'build':<8} {'phase':<14} {'boots':>6} {'count':>6} {'median':>9} {'mean':>9} "
+          f"{'min':>9} {'max':>9}")
+    for build in ("before", "after"):
+        for phase in PHASES:
+            r = results[build][phase]
+            cells = [r[k] if r[k] is not None else "-"
+                     for k in ("median_ms", "mean_ms", "min_ms", "max_ms")]
+            print(f"{build:<8} {phase:<14} {r['boots']:>6} {r['count']:>6} "
+                  + " ".join(f"{c:>9}" for c in cells))
+    for phase in PHASES:
+        change = results.get(f"{phase}_median_change_ms")
+        if change is not None:
+            print(f"{phase} median change: {change:+} ms")
+
+
+if __name__ == "__main__":
+    main()